@@ -40,6 +40,8 @@ AccessControlList::~AccessControlList() { }
  * Method for adding new rule on the end of the ACL.
  *
  * Method adds new rule on the end of the ACL if passed pointer is not NULL.
+ * Fields of the rule are copied to the packed store, so the rule should not be
+ * modified after it is added.
  *
  * @param newRule pointer to the new rule we want to add to the ACL.
  */
@@ -48,6 +50,7 @@ void AccessControlList::pushBack(AclRule* newRule)
     if ( newRule != NULL )
     {
         m_rulesVector.push_back(newRule);
+        m_ruleStore.pushBack(*newRule);
     }
 }
 
@@ -81,6 +84,20 @@ size_t AccessControlList::size() const
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Method returns the packed store with fields of rules of the ACL.
+ *
+ * Rules in the store have the same indexes as rules in the ACL.
+ *
+ * @return reference to the store of rules.
+ */
+const AclRuleStore& AccessControlList::ruleStore() const
+{
+    return m_ruleStore;
+}
+
+//-----------------------------------------------------------------------------------
+
 /**
  * Operator [] used for accessing rule reference on the given index.
  *
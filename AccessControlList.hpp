@@ -20,6 +20,7 @@
 #include <string>
 
 #include "AclRule.hpp"
+#include "AclRuleStore.hpp"
 #include "Exception.hpp"
 
 #ifndef ACCESSCONTROLLIST_H__7382638678465165168144735416181313461
@@ -31,12 +32,17 @@
  * Class represents particular Access Control List with a name and
  * a specific set of rules. It provides interface for accessing rules,
  * adding new rules and for getting specific parameters of the ACL.
+ *
+ * Fields of rules needed by the classification of conflicts are also kept in the packed
+ * store (see AclRuleStore), which is filled when the rule is added to the ACL. Objects AclRule
+ * are used for building prefix trees and for the output.
  */
 class AccessControlList
 {
     private:
         boost::ptr_vector<AclRule> m_rulesVector;       /** Vector of pointers to objects representing ACL rules. */
         std::string m_aclID;                            /** String containing name or ID of the ACL. */
+        AclRuleStore m_ruleStore;                       /** Packed fields of rules used by the classification of conflicts. */
 
     public:
         AccessControlList(const std::string id = "no-ID");
@@ -45,6 +51,7 @@ class AccessControlList
         void pushBack(AclRule* newRule);
         std::string name() const;
         size_t size() const;
+        const AclRuleStore& ruleStore() const;
 
         AclRule& operator[](size_t n) throw(Exception);
         const AclRule& operator[](size_t n) const throw(Exception);
@@ -0,0 +1,382 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <set>
+#include <utility>
+
+#include "AclAnalyzer.hpp"
+#include "PrefixForest.hpp"
+#include "WAHBitVector.hpp"
+#include "PlainBitVector.hpp"
+#include "RoaringBitVector.hpp"
+#include "GlobalDefs.hpp"
+
+using namespace std;
+
+/* with this density about half of 31bit words of WAHBitVector are literals */
+const double AclAnalyzer::PLAIN_DENSITY_THRESHOLD = 0.02;
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class constructor.
+ *
+ * @param acl reference to the ACL which will be analysed.
+ * @param outputWriter pointer to the output writer to which found conflicts are written immediately.
+ *                     If NULL is passed (default), conflicts are stored in the analyzer and can be
+ *                     written later by the method writeConflicts().
+ * @param insertionMode mode of inserting rules into the forest of prefix trees
+ *                      (INSERTION_SEQUENTIAL, INSERTION_PIPELINED or INSERTION_BULK).
+ * @param bitVectorType class of bit vectors used by prefix trees (constant BITVECTOR_XXX).
+ *                      If BITVECTOR_AUTO is passed (default), the class is selected by selectBitVectorType().
+ * @param classifyMode mode of the classification of conflicts (CLASSIFY_SHORT_CIRCUIT (default) or CLASSIFY_FULL).
+ * @param indexType structure used for dimensions of the forest (constant INDEX_XXX, INDEX_BINARY_TRIE by default).
+ */
+AclAnalyzer::AclAnalyzer(const AccessControlList& acl, OutputWriter* outputWriter, int insertionMode, int bitVectorType, int classifyMode,
+                         int indexType) : m_acl(acl),
+                                                                                      m_outputWriter(outputWriter),
+                                                                                      m_insertionMode(insertionMode),
+                                                                                      m_bitVectorType(bitVectorType),
+                                                                                      m_classifyMode(classifyMode),
+                                                                                      m_indexType(indexType),
+                                                                                      m_usedBitVectorType(bitVectorType),
+                                                                                      m_numOfAnalyzations(0),
+                                                                                      m_numOfConflicts(0),
+                                                                                      m_numOfNodes(0)
+{
+    Conflict::initSelectivity(m_selectivity);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+AclAnalyzer::~AclAnalyzer() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method handles newly found conflict.
+ *
+ * Conflict is written to the output writer, if there is any, without allocating the object
+ * of the conflict. Otherwise it is stored.
+ *
+ * @param ruleX reference to rule X of the conflict.
+ * @param ruleY reference to rule Y of the conflict.
+ * @param result reference to the result of the classification of rules.
+ */
+void AclAnalyzer::reportConflict(const AclRule& ruleX, const AclRule& ruleY, const CONFLICT_RESULT& result)
+{
+    ++m_numOfConflicts;
+
+    if ( m_outputWriter != NULL )
+        m_outputWriter->writeNewConflict(Conflict(ruleX, ruleY, result));
+    else
+        m_conflicts.push_back(new Conflict(ruleX, ruleY, result));
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method performs the analysis of the ACL.
+ *
+ * Every rule of the ACL is added to the forest of prefix trees and preceding rules found
+ * in conflict vectors of all dimensions are classified against the added rule. The conflict
+ * bit vector is never built, the forest iterates directly over the AND of dimension vectors
+ * and positions of conflicting rules are taken from the iterator in batches, which are
+ * classified at once by Conflict::classifyBatch(). In the short-circuit mode the order of compared
+ * dimensions is updated by their selectivity every SELECTIVITY_UPDATE_INTERVAL rules.
+ * In the pipelined insertion mode, the prefix trees are updated by their own threads
+ * ahead of the classification of conflicts.
+ *
+ * @throw Exception if an error occurs while building the forest of prefix trees.
+ */
+void AclAnalyzer::analyse() throw(Exception)
+{
+    m_usedBitVectorType = m_bitVectorType;
+
+    if ( m_usedBitVectorType == BITVECTOR_AUTO )
+        m_usedBitVectorType = selectBitVectorType(m_acl);
+
+    if ( m_usedBitVectorType == BITVECTOR_PLAIN )
+        analyseWithBitVector< PlainBitVector >();
+    else if ( m_usedBitVectorType == BITVECTOR_ROARING )
+        analyseWithBitVector< RoaringBitVector >();
+    else
+        analyseWithBitVector< WAHBitVector >();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method performs the analysis of the ACL using prefix trees with passed class of bit vectors.
+ *
+ * @throw Exception if an error occurs while building the forest of prefix trees.
+ */
+template < class BitVector >
+void AclAnalyzer::analyseWithBitVector() throw(Exception)
+{
+    int numOfrules = m_acl.size();
+    auto_ptr< PrefixForest< BitVector > > aclPrefixForest(new PrefixForest< BitVector >(m_acl, m_indexType));
+    int32_t positions[CANDIDATES_BATCH];
+    CONFLICT_RESULT results[CANDIDATES_BATCH];
+
+    if ( m_insertionMode == INSERTION_PIPELINED )
+        aclPrefixForest->startPipelinedInsertion(m_acl);
+    else if ( m_insertionMode == INSERTION_BULK )
+        aclPrefixForest->bulkLoad(m_acl);
+
+    for ( int j = 0; j < numOfrules; ++j )
+    {
+        const AclRule* actualRule = &m_acl[j];
+        aclPrefixForest->insertAclRule(*actualRule);
+
+        typename BitVector::AndIterator it = aclPrefixForest->getConflictsIterator(actualRule->getPosition());
+
+        size_t numOfPositions = 0;
+        while ( (numOfPositions = it.nextBatch(positions, CANDIDATES_BATCH)) > 0 )
+        {
+            m_numOfAnalyzations += numOfPositions;
+
+            if ( m_classifyMode == CLASSIFY_SHORT_CIRCUIT )
+                Conflict::classifyBatch(m_acl.ruleStore(), j, positions, numOfPositions, results, m_selectivity);
+            else
+                Conflict::classifyBatch(m_acl.ruleStore(), j, positions, numOfPositions, results);
+
+            for ( size_t i = 0; i < numOfPositions; ++i )
+            {
+                if ( results[i].conflictType != CONFLICT_NONE )
+                    reportConflict(m_acl[positions[i]], *actualRule, results[i]);
+            }
+        }
+
+        if ( (m_classifyMode == CLASSIFY_SHORT_CIRCUIT) && ((j + 1) % SELECTIVITY_UPDATE_INTERVAL == 0) )
+            Conflict::orderBySelectivity(m_selectivity);
+    }
+
+    m_numOfNodes = aclPrefixForest->numOfNodes();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method writes all stored conflicts to the passed output writer.
+ *
+ * Written conflicts are removed from the analyzer, so the memory is freed.
+ *
+ * @param outputWriter reference to the output writer.
+ */
+void AclAnalyzer::writeConflicts(OutputWriter& outputWriter)
+{
+    size_t size = m_conflicts.size();
+    for ( size_t i = 0; i < size; ++i )
+    {
+        outputWriter.writeNewConflict(m_conflicts[i]);
+    }
+
+    m_conflicts.clear();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns reference to the analysed ACL.
+ *
+ * @return reference to the analysed ACL.
+ */
+const AccessControlList& AclAnalyzer::getAcl() const
+{
+    return m_acl;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of classified pairs of rules.
+ *
+ * @return number of classified pairs of rules.
+ */
+unsigned long AclAnalyzer::getNumOfAnalyzations() const
+{
+    return m_numOfAnalyzations;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of found conflicts.
+ *
+ * @return number of found conflicts.
+ */
+unsigned long AclAnalyzer::getNumOfConflicts() const
+{
+    return m_numOfConflicts;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of nodes of all dimensions of the forest built by the last analysis.
+ *
+ * @return number of nodes, 0 if the analysis was not performed.
+ */
+unsigned long AclAnalyzer::getNumOfNodes() const
+{
+    return m_numOfNodes;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the class of bit vectors used by the analysis.
+ *
+ * @return constant BITVECTOR_WAH, BITVECTOR_PLAIN or BITVECTOR_ROARING, if the analysis was performed,
+ *         requested class of bit vectors otherwise.
+ */
+int AclAnalyzer::getBitVectorType() const
+{
+    return m_usedBitVectorType;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the structure used for dimensions of the forest.
+ *
+ * @return constant INDEX_XXX.
+ */
+int AclAnalyzer::getIndexType() const
+{
+    return m_indexType;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the order and selectivity counters of dimensions used in the short-circuit mode.
+ *
+ * Counters are accumulated by all analyses performed by the analyzer.
+ *
+ * @return reference to the structure with the order and counters of dimensions.
+ */
+const DIMENSION_SELECTIVITY& AclAnalyzer::getSelectivity() const
+{
+    return m_selectivity;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method sets the initial order and selectivity counters of dimensions.
+ *
+ * Structure returned by getSelectivity() of the analysis of a similar ACL can be passed,
+ * so the analysis starts with the order tuned for the input.
+ *
+ * @param selectivity reference to the structure with the order and counters of dimensions.
+ */
+void AclAnalyzer::setSelectivity(const DIMENSION_SELECTIVITY& selectivity)
+{
+    m_selectivity = selectivity;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method measures the density of conflict vectors of single dimensions of the ACL.
+ *
+ * First sampleSize rules of the ACL are inserted into prefix trees and the density is
+ * the ratio of set bits in returned conflict vectors to the number of rules which could
+ * be set in them (all preceding rules and the rule itself).
+ *
+ * @param acl reference to the ACL.
+ * @param sampleSize number of rules from the beginning of the ACL used for the measurement.
+ * @return measured density from interval <0, 1>.
+ */
+double AclAnalyzer::measureDensity(const AccessControlList& acl, u_int32_t sampleSize)
+{
+    u_int32_t numOfRules = (acl.size() < sampleSize) ? acl.size() : sampleSize;
+    double setBits = 0;
+    double allBits = 0;
+
+    for ( int i = DIMENSION_MIN; i <= DIMENSION_MAX; ++i )
+    {
+        PrefixTree< PlainBitVector > tree(numOfRules);
+
+        for ( u_int32_t j = 0; j < numOfRules; ++j )
+        {
+            setBits += tree.addNewRulePrefix(acl[j].getFieldPrefix(i), j)->count();
+            allBits += j + 1;
+        }
+    }
+
+    return (allBits > 0) ? (setBits / allBits) : 0;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method estimates the memory used by non-compressed bit vectors of prefix trees of the ACL.
+ *
+ * Every distinct prefix of every dimension creates one valid node of a prefix tree with two
+ * bit vectors, each of them having one bit per rule.
+ *
+ * @param acl reference to the ACL.
+ * @return estimated memory in bytes.
+ */
+unsigned long AclAnalyzer::estimatePlainMemory(const AccessControlList& acl)
+{
+    unsigned long numOfRules = acl.size();
+    unsigned long numOfNodes = 0;
+
+    for ( int i = DIMENSION_MIN; i <= DIMENSION_MAX; ++i )
+    {
+        set< pair< size_t, unsigned long > > prefixes;
+
+        for ( unsigned long j = 0; j < numOfRules; ++j )
+        {
+            const FIELD_PREFIX& prefix = acl[j].getFieldPrefix(i);
+            prefixes.insert(make_pair((size_t) prefix.length, (unsigned long) prefix.bits));
+        }
+
+        numOfNodes += prefixes.size();
+    }
+
+    return numOfNodes * 2 * (((numOfRules + 63) / 64) * 8);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method selects the class of bit vectors for the analysis of passed ACL.
+ *
+ * Non-compressed bit vectors are selected, if the measured density of conflict vectors
+ * is at least PLAIN_DENSITY_THRESHOLD and the estimated memory of bit vectors does not
+ * exceed PLAIN_MEMORY_LIMIT. Otherwise container bit vectors are selected for ACLs with
+ * at least ROARING_MIN_RULES rules and WAH compressed bit vectors for smaller ACLs.
+ *
+ * @param acl reference to the ACL.
+ * @return constant BITVECTOR_WAH, BITVECTOR_PLAIN or BITVECTOR_ROARING.
+ */
+int AclAnalyzer::selectBitVectorType(const AccessControlList& acl)
+{
+    if ( (measureDensity(acl) >= PLAIN_DENSITY_THRESHOLD) && (estimatePlainMemory(acl) <= PLAIN_MEMORY_LIMIT) )
+        return BITVECTOR_PLAIN;
+
+    return (acl.size() >= ROARING_MIN_RULES) ? BITVECTOR_ROARING : BITVECTOR_WAH;
+}
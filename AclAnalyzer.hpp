@@ -0,0 +1,115 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <memory>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include "AccessControlList.hpp"
+#include "Conflict.hpp"
+#include "OutputWriter.hpp"
+#include "PrefixForest.hpp"
+
+#ifndef ACL_ANALYZER_HPP__4183957264019385720461938475610293847561029384756
+#define ACL_ANALYZER_HPP__4183957264019385720461938475610293847561029384756
+
+/**
+ * Constants representing the class of bit vectors used by prefix trees.
+ */
+const int BITVECTOR_AUTO = 0;       /** Class is selected for every ACL according to the measured density of its bit vectors. */
+const int BITVECTOR_WAH = 1;        /** Compressed bit vectors WAHBitVector. */
+const int BITVECTOR_PLAIN = 2;      /** Non-compressed bit vectors PlainBitVector. */
+const int BITVECTOR_ROARING = 3;    /** Bit vectors compressed by containers RoaringBitVector. */
+
+/**
+ * Constants representing the mode of the classification of conflicts.
+ */
+const int CLASSIFY_FULL = 0;            /** All dimensions of every pair of rules are compared. */
+const int CLASSIFY_SHORT_CIRCUIT = 1;   /** Comparison stops at the first disjoint dimension (see DIMENSION_SELECTIVITY). */
+
+/**
+ * Class AclAnalyzer performs the conflict analysis of one Access Control List.
+ *
+ * Analyzer adds rules of the ACL one by one to the forest of prefix trees and classifies
+ * the conflict between every added rule and all preceding rules found in the forest.
+ * Found conflicts are either written directly to the output writer passed in constructor,
+ * or (if no output writer is passed) they are stored in the analyzer until they are written
+ * by the method writeConflicts(). Stored conflicts allow to analyse more ACLs concurrently
+ * and still write the results in the original order of ACLs.
+ *
+ * Prefix trees use compressed (WAHBitVector), non-compressed (PlainBitVector) or container
+ * (RoaringBitVector) bit vectors. By default the class is selected for every ACL: the density
+ * of conflict vectors is measured on a sample of rules and non-compressed vectors are used for
+ * dense ACLs, if they fit into the memory limit. Otherwise compressed vectors are used.
+ *
+ * In the short-circuit classification mode (default), dimensions of candidate rules are compared
+ * in the order of their selectivity measured during the analysis and the comparison stops at the
+ * first disjoint dimension. Found conflicts are the same in both modes.
+ */
+class AclAnalyzer
+{
+    private:
+        const AccessControlList& m_acl;                 /** Reference to the analysed ACL. */
+        OutputWriter* const m_outputWriter;             /** Pointer to the output writer, NULL if conflicts are stored. */
+        const int m_insertionMode;                      /** Mode of inserting rules into the forest of prefix trees. */
+        const int m_bitVectorType;                      /** Requested class of bit vectors (constant BITVECTOR_XXX). */
+        const int m_classifyMode;                       /** Mode of the classification of conflicts (constant CLASSIFY_XXX). */
+        const int m_indexType;                          /** Structure used for dimensions of the forest (constant INDEX_XXX). */
+        DIMENSION_SELECTIVITY m_selectivity;            /** Order and selectivity counters of dimensions used in the short-circuit mode. */
+        int m_usedBitVectorType;                        /** Class of bit vectors used by the last analysis. */
+        boost::ptr_vector< Conflict > m_conflicts;      /** Vector of stored conflicts (used only without output writer). */
+
+        unsigned long m_numOfAnalyzations;              /** Number of classified pairs of rules. */
+        unsigned long m_numOfConflicts;                 /** Number of found conflicts. */
+        unsigned long m_numOfNodes;                     /** Number of nodes of the forest built by the last analysis. */
+
+        static const u_int32_t DENSITY_SAMPLE_SIZE = 1024;         /** Number of rules used for measuring the density. */
+        static const double PLAIN_DENSITY_THRESHOLD;                /** Minimal density for which PlainBitVector is used. */
+        static const unsigned long PLAIN_MEMORY_LIMIT = 256UL << 20;  /** Maximal estimated memory of PlainBitVector-s in bytes. */
+        static const size_t ROARING_MIN_RULES = 32768;              /** Minimal number of rules for which RoaringBitVector is used instead of WAHBitVector. */
+        static const size_t CANDIDATES_BATCH = 256;                 /** Number of conflicting rules taken from the iterator at once. */
+        static const int SELECTIVITY_UPDATE_INTERVAL = 256;         /** Number of rules after which the order of dimensions is updated. */
+
+    protected:
+        void reportConflict(const AclRule& ruleX, const AclRule& ruleY, const CONFLICT_RESULT& result);
+
+        template < class BitVector >
+        void analyseWithBitVector() throw(Exception);
+
+    public:
+        AclAnalyzer(const AccessControlList& acl, OutputWriter* outputWriter = NULL, int insertionMode = INSERTION_SEQUENTIAL,
+                    int bitVectorType = BITVECTOR_AUTO, int classifyMode = CLASSIFY_SHORT_CIRCUIT, int indexType = INDEX_BINARY_TRIE);
+        virtual ~AclAnalyzer();
+
+        void analyse() throw(Exception);
+        void writeConflicts(OutputWriter& outputWriter);
+
+        const AccessControlList& getAcl() const;
+        unsigned long getNumOfAnalyzations() const;
+        unsigned long getNumOfConflicts() const;
+        unsigned long getNumOfNodes() const;
+        int getBitVectorType() const;
+        int getIndexType() const;
+        const DIMENSION_SELECTIVITY& getSelectivity() const;
+        void setSelectivity(const DIMENSION_SELECTIVITY& selectivity);
+
+        static double measureDensity(const AccessControlList& acl, u_int32_t sampleSize = DENSITY_SAMPLE_SIZE);
+        static unsigned long estimatePlainMemory(const AccessControlList& acl);
+        static int selectBitVectorType(const AccessControlList& acl);
+};
+
+#endif /* ACL_ANALYZER_HPP__4183957264019385720461938475610293847561029384756 */
@@ -31,6 +31,9 @@ using namespace std;
  */
 AclRule::AclRule(unsigned position) : m_protocol(PROTO_ANY), m_srcPort_start(0), m_srcPort_stop(0xFFFF), m_srcPortNeg(false), m_dstPort_start(0), m_dstPort_stop(0xFFFF), m_dstPortNeg(false), m_action(ACTION_DENY), m_rulePositionNumber(position)
 {
+    m_srcIP_prefix.bits = m_dstIP_prefix.bits = m_protocol_prefix.bits = m_srcPort_prefix.bits = m_dstPort_prefix.bits = 0;
+    m_srcIP_prefix.length = m_dstIP_prefix.length = m_protocol_prefix.length = m_srcPort_prefix.length = m_dstPort_prefix.length = 0;
+
     m_srcIP_start.A = m_srcIP_start.B = m_srcIP_start.C = m_srcIP_start.D = 0;
     m_srcIP_stop.A = m_srcIP_stop.B = m_srcIP_stop.C = m_srcIP_stop.D = 255;
     m_dstIP_start.A = m_dstIP_start.B = m_dstIP_start.C = m_dstIP_start.D = 0;
@@ -51,6 +54,9 @@ AclRule::AclRule(unsigned position) : m_protocol(PROTO_ANY), m_srcPort_start(0),
  */
 AclRule::AclRule(unsigned position, std::string name) : m_protocol(PROTO_ANY), m_srcPort_start(0), m_srcPort_stop(0xFFFF), m_srcPortNeg(false), m_dstPort_start(0), m_dstPort_stop(0xFFFF), m_dstPortNeg(false), m_action(ACTION_DENY), m_rulePositionNumber(position), m_name(name)
 {
+    m_srcIP_prefix.bits = m_dstIP_prefix.bits = m_protocol_prefix.bits = m_srcPort_prefix.bits = m_dstPort_prefix.bits = 0;
+    m_srcIP_prefix.length = m_dstIP_prefix.length = m_protocol_prefix.length = m_srcPort_prefix.length = m_dstPort_prefix.length = 0;
+
     m_srcIP_start.A = m_srcIP_start.B = m_srcIP_start.C = m_srcIP_start.D = 0;
     m_srcIP_stop.A = m_srcIP_stop.B = m_srcIP_stop.C = m_srcIP_stop.D = 255;
     m_dstIP_start.A = m_dstIP_start.B = m_dstIP_start.C = m_dstIP_start.D = 0;
@@ -75,24 +81,7 @@ AclRule::~AclRule(){ }
 void AclRule::computeSrcIpPrefix()
 {
     /* using IP_ADDRESS structure as a 32bit unsigned int, for easier logical operations */
-    u_int32_t srcIPxor = *((u_int32_t*)&m_srcIP_start) ^ *((u_int32_t*)&m_srcIP_stop);
-    u_int32_t srcIPtmp = *((u_int32_t*)&m_srcIP_start);
-    
-    m_srcIP_prefix.clear();
-    
-    /* looking for first different bite (its value is "1") */
-    for ( int i = 0; i < 32; ++i )
-    {
-        /* if we found the different bite -> we're finished */
-        if ( (srcIPxor & 0x80000000) == 0x80000000 )
-            break;
-
-        /* add current bite value to the prefix representation */
-        m_srcIP_prefix.push_back( (srcIPtmp & 0x80000000) == 0x80000000 );
-        
-        srcIPxor <<= 1;
-        srcIPtmp <<= 1;
-    }
+    m_srcIP_prefix = rangeToPrefix(*((u_int32_t*)&m_srcIP_start), *((u_int32_t*)&m_srcIP_stop), 32);
 }
 
 //-----------------------------------------------------------------------------------
@@ -106,24 +95,7 @@ void AclRule::computeSrcIpPrefix()
 void AclRule::computeDstIpPrefix()
 {
     /* using IP_ADDRESS structure as a 32bit unsigned int, for easier logical operations */
-    u_int32_t dstIPxor = *((u_int32_t*)&m_dstIP_start) ^ *((u_int32_t*)&m_dstIP_stop);
-    u_int32_t dstIPtmp = *((u_int32_t*)&m_dstIP_start);
-
-    m_dstIP_prefix.clear();
-
-    /* looking for first different bite (its value is "1") */
-    for ( int i = 0; i < 32; ++i )
-    {
-        /* if we found the different bite -> we're finished */
-        if ( (dstIPxor & 0x80000000) == 0x80000000 )
-            break;
-
-        /* add current bite value to the prefix representation */
-        m_dstIP_prefix.push_back( (dstIPtmp & 0x80000000) == 0x80000000 );
-
-        dstIPxor <<= 1;
-        dstIPtmp <<= 1;
-    }
+    m_dstIP_prefix = rangeToPrefix(*((u_int32_t*)&m_dstIP_start), *((u_int32_t*)&m_dstIP_stop), 32);
 }
 
 //-----------------------------------------------------------------------------------
@@ -136,29 +108,15 @@ void AclRule::computeDstIpPrefix()
  */
 void AclRule::computeSrcPortPrefix()
 {
-    m_srcPort_prefix.clear();
-
     /* if port range is NOT inverted/negated, we're computing prefix form.
      * Otherwise we leave prefix representation set as "any" == zero length.
      */
     if ( !m_srcPortNeg )
+        m_srcPort_prefix = rangeToPrefix(m_srcPort_start, m_srcPort_stop, 16);
+    else
     {
-        u_int16_t srcPortXor = m_srcPort_start ^ m_srcPort_stop;
-        u_int16_t srcPortTmp = m_srcPort_start;
-
-        /* looking for first different bite (its value is "1") */
-        for ( int i = 0; i < 16; ++i )
-        {
-            /* if we found the different bite -> we're finished */
-            if ( (srcPortXor & 0x8000) == 0x8000 )
-                break;
-
-            /* add current bite value to the prefix representation */
-            m_srcPort_prefix.push_back( (srcPortTmp & 0x8000) == 0x8000 );
-
-            srcPortXor <<= 1;
-            srcPortTmp <<= 1;
-        }
+        m_srcPort_prefix.bits = 0;
+        m_srcPort_prefix.length = 0;
     }
 }
 
@@ -172,29 +130,15 @@ void AclRule::computeSrcPortPrefix()
  */
 void AclRule::computeDstPortPrefix()
 {
-    m_dstPort_prefix.clear();
-
     /* if port range is NOT inverted/negated, we're computing prefix form.
      * Otherwise we leave prefix representation set as "any" == zero length.
      */
     if ( !m_dstPortNeg )
+        m_dstPort_prefix = rangeToPrefix(m_dstPort_start, m_dstPort_stop, 16);
+    else
     {
-        u_int16_t dstPortXor = m_dstPort_start ^ m_dstPort_stop;
-        u_int16_t dstPortTmp = m_dstPort_start;
-
-        /* looking for first different bite (its value is "1") */
-        for ( int i = 0; i < 16; ++i )
-        {
-            /* if we found the different bite -> we're finished */
-            if ( (dstPortXor & 0x8000) == 0x8000 )
-                break;
-
-            /* add current bite value to the prefix representation */
-            m_dstPort_prefix.push_back( (dstPortTmp & 0x8000) == 0x8000 );
-
-            dstPortXor <<= 1;
-            dstPortTmp <<= 1;
-        }
+        m_dstPort_prefix.bits = 0;
+        m_dstPort_prefix.length = 0;
     }
 }
 
@@ -211,7 +155,7 @@ void AclRule::computeDstPortPrefix()
  */
 void AclRule::computeProtoPrefix()
 {
-    m_protocol_prefix.clear();
+    const boost::dynamic_bitset< >* protocolPrefix = NULL;
 
     switch (m_protocol)
     {
@@ -219,585 +163,593 @@ void AclRule::computeProtoPrefix()
             break;
             
         case PROTO_IPv4:
-            m_protocol_prefix = PROTO_IPv4_PREFIX;
+            protocolPrefix = &PROTO_IPv4_PREFIX;
             break;
 
         case PROTO_HOPOPT:
-            m_protocol_prefix = PROTO_HOPOPT_PREFIX;
+            protocolPrefix = &PROTO_HOPOPT_PREFIX;
             break;
 
         case PROTO_ICMPv4:
-            m_protocol_prefix = PROTO_ICMPv4_PREFIX;
+            protocolPrefix = &PROTO_ICMPv4_PREFIX;
             break;
 
         case PROTO_IGMP:
-            m_protocol_prefix = PROTO_IGMP_PREFIX;
+            protocolPrefix = &PROTO_IGMP_PREFIX;
             break;
 
         case PROTO_GGP:
-            m_protocol_prefix = PROTO_GGP_PREFIX;
+            protocolPrefix = &PROTO_GGP_PREFIX;
             break;
 
         case PROTO_IP_IN_IP:
-            m_protocol_prefix = PROTO_IP_IN_IP_PREFIX;
+            protocolPrefix = &PROTO_IP_IN_IP_PREFIX;
             break;
 
         case PROTO_ST:
-            m_protocol_prefix = PROTO_ST_PREFIX;
+            protocolPrefix = &PROTO_ST_PREFIX;
             break;
 
         case PROTO_TCP:
-            m_protocol_prefix = PROTO_TCP_PREFIX;
+            protocolPrefix = &PROTO_TCP_PREFIX;
             break;
 
         case PROTO_CBT:
-            m_protocol_prefix = PROTO_CBT_PREFIX;
+            protocolPrefix = &PROTO_CBT_PREFIX;
             break;
 
         case PROTO_EGP:
-            m_protocol_prefix = PROTO_EGP_PREFIX;
+            protocolPrefix = &PROTO_EGP_PREFIX;
             break;
 
         case PROTO_IGP:
-            m_protocol_prefix = PROTO_IGP_PREFIX;
+            protocolPrefix = &PROTO_IGP_PREFIX;
             break;
 
         case PROTO_BBN_RCC_MON:
-            m_protocol_prefix = PROTO_BBN_RCC_MON_PREFIX;
+            protocolPrefix = &PROTO_BBN_RCC_MON_PREFIX;
             break;
 
         case PROTO_NVP_II:
-            m_protocol_prefix = PROTO_NVP_II_PREFIX;
+            protocolPrefix = &PROTO_NVP_II_PREFIX;
             break;
 
         case PROTO_PUP:
-            m_protocol_prefix = PROTO_PUP_PREFIX;
+            protocolPrefix = &PROTO_PUP_PREFIX;
             break;
 
         case PROTO_ARGUS:
-            m_protocol_prefix = PROTO_ARGUS_PREFIX;
+            protocolPrefix = &PROTO_ARGUS_PREFIX;
             break;
 
         case PROTO_EMCON:
-            m_protocol_prefix = PROTO_EMCON_PREFIX;
+            protocolPrefix = &PROTO_EMCON_PREFIX;
             break;
 
         case PROTO_XNET:
-            m_protocol_prefix = PROTO_XNET_PREFIX;
+            protocolPrefix = &PROTO_XNET_PREFIX;
             break;
 
         case PROTO_CHAOS:
-            m_protocol_prefix = PROTO_CHAOS_PREFIX;
+            protocolPrefix = &PROTO_CHAOS_PREFIX;
             break;
 
         case PROTO_UDP:
-            m_protocol_prefix = PROTO_UDP_PREFIX;
+            protocolPrefix = &PROTO_UDP_PREFIX;
             break;
 
         case PROTO_MUX:
-            m_protocol_prefix = PROTO_MUX_PREFIX;
+            protocolPrefix = &PROTO_MUX_PREFIX;
             break;
 
         case PROTO_DCN_MEAS:
-            m_protocol_prefix = PROTO_DCN_MEAS_PREFIX;
+            protocolPrefix = &PROTO_DCN_MEAS_PREFIX;
             break;
 
         case PROTO_HMP:
-            m_protocol_prefix = PROTO_HMP_PREFIX;
+            protocolPrefix = &PROTO_HMP_PREFIX;
             break;
 
         case PROTO_PRM:
-            m_protocol_prefix = PROTO_PRM_PREFIX;
+            protocolPrefix = &PROTO_PRM_PREFIX;
             break;
 
         case PROTO_XNS_IDP:
-            m_protocol_prefix = PROTO_XNS_IDP_PREFIX;
+            protocolPrefix = &PROTO_XNS_IDP_PREFIX;
             break;
 
         case PROTO_TRUNK_1:
-            m_protocol_prefix = PROTO_TRUNK_1_PREFIX;
+            protocolPrefix = &PROTO_TRUNK_1_PREFIX;
             break;
 
         case PROTO_TRUNK_2:
-            m_protocol_prefix = PROTO_TRUNK_2_PREFIX;
+            protocolPrefix = &PROTO_TRUNK_2_PREFIX;
             break;
 
         case PROTO_LEAF_1:
-            m_protocol_prefix = PROTO_LEAF_1_PREFIX;
+            protocolPrefix = &PROTO_LEAF_1_PREFIX;
             break;
 
         case PROTO_LEAF_2:
-            m_protocol_prefix = PROTO_LEAF_2_PREFIX;
+            protocolPrefix = &PROTO_LEAF_2_PREFIX;
             break;
 
         case PROTO_RDP:
-            m_protocol_prefix = PROTO_RDP_PREFIX;
+            protocolPrefix = &PROTO_RDP_PREFIX;
             break;
 
         case PROTO_IRTP:
-            m_protocol_prefix = PROTO_IRTP_PREFIX;
+            protocolPrefix = &PROTO_IRTP_PREFIX;
             break;
 
         case PROTO_ISO_TP4:
-            m_protocol_prefix = PROTO_ISO_TP4_PREFIX;
+            protocolPrefix = &PROTO_ISO_TP4_PREFIX;
             break;
 
         case PROTO_NETBLK:
-            m_protocol_prefix = PROTO_NETBLK_PREFIX;
+            protocolPrefix = &PROTO_NETBLK_PREFIX;
             break;
 
         case PROTO_MFE_NSP:
-            m_protocol_prefix = PROTO_MFE_NSP_PREFIX;
+            protocolPrefix = &PROTO_MFE_NSP_PREFIX;
             break;
 
         case PROTO_METRIT_INP:
-            m_protocol_prefix = PROTO_METRIT_INP_PREFIX;
+            protocolPrefix = &PROTO_METRIT_INP_PREFIX;
             break;
 
         case PROTO_DCCP:
-            m_protocol_prefix = PROTO_DCCP_PREFIX;
+            protocolPrefix = &PROTO_DCCP_PREFIX;
             break;
 
         case PROTO_3PC:
-            m_protocol_prefix = PROTO_3PC_PREFIX;
+            protocolPrefix = &PROTO_3PC_PREFIX;
             break;
 
         case PROTO_IDPR:
-            m_protocol_prefix = PROTO_IDPR_PREFIX;
+            protocolPrefix = &PROTO_IDPR_PREFIX;
             break;
 
         case PROTO_XTP:
-            m_protocol_prefix = PROTO_XTP_PREFIX;
+            protocolPrefix = &PROTO_XTP_PREFIX;
             break;
 
         case PROTO_DDP:
-            m_protocol_prefix = PROTO_DDP_PREFIX;
+            protocolPrefix = &PROTO_DDP_PREFIX;
             break;
 
         case PROTO_IDPR_CMTP:
-            m_protocol_prefix = PROTO_IDPR_CMTP_PREFIX;
+            protocolPrefix = &PROTO_IDPR_CMTP_PREFIX;
             break;
 
         case PROTO_TP_PP:
-            m_protocol_prefix = PROTO_TP_PP_PREFIX;
+            protocolPrefix = &PROTO_TP_PP_PREFIX;
             break;
 
         case PROTO_IL:
-            m_protocol_prefix = PROTO_IL_PREFIX;
+            protocolPrefix = &PROTO_IL_PREFIX;
             break;
 
         case PROTO_IPv4_IPv6:
-            m_protocol_prefix = PROTO_IPv4_IPv6_PREFIX;
+            protocolPrefix = &PROTO_IPv4_IPv6_PREFIX;
             break;
 
         case PROTO_SDRP:
-            m_protocol_prefix = PROTO_SDRP_PREFIX;
+            protocolPrefix = &PROTO_SDRP_PREFIX;
             break;
 
         case PROTO_IPv4_IPv6_ROUTE:
-            m_protocol_prefix = PROTO_IPv4_IPv6_ROUTE_PREFIX;
+            protocolPrefix = &PROTO_IPv4_IPv6_ROUTE_PREFIX;
             break;
 
         case PROTO_IPv4_IPv6_FRAG:
-            m_protocol_prefix = PROTO_IPv4_IPv6_FRAG_PREFIX;
+            protocolPrefix = &PROTO_IPv4_IPv6_FRAG_PREFIX;
             break;
 
         case PROTO_IDRP:
-            m_protocol_prefix = PROTO_IDRP_PREFIX;
+            protocolPrefix = &PROTO_IDRP_PREFIX;
             break;
 
         case PROTO_RSVP:
-            m_protocol_prefix = PROTO_RSVP_PREFIX;
+            protocolPrefix = &PROTO_RSVP_PREFIX;
             break;
 
         case PROTO_GRE:
-            m_protocol_prefix = PROTO_GRE_PREFIX;
+            protocolPrefix = &PROTO_GRE_PREFIX;
             break;
 
         case PROTO_DSR:
-            m_protocol_prefix = PROTO_DSR_PREFIX;
+            protocolPrefix = &PROTO_DSR_PREFIX;
             break;
 
         case PROTO_BNA:
-            m_protocol_prefix = PROTO_BNA_PREFIX;
+            protocolPrefix = &PROTO_BNA_PREFIX;
             break;
 
         case PROTO_ESP:
-            m_protocol_prefix = PROTO_ESP_PREFIX;
+            protocolPrefix = &PROTO_ESP_PREFIX;
             break;
 
         case PROTO_AH:
-            m_protocol_prefix = PROTO_AH_PREFIX;
+            protocolPrefix = &PROTO_AH_PREFIX;
             break;
 
         case PROTO_I_NLSP:
-            m_protocol_prefix = PROTO_I_NLSP_PREFIX;
+            protocolPrefix = &PROTO_I_NLSP_PREFIX;
             break;
 
         case PROTO_SWIPE:
-            m_protocol_prefix = PROTO_SWIPE_PREFIX;
+            protocolPrefix = &PROTO_SWIPE_PREFIX;
             break;
 
         case PROTO_NARP:
-            m_protocol_prefix = PROTO_NARP_PREFIX;
+            protocolPrefix = &PROTO_NARP_PREFIX;
             break;
 
         case PROTO_MOBILE:
-            m_protocol_prefix = PROTO_MOBILE_PREFIX;
+            protocolPrefix = &PROTO_MOBILE_PREFIX;
             break;
 
         case PROTO_TLSP:
-            m_protocol_prefix = PROTO_TLSP_PREFIX;
+            protocolPrefix = &PROTO_TLSP_PREFIX;
             break;
 
         case PROTO_SKIP:
-            m_protocol_prefix = PROTO_SKIP_PREFIX;
+            protocolPrefix = &PROTO_SKIP_PREFIX;
             break;
 
         case PROTO_IPv6_ICMP:
-            m_protocol_prefix = PROTO_IPv6_ICMP_PREFIX;
+            protocolPrefix = &PROTO_IPv6_ICMP_PREFIX;
             break;
 
         case PROTO_IPv6_NONXT:
-            m_protocol_prefix = PROTO_IPv6_NONXT_PREFIX;
+            protocolPrefix = &PROTO_IPv6_NONXT_PREFIX;
             break;
 
         case PROTO_IPv6_OPTS:
-            m_protocol_prefix = PROTO_IPv6_OPTS_PREFIX;
+            protocolPrefix = &PROTO_IPv6_OPTS_PREFIX;
             break;
 
         case PROTO_AHIP:
-            m_protocol_prefix = PROTO_AHIP_PREFIX;
+            protocolPrefix = &PROTO_AHIP_PREFIX;
             break;
 
         case PROTO_CFTP:
-            m_protocol_prefix = PROTO_CFTP_PREFIX;
+            protocolPrefix = &PROTO_CFTP_PREFIX;
             break;
 
         case PROTO_ALN:
-            m_protocol_prefix = PROTO_ALN_PREFIX;
+            protocolPrefix = &PROTO_ALN_PREFIX;
             break;
 
         case PROTO_SAT_EXPAK:
-            m_protocol_prefix = PROTO_SAT_EXPAK_PREFIX;
+            protocolPrefix = &PROTO_SAT_EXPAK_PREFIX;
             break;
 
         case PROTO_KRYPTOLAN:
-            m_protocol_prefix = PROTO_KRYPTOLAN_PREFIX;
+            protocolPrefix = &PROTO_KRYPTOLAN_PREFIX;
             break;
 
         case PROTO_RVD:
-            m_protocol_prefix = PROTO_RVD_PREFIX;
+            protocolPrefix = &PROTO_RVD_PREFIX;
             break;
 
         case PROTO_IPPC:
-            m_protocol_prefix = PROTO_IPPC_PREFIX;
+            protocolPrefix = &PROTO_IPPC_PREFIX;
             break;
 
         case PROTO_ADFS:
-            m_protocol_prefix = PROTO_ADFS_PREFIX;
+            protocolPrefix = &PROTO_ADFS_PREFIX;
             break;
 
         case PROTO_SAT_MON:
-            m_protocol_prefix = PROTO_SAT_MON_PREFIX;
+            protocolPrefix = &PROTO_SAT_MON_PREFIX;
             break;
 
         case PROTO_VISA:
-            m_protocol_prefix = PROTO_VISA_PREFIX;
+            protocolPrefix = &PROTO_VISA_PREFIX;
             break;
 
         case PROTO_IPCV:
-            m_protocol_prefix = PROTO_IPCV_PREFIX;
+            protocolPrefix = &PROTO_IPCV_PREFIX;
             break;
 
         case PROTO_CPNX:
-            m_protocol_prefix = PROTO_CPNX_PREFIX;
+            protocolPrefix = &PROTO_CPNX_PREFIX;
             break;
 
         case PROTO_CPHB:
-            m_protocol_prefix = PROTO_CPHB_PREFIX;
+            protocolPrefix = &PROTO_CPHB_PREFIX;
             break;
 
         case PROTO_WSN:
-            m_protocol_prefix = PROTO_WSN_PREFIX;
+            protocolPrefix = &PROTO_WSN_PREFIX;
             break;
 
         case PROTO_PVP:
-            m_protocol_prefix = PROTO_PVP_PREFIX;
+            protocolPrefix = &PROTO_PVP_PREFIX;
             break;
 
         case PROTO_BR_SAT_MON:
-            m_protocol_prefix = PROTO_BR_SAT_MON_PREFIX;
+            protocolPrefix = &PROTO_BR_SAT_MON_PREFIX;
             break;
 
         case PROTO_SUN_ND:
-            m_protocol_prefix = PROTO_SUN_ND_PREFIX;
+            protocolPrefix = &PROTO_SUN_ND_PREFIX;
             break;
 
         case PROTO_WB_MON:
-            m_protocol_prefix = PROTO_WB_MON_PREFIX;
+            protocolPrefix = &PROTO_WB_MON_PREFIX;
             break;
 
         case PROTO_WB_EXPAK:
-            m_protocol_prefix = PROTO_WB_EXPAK_PREFIX;
+            protocolPrefix = &PROTO_WB_EXPAK_PREFIX;
             break;
 
         case PROTO_ISO_IP:
-            m_protocol_prefix = PROTO_ISO_IP_PREFIX;
+            protocolPrefix = &PROTO_ISO_IP_PREFIX;
             break;
 
         case PROTO_VMTP:
-            m_protocol_prefix = PROTO_VMTP_PREFIX;
+            protocolPrefix = &PROTO_VMTP_PREFIX;
             break;
 
         case PROTO_SECURE_VMTP:
-            m_protocol_prefix = PROTO_SECURE_VMTP_PREFIX;
+            protocolPrefix = &PROTO_SECURE_VMTP_PREFIX;
             break;
 
         case PROTO_VINES:
-            m_protocol_prefix = PROTO_VINES_PREFIX;
+            protocolPrefix = &PROTO_VINES_PREFIX;
             break;
 
         case PROTO_IPTM:
-            m_protocol_prefix = PROTO_IPTM_PREFIX;
+            protocolPrefix = &PROTO_IPTM_PREFIX;
             break;
 
         case PROTO_NSFNET_IGP:
-            m_protocol_prefix = PROTO_NSFNET_IGP_PREFIX;
+            protocolPrefix = &PROTO_NSFNET_IGP_PREFIX;
             break;
 
         case PROTO_DGP:
-            m_protocol_prefix = PROTO_DGP_PREFIX;
+            protocolPrefix = &PROTO_DGP_PREFIX;
             break;
 
         case PROTO_TCF:
-            m_protocol_prefix = PROTO_TCF_PREFIX;
+            protocolPrefix = &PROTO_TCF_PREFIX;
             break;
 
         case PROTO_EIGRP:
-            m_protocol_prefix = PROTO_EIGRP_PREFIX;
+            protocolPrefix = &PROTO_EIGRP_PREFIX;
             break;
 
         case PROTO_OSPF:
-            m_protocol_prefix = PROTO_OSPF_PREFIX;
+            protocolPrefix = &PROTO_OSPF_PREFIX;
             break;
 
         case PROTO_SPRITE_RPC:
-            m_protocol_prefix = PROTO_SPRITE_RPC_PREFIX;
+            protocolPrefix = &PROTO_SPRITE_RPC_PREFIX;
             break;
 
         case PROTO_LARP:
-            m_protocol_prefix = PROTO_LARP_PREFIX;
+            protocolPrefix = &PROTO_LARP_PREFIX;
             break;
 
         case PROTO_MTP:
-            m_protocol_prefix = PROTO_MTP_PREFIX;
+            protocolPrefix = &PROTO_MTP_PREFIX;
             break;
 
         case PROTO_AX_25:
-            m_protocol_prefix = PROTO_AX_25_PREFIX;
+            protocolPrefix = &PROTO_AX_25_PREFIX;
             break;
 
         case PROTO_IPIP:
-            m_protocol_prefix = PROTO_IPIP_PREFIX;
+            protocolPrefix = &PROTO_IPIP_PREFIX;
             break;
 
         case PROTO_MICP:
-            m_protocol_prefix = PROTO_MICP_PREFIX;
+            protocolPrefix = &PROTO_MICP_PREFIX;
             break;
 
         case PROTO_SCC_SP:
-            m_protocol_prefix = PROTO_SCC_SP_PREFIX;
+            protocolPrefix = &PROTO_SCC_SP_PREFIX;
             break;
 
         case PROTO_ETHERIP:
-            m_protocol_prefix = PROTO_ETHERIP_PREFIX;
+            protocolPrefix = &PROTO_ETHERIP_PREFIX;
             break;
 
         case PROTO_ENCAP:
-            m_protocol_prefix = PROTO_ENCAP_PREFIX;
+            protocolPrefix = &PROTO_ENCAP_PREFIX;
             break;
 
         case PROTO_APES:
-            m_protocol_prefix = PROTO_APES_PREFIX;
+            protocolPrefix = &PROTO_APES_PREFIX;
             break;
 
         case PROTO_GMTP:
-            m_protocol_prefix = PROTO_GMTP_PREFIX;
+            protocolPrefix = &PROTO_GMTP_PREFIX;
             break;
 
         case PROTO_IFMP:
-            m_protocol_prefix = PROTO_IFMP_PREFIX;
+            protocolPrefix = &PROTO_IFMP_PREFIX;
             break;
 
         case PROTO_PNNI:
-            m_protocol_prefix = PROTO_PNNI_PREFIX;
+            protocolPrefix = &PROTO_PNNI_PREFIX;
             break;
 
         case PROTO_PIM:
-            m_protocol_prefix = PROTO_PIM_PREFIX;
+            protocolPrefix = &PROTO_PIM_PREFIX;
             break;
 
         case PROTO_ARIS:
-            m_protocol_prefix = PROTO_ARIS_PREFIX;
+            protocolPrefix = &PROTO_ARIS_PREFIX;
             break;
 
         case PROTO_SCPS:
-            m_protocol_prefix = PROTO_SCPS_PREFIX;
+            protocolPrefix = &PROTO_SCPS_PREFIX;
             break;
 
         case PROTO_QNX:
-            m_protocol_prefix = PROTO_QNX_PREFIX;
+            protocolPrefix = &PROTO_QNX_PREFIX;
             break;
 
         case PROTO_AN:
-            m_protocol_prefix = PROTO_AN_PREFIX;
+            protocolPrefix = &PROTO_AN_PREFIX;
             break;
 
         case PROTO_IP_COMP:
-            m_protocol_prefix = PROTO_IP_COMP_PREFIX;
+            protocolPrefix = &PROTO_IP_COMP_PREFIX;
             break;
 
         case PROTO_SNP:
-            m_protocol_prefix = PROTO_SNP_PREFIX;
+            protocolPrefix = &PROTO_SNP_PREFIX;
             break;
 
         case PROTO_COMPAQ:
-            m_protocol_prefix = PROTO_COMPAQ_PREFIX;
+            protocolPrefix = &PROTO_COMPAQ_PREFIX;
             break;
 
         case PROTO_IPX_IN_IP:
-            m_protocol_prefix = PROTO_IPX_IN_IP_PREFIX;
+            protocolPrefix = &PROTO_IPX_IN_IP_PREFIX;
             break;
 
         case PROTO_VRRP:
-            m_protocol_prefix = PROTO_VRRP_PREFIX;
+            protocolPrefix = &PROTO_VRRP_PREFIX;
             break;
 
         case PROTO_PGM:
-            m_protocol_prefix = PROTO_PGM_PREFIX;
+            protocolPrefix = &PROTO_PGM_PREFIX;
             break;
 
         case PROTO_AZHP:
-            m_protocol_prefix = PROTO_AZHP_PREFIX;
+            protocolPrefix = &PROTO_AZHP_PREFIX;
             break;
 
         case PROTO_L2TP:
-            m_protocol_prefix = PROTO_L2TP_PREFIX;
+            protocolPrefix = &PROTO_L2TP_PREFIX;
             break;
 
         case PROTO_DDX:
-            m_protocol_prefix = PROTO_DDX_PREFIX;
+            protocolPrefix = &PROTO_DDX_PREFIX;
             break;
 
         case PROTO_IATP:
-            m_protocol_prefix = PROTO_IATP_PREFIX;
+            protocolPrefix = &PROTO_IATP_PREFIX;
             break;
 
         case PROTO_STP:
-            m_protocol_prefix = PROTO_STP_PREFIX;
+            protocolPrefix = &PROTO_STP_PREFIX;
             break;
 
         case PROTO_SRP:
-            m_protocol_prefix = PROTO_SRP_PREFIX;
+            protocolPrefix = &PROTO_SRP_PREFIX;
             break;
 
         case PROTO_UTI:
-            m_protocol_prefix = PROTO_UTI_PREFIX;
+            protocolPrefix = &PROTO_UTI_PREFIX;
             break;
 
         case PROTO_SMP:
-            m_protocol_prefix = PROTO_SMP_PREFIX;
+            protocolPrefix = &PROTO_SMP_PREFIX;
             break;
 
         case PROTO_SM:
-            m_protocol_prefix = PROTO_SM_PREFIX;
+            protocolPrefix = &PROTO_SM_PREFIX;
             break;
 
         case PROTO_PTP:
-            m_protocol_prefix = PROTO_PTP_PREFIX;
+            protocolPrefix = &PROTO_PTP_PREFIX;
             break;
 
         case PROTO_IPv4_ISIS:
-            m_protocol_prefix = PROTO_IPv4_ISIS_PREFIX;
+            protocolPrefix = &PROTO_IPv4_ISIS_PREFIX;
             break;
 
         case PROTO_FIRE:
-            m_protocol_prefix = PROTO_FIRE_PREFIX;
+            protocolPrefix = &PROTO_FIRE_PREFIX;
             break;
 
         case PROTO_CRTP:
-            m_protocol_prefix = PROTO_CRTP_PREFIX;
+            protocolPrefix = &PROTO_CRTP_PREFIX;
             break;
 
         case PROTO_CRUDP:
-            m_protocol_prefix = PROTO_CRUDP_PREFIX;
+            protocolPrefix = &PROTO_CRUDP_PREFIX;
             break;
 
         case PROTO_SSCOPMCE:
-            m_protocol_prefix = PROTO_SSCOPMCE_PREFIX;
+            protocolPrefix = &PROTO_SSCOPMCE_PREFIX;
             break;
 
         case PROTO_IPLT:
-            m_protocol_prefix = PROTO_IPLT_PREFIX;
+            protocolPrefix = &PROTO_IPLT_PREFIX;
             break;
 
         case PROTO_SPS:
-            m_protocol_prefix = PROTO_SPS_PREFIX;
+            protocolPrefix = &PROTO_SPS_PREFIX;
             break;
 
         case PROTO_PIPE:
-            m_protocol_prefix = PROTO_PIPE_PREFIX;
+            protocolPrefix = &PROTO_PIPE_PREFIX;
             break;
 
         case PROTO_SCTP:
-            m_protocol_prefix = PROTO_SCTP_PREFIX;
+            protocolPrefix = &PROTO_SCTP_PREFIX;
             break;
 
         case PROTO_FC:
-            m_protocol_prefix = PROTO_FC_PREFIX;
+            protocolPrefix = &PROTO_FC_PREFIX;
             break;
 
         case PROTO_RSVP_E2E_IGNORE:
-            m_protocol_prefix = PROTO_RSVP_E2E_IGNORE_PREFIX;
+            protocolPrefix = &PROTO_RSVP_E2E_IGNORE_PREFIX;
             break;
 
         case PROTO_MH:
-            m_protocol_prefix = PROTO_MH_PREFIX;
+            protocolPrefix = &PROTO_MH_PREFIX;
             break;
 
         case PROTO_UDPL:
-            m_protocol_prefix = PROTO_UDPL_PREFIX;
+            protocolPrefix = &PROTO_UDPL_PREFIX;
             break;
 
         case PROTO_MPLS_IN_IP:
-            m_protocol_prefix = PROTO_MPLS_IN_IP_PREFIX;
+            protocolPrefix = &PROTO_MPLS_IN_IP_PREFIX;
             break;
 
         case PROTO_MANET:
-            m_protocol_prefix = PROTO_MANET_PREFIX;
+            protocolPrefix = &PROTO_MANET_PREFIX;
             break;
 
         case PROTO_HIP:
-            m_protocol_prefix = PROTO_HIP_PREFIX;
+            protocolPrefix = &PROTO_HIP_PREFIX;
             break;
 
         case PROTO_SHIM6:
-            m_protocol_prefix = PROTO_SHIM6_PREFIX;
+            protocolPrefix = &PROTO_SHIM6_PREFIX;
             break;
 
         case PROTO_WESP:
-            m_protocol_prefix = PROTO_WESP_PREFIX;
+            protocolPrefix = &PROTO_WESP_PREFIX;
             break;
 
         case PROTO_ROHC:
-            m_protocol_prefix = PROTO_ROHC_PREFIX;
+            protocolPrefix = &PROTO_ROHC_PREFIX;
             break;
 
         default:
-            m_protocol_prefix = PROTO_UNKNOWN_PREFIX;
+            protocolPrefix = &PROTO_UNKNOWN_PREFIX;
             break;
     }
+
+    if ( protocolPrefix != NULL )
+        m_protocol_prefix = bitsetToPrefix(*protocolPrefix);
+    else
+    {
+        m_protocol_prefix.bits = 0;
+        m_protocol_prefix.length = 0;
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -814,31 +766,11 @@ void AclRule::computeSrcIpStartStop()
     u_int32_t* const srcIPstart_ptr = (u_int32_t* const) &m_srcIP_start;
     u_int32_t* const srcIPstop_ptr = (u_int32_t* const) &m_srcIP_stop;
 
-    /* set the range to maximum == "any" */
-    (*srcIPstart_ptr) = 0x00000000;
-    (*srcIPstop_ptr) = 0xFFFFFFFF;
-    
-    int prefixSize = m_srcIP_prefix.size();
-    u_int32_t maska = 0x80000000;               /* mask for setting particular bite from prefix */
-    
-    /* based on prefix representation we set appropriate parts of start and end IPv4 range */
-    for ( int i = 0; i < prefixSize; ++i )
-    {
-        /* if there is bite "1" on position "i" */
-        if ( m_srcIP_prefix[i] )
-        {
-            (*srcIPstart_ptr) |= maska;
-            /* for end (stop) we don't need to set value "1" */
-        }
-        /* if there is bite "0" on position "i" */
-        else
-        {
-            (*srcIPstop_ptr) &= ~maska;
-            /* for start we don't need to set value "0" */
-        }
+    /* bits behind the prefix are zero in the start address and one in the end address */
+    u_int32_t hostMask = (m_srcIP_prefix.length == 0) ? 0xFFFFFFFF : ~(0xFFFFFFFF << (32 - m_srcIP_prefix.length));
 
-        maska >>= 1;
-    }
+    (*srcIPstart_ptr) = m_srcIP_prefix.bits;
+    (*srcIPstop_ptr) = m_srcIP_prefix.bits | hostMask;
 }
 
 //-----------------------------------------------------------------------------------
@@ -855,31 +787,11 @@ void AclRule::computeDstIpStartStop()
     u_int32_t* const dstIPstart_ptr = (u_int32_t* const) &m_dstIP_start;
     u_int32_t* const dstIPstop_ptr = (u_int32_t* const) &m_dstIP_stop;
 
-    /* set the range to maximum == "any" */
-    (*dstIPstart_ptr) = 0x00000000;
-    (*dstIPstop_ptr) = 0xFFFFFFFF;
+    /* bits behind the prefix are zero in the start address and one in the end address */
+    u_int32_t hostMask = (m_dstIP_prefix.length == 0) ? 0xFFFFFFFF : ~(0xFFFFFFFF << (32 - m_dstIP_prefix.length));
 
-    int prefixSize = m_dstIP_prefix.size();
-    u_int32_t maska = 0x80000000;               /* mask for setting particular bite from prefix */
-
-    /* based on prefix representation we set appropriate parts of start and end IPv4 range */
-    for ( int i = 0; i < prefixSize; ++i )
-    {
-        /* if there is bite "1" on position "i" */
-        if ( m_dstIP_prefix[i] )
-        {
-            (*dstIPstart_ptr) |= maska;
-            /* for end (stop) we don't need to set value "1" */
-        }
-        /* if there is bite "0" on position "i" */
-        else
-        {
-            (*dstIPstop_ptr) &= ~maska;
-            /* for start we don't need to set value "0" */
-        }
-
-        maska >>= 1;
-    }
+    (*dstIPstart_ptr) = m_dstIP_prefix.bits;
+    (*dstIPstop_ptr) = m_dstIP_prefix.bits | hostMask;
 }
 
 //-----------------------------------------------------------------------------------
@@ -892,31 +804,11 @@ void AclRule::computeDstIpStartStop()
  */
 void AclRule::computeSrcPortStartStop()
 {
-    /* set the range to maximum == "any" */
-    m_srcPort_start = 0x0000;
-    m_srcPort_stop = 0xFFFF;
-
-    int prefixSize = m_srcPort_prefix.size();
-    u_int16_t maska = 0x8000;                   /* mask for setting particular bite from prefix */
+    /* bits behind the prefix are zero in the start port and one in the end port */
+    u_int16_t hostMask = (m_srcPort_prefix.length == 0) ? 0xFFFF : (u_int16_t) ~(0xFFFF << (16 - m_srcPort_prefix.length));
 
-    /* based on prefix representation we set appropriate parts of start and end port range */
-    for ( int i = 0; i < prefixSize; ++i )
-    {
-        /* if there is bite "1" on position "i" */
-        if ( m_srcPort_prefix[i] )
-        {
-            m_srcPort_start |= maska;
-            /* for end (stop) we don't need to set value "1" */
-        }
-        /* if there is bite "0" on position "i" */
-        else
-        {
-            m_srcPort_stop &= ~maska;
-            /* for start we don't need to set value "0" */
-        }
-
-        maska >>= 1;
-    }
+    m_srcPort_start = m_srcPort_prefix.bits >> 16;
+    m_srcPort_stop = (m_srcPort_prefix.bits >> 16) | hostMask;
 }
 
 //-----------------------------------------------------------------------------------
@@ -929,31 +821,11 @@ void AclRule::computeSrcPortStartStop()
  */
 void AclRule::computeDstPortStartStop()
 {
-    /* set the range to maximum == "any" */
-    m_dstPort_start = 0x0000;
-    m_dstPort_stop = 0xFFFF;
+    /* bits behind the prefix are zero in the start port and one in the end port */
+    u_int16_t hostMask = (m_dstPort_prefix.length == 0) ? 0xFFFF : (u_int16_t) ~(0xFFFF << (16 - m_dstPort_prefix.length));
 
-    int prefixSize = m_dstPort_prefix.size();
-    u_int16_t maska = 0x8000;                   /* mask for setting particular bite from prefix */
-
-    /* based on prefix representation we set appropriate parts of start and end port range */
-    for ( int i = 0; i < prefixSize; ++i )
-    {
-        /* if there is bite "1" on position "i" */
-        if ( m_dstPort_prefix[i] )
-        {
-            m_dstPort_start |= maska;
-            /* for end (stop) we don't need to set value "1" */
-        }
-        /* if there is bite "0" on position "i" */
-        else
-        {
-            m_dstPort_stop &= ~maska;
-            /* for start we don't need to set value "0" */
-        }
-
-        maska >>= 1;
-    }
+    m_dstPort_start = m_dstPort_prefix.bits >> 16;
+    m_dstPort_stop = (m_dstPort_prefix.bits >> 16) | hostMask;
 }
 
 //-----------------------------------------------------------------------------------
@@ -1225,6 +1097,81 @@ ostream& operator<<(ostream& out, const AclRule& rule)
     return out;
 }
 
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method computes prefix representation ("super-prefix") of passed range.
+ *
+ * The prefix consists of leading bits, in which start and end value of the range are the same,
+ * so its length is found by counting leading zeros of XOR of both values.
+ *
+ * @param start start value of the range.
+ * @param stop end value of the range.
+ * @param width number of bits of values (32 for IPv4 addresses, 16 for ports).
+ * @return prefix representation of the range.
+ */
+FIELD_PREFIX AclRule::rangeToPrefix(u_int32_t start, u_int32_t stop, unsigned width)
+{
+    FIELD_PREFIX prefix;
+
+    /* align values to the most significant bit */
+    start <<= (32 - width);
+    stop <<= (32 - width);
+
+    u_int32_t diff = start ^ stop;
+
+    prefix.length = (diff == 0) ? width : __builtin_clz(diff);
+    prefix.bits = (prefix.length == 0) ? 0 : (start & (0xFFFFFFFF << (32 - prefix.length)));
+
+    return prefix;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method converts prefix stored in boost::dynamic_bitset<> object to structure FIELD_PREFIX.
+ *
+ * Bit on position 0 of the bitset is the first bit of the prefix. Bits behind the position 31
+ * are ignored.
+ *
+ * @param prefix reference to boost::dynamic_bitset<> object containing the prefix.
+ * @return prefix in the form of structure FIELD_PREFIX.
+ */
+FIELD_PREFIX AclRule::bitsetToPrefix(const boost::dynamic_bitset< >& prefix)
+{
+    FIELD_PREFIX result;
+    size_t prefixSize = (prefix.size() < 32) ? prefix.size() : 32;
+
+    result.bits = 0;
+    result.length = prefixSize;
+
+    for ( size_t i = 0; i < prefixSize; ++i )
+    {
+        if ( prefix[i] )
+            result.bits |= 0x80000000 >> i;
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method converts prefix stored in structure FIELD_PREFIX to boost::dynamic_bitset<> object.
+ *
+ * @param prefix reference to structure FIELD_PREFIX containing the prefix.
+ * @return boost::dynamic_bitset<> object, which bit on position 0 is the first bit of the prefix.
+ */
+boost::dynamic_bitset< > AclRule::prefixToBitset(const FIELD_PREFIX& prefix)
+{
+    boost::dynamic_bitset< > result(prefix.length);
+
+    for ( size_t i = 0; i < prefix.length; ++i )
+        result[i] = (prefix.bits & (0x80000000 >> i)) != 0;
+
+    return result;
+}
+
 /*******************************************************************************/
 /********************************* GET Methods *********************************/
 
@@ -1297,15 +1244,15 @@ const IP_ADDRESS& AclRule::getSrcIpStop() const
 /**
  * Method for getting prefix representation of the source IPv4 address range.
  *
- * Method for getting reference to boost::dynamic_bitset<> object containing
+ * Method for getting boost::dynamic_bitset<> object containing
  * prefix representation of the source IPv4 address range.
  *
- * @return reference to the boost::dynamic_bitset<> object containing
+ * @return boost::dynamic_bitset<> object containing
  *         prefix representation of the source IPv4 address range.
  */
-const boost::dynamic_bitset< >& AclRule::getSrcIpPrefix() const
+boost::dynamic_bitset< > AclRule::getSrcIpPrefix() const
 {
-    return m_srcIP_prefix;
+    return prefixToBitset(m_srcIP_prefix);
 }
 
 //-----------------------------------------------------------------------------------
@@ -1379,15 +1326,15 @@ const IP_ADDRESS& AclRule::getDstIpStop() const
 /**
  * Method for getting prefix representation of the destination IPv4 address range.
  *
- * Method for getting reference to boost::dynamic_bitset<> object containing
+ * Method for getting boost::dynamic_bitset<> object containing
  * prefix representation of the destination IPv4 address range.
  *
- * @return reference to the boost::dynamic_bitset<> object containing
+ * @return boost::dynamic_bitset<> object containing
  *         prefix representation of the destination IPv4 address range.
  */
-const boost::dynamic_bitset< >& AclRule::getDstIpPrefix() const
+boost::dynamic_bitset< > AclRule::getDstIpPrefix() const
 {
-    return m_dstIP_prefix;
+    return prefixToBitset(m_dstIP_prefix);
 }
 
 //-----------------------------------------------------------------------------------
@@ -1458,15 +1405,15 @@ u_int16_t AclRule::getSrcPortStop() const
 /**
  * Method for getting prefix representation of the source port (TCP/UDP) range.
  *
- * Method for getting reference to boost::dynamic_bitset<> object containing
+ * Method for getting boost::dynamic_bitset<> object containing
  * prefix representation of the source port (TCP/UDP) range.
  *
- * @return reference to the boost::dynamic_bitset<> object containing
+ * @return boost::dynamic_bitset<> object containing
  *         prefix representation of the source port (TCP/UDP) range.
  */
-const boost::dynamic_bitset< >& AclRule::getSrcPortPrefix() const
+boost::dynamic_bitset< > AclRule::getSrcPortPrefix() const
 {
-    return m_srcPort_prefix;
+    return prefixToBitset(m_srcPort_prefix);
 }
 
 //-----------------------------------------------------------------------------------
@@ -1553,15 +1500,15 @@ u_int16_t AclRule::getDstPortStop() const
 /**
  * Method for getting prefix representation of the destination port (TCP/UDP) range.
  *
- * Method for getting reference to boost::dynamic_bitset<> object containing
+ * Method for getting boost::dynamic_bitset<> object containing
  * prefix representation of the destination port (TCP/UDP) range.
  *
- * @return reference to the boost::dynamic_bitset<> object containing
+ * @return boost::dynamic_bitset<> object containing
  *         prefix representation of the destination port (TCP/UDP) range.
  */
-const boost::dynamic_bitset< >& AclRule::getDstPortPrefix() const
+boost::dynamic_bitset< > AclRule::getDstPortPrefix() const
 {
-    return m_dstPort_prefix;
+    return prefixToBitset(m_dstPort_prefix);
 }
 
 //-----------------------------------------------------------------------------------
@@ -1615,15 +1562,15 @@ int AclRule::getProtocol() const
 /**
  * Method for getting prefix representation of the set protocol.
  *
- * Method for getting reference to boost::dynamic_bitset<> object containing
+ * Method for getting boost::dynamic_bitset<> object containing
  * prefix representation of the set protocol.
  *
- * @return reference to the boost::dynamic_bitset<> object containing
+ * @return boost::dynamic_bitset<> object containing
  *         prefix representation of the set protocol.
  */
-const boost::dynamic_bitset< >& AclRule::getProtocolPrefix() const
+boost::dynamic_bitset< > AclRule::getProtocolPrefix() const
 {
-    return m_protocol_prefix;
+    return prefixToBitset(m_protocol_prefix);
 }
 
 //-----------------------------------------------------------------------------------
@@ -1721,17 +1668,17 @@ string AclRule::getFieldString(int dimension) const throw(Exception)
 /**
  * Method for getting reference to object containing prefix representation of wanted dimension (field).
  *
- * Method returns reference to boost::dynamic_bitset<> object containing
+ * Method returns reference to structure FIELD_PREFIX containing
  * prefix representation of particular dimension (field) specified by
  * passed value (should be entered as constant DIMENSION_xxx).
  *
  * @throw Exception if unknown dimension number is passed as parameter, method
  *                  throws exception "Unknown dimension! Out of borders!".
  * @param dimension value representing wanted dimension (field). Should be constant DIMENSION_xxx.
- * @return reference to boost::dynamic_bitset<> object containing prefix
+ * @return reference to structure FIELD_PREFIX containing prefix
  *         representation of wanted dimension (field).
  */
-const boost::dynamic_bitset< >& AclRule::getFieldPrefix(int dimension) const throw(Exception)
+const FIELD_PREFIX& AclRule::getFieldPrefix(int dimension) const throw(Exception)
 {
     switch ( dimension )
     {
@@ -1840,7 +1787,7 @@ void AclRule::setSrcIP(const IP_ADDRESS& start, const IP_ADDRESS& stop, bool com
  */
 void AclRule::setSrcIP(const boost::dynamic_bitset< >& srcIPprefix, bool compute_start_stop)
 {
-    m_srcIP_prefix = srcIPprefix;
+    m_srcIP_prefix = bitsetToPrefix(srcIPprefix);
 
     if ( compute_start_stop )
         computeSrcIpStartStop();
@@ -1930,7 +1877,7 @@ void AclRule::setDstIP(const IP_ADDRESS& start, const IP_ADDRESS& stop, bool com
  */
 void AclRule::setDstIP(const boost::dynamic_bitset< >& dstIPprefix, bool compute_start_stop)
 {
-    m_dstIP_prefix = dstIPprefix;
+    m_dstIP_prefix = bitsetToPrefix(dstIPprefix);
 
     if ( compute_start_stop )
         computeDstIpStartStop();
@@ -1985,7 +1932,7 @@ void AclRule::setSrcPort(u_int16_t start, u_int16_t stop, bool negated, bool com
 void AclRule::setSrcPort(const boost::dynamic_bitset< >& srcPortPrefix, bool compute_start_stop)
 {
     m_srcPortNeg = false;
-    m_srcPort_prefix = srcPortPrefix;
+    m_srcPort_prefix = bitsetToPrefix(srcPortPrefix);
 
     if ( compute_start_stop )
         computeSrcPortStartStop();
@@ -2040,7 +1987,7 @@ void AclRule::setDstPort(u_int16_t start, u_int16_t stop, bool negated, bool com
 void AclRule::setDstPort(const boost::dynamic_bitset< >& dstPortPrefix, bool compute_start_stop)
 {
     m_dstPortNeg = false;
-    m_dstPort_prefix = dstPortPrefix;
+    m_dstPort_prefix = bitsetToPrefix(dstPortPrefix);
 
     if ( compute_start_stop )
         computeDstPortStartStop();
@@ -38,6 +38,18 @@ typedef struct {
     u_int8_t A;         /** value from 0 to 255 */
 } IP_ADDRESS;
 
+/**
+ * Structure for representing the prefix form of a field of the rule.
+ *
+ * All prefixes of rules have at most 32 bits, so they are stored in one 32bit word instead of
+ * boost::dynamic_bitset<>. The first bit of the prefix is the most significant bit of "bits"
+ * and bits behind the prefix are zero.
+ */
+typedef struct {
+    u_int32_t bits;     /** bits of the prefix aligned to the most significant bit */
+    u_int8_t length;    /** number of bits of the prefix, from 0 ("any") to 32 */
+} FIELD_PREFIX;
+
 /**
  * Constants representing dimensions (fields) of an ACL rule.
  */
@@ -67,23 +79,23 @@ class AclRule
     private:
         IP_ADDRESS m_srcIP_start;               /** Start IPv4 address of source address range. */
         IP_ADDRESS m_srcIP_stop;                /** End IPv4 address of source address range. */
-        boost::dynamic_bitset<> m_srcIP_prefix; /** Source address range in prefix form ("super-prefix"). */
+        FIELD_PREFIX m_srcIP_prefix;            /** Source address range in prefix form ("super-prefix"). */
         
         IP_ADDRESS m_dstIP_start;               /** Start IPv4 address of destination address range. */
         IP_ADDRESS m_dstIP_stop;                /** End IPv4 address of destination address range. */
-        boost::dynamic_bitset<> m_dstIP_prefix; /** Destination address range in prefix form ("super-prefix"). */
+        FIELD_PREFIX m_dstIP_prefix;            /** Destination address range in prefix form ("super-prefix"). */
 
         int m_protocol;                                 /** Value representing communication protocol. */
-        boost::dynamic_bitset<> m_protocol_prefix;      /** Communication protocol value in prefix form. */
+        FIELD_PREFIX m_protocol_prefix;                 /** Communication protocol value in prefix form. */
         
         u_int16_t m_srcPort_start;                      /** Start port number of source port range. */
         u_int16_t m_srcPort_stop;                       /** End port number of source port range. */
-        boost::dynamic_bitset<> m_srcPort_prefix;       /** Source port range in prefix form ("super-prefix"). */
+        FIELD_PREFIX m_srcPort_prefix;                  /** Source port range in prefix form ("super-prefix"). */
         bool m_srcPortNeg;                              /** Flag representing if port range is negated/inverted. */
 
         u_int16_t m_dstPort_start;                      /** Start port number of destination port range. */
         u_int16_t m_dstPort_stop;                       /** End port number of destination port range. */
-        boost::dynamic_bitset<> m_dstPort_prefix;       /** Destination port range in prefix form ("super-prefix"). */
+        FIELD_PREFIX m_dstPort_prefix;                  /** Destination port range in prefix form ("super-prefix"). */
         bool m_dstPortNeg;                              /** Flag representing if port range is negated/inverted. */
 
         int m_action;                           /** Rule action. */
@@ -111,32 +123,36 @@ class AclRule
         static std::string protocolToString(int protocol);
         static std::string portToString(u_int16_t port);
 
+        static FIELD_PREFIX rangeToPrefix(u_int32_t start, u_int32_t stop, unsigned width);
+        static FIELD_PREFIX bitsetToPrefix(const boost::dynamic_bitset< >& prefix);
+        static boost::dynamic_bitset< > prefixToBitset(const FIELD_PREFIX& prefix);
+
         /******** GET methods ********/
         std::string getSrcIpRangeString() const;
         const IP_ADDRESS& getSrcIpStart() const;
         const IP_ADDRESS& getSrcIpStop() const;
-        const boost::dynamic_bitset<>& getSrcIpPrefix() const;
+        boost::dynamic_bitset<> getSrcIpPrefix() const;
 
         std::string getDstIpRangeString() const;
         const IP_ADDRESS& getDstIpStart() const;
         const IP_ADDRESS& getDstIpStop() const;
-        const boost::dynamic_bitset<>& getDstIpPrefix() const;
+        boost::dynamic_bitset<> getDstIpPrefix() const;
 
         std::string getSrcPortRangeString() const;
         u_int16_t getSrcPortStart() const;
         u_int16_t getSrcPortStop() const;
-        const boost::dynamic_bitset<>& getSrcPortPrefix() const;
+        boost::dynamic_bitset<> getSrcPortPrefix() const;
         bool getSrcPortNeg() const;
 
         std::string getDstPortRangeString() const;
         u_int16_t getDstPortStart() const;
         u_int16_t getDstPortStop() const;
-        const boost::dynamic_bitset<>& getDstPortPrefix() const;
+        boost::dynamic_bitset<> getDstPortPrefix() const;
         bool getDstPortNeg() const;
 
         std::string getProtocolString() const;
         int getProtocol() const;
-        const boost::dynamic_bitset<>& getProtocolPrefix() const;
+        boost::dynamic_bitset<> getProtocolPrefix() const;
 
         std::string getActionString() const;
         int getAction() const;
@@ -145,7 +161,7 @@ class AclRule
         std::string getName() const;
 
         std::string getFieldString(int dimension) const throw(Exception);
-        const boost::dynamic_bitset<>& getFieldPrefix(int dimension) const throw(Exception);
+        const FIELD_PREFIX& getFieldPrefix(int dimension) const throw(Exception);
 
         /******** SET methods ********/
         void setSrcIP(u_int8_t startA, u_int8_t startB, u_int8_t startC, u_int8_t startD, u_int8_t stopA, u_int8_t stopB, u_int8_t stopC, u_int8_t stopD, bool compute_prefix = true);
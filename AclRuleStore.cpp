@@ -0,0 +1,121 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "AclRuleStore.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ */
+AclRuleStore::AclRuleStore() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+AclRuleStore::~AclRuleStore() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds fields of passed rule on the end of the store.
+ *
+ * @param rule reference to the rule, which fields are stored.
+ */
+void AclRuleStore::pushBack(const AclRule& rule)
+{
+    m_srcIpStart.push_back(ipToNumber(rule.getSrcIpStart()));
+    m_srcIpStop.push_back(ipToNumber(rule.getSrcIpStop()));
+    m_dstIpStart.push_back(ipToNumber(rule.getDstIpStart()));
+    m_dstIpStop.push_back(ipToNumber(rule.getDstIpStop()));
+
+    m_srcPortStart.push_back(rule.getSrcPortStart());
+    m_srcPortStop.push_back(rule.getSrcPortStop());
+    m_dstPortStart.push_back(rule.getDstPortStart());
+    m_dstPortStop.push_back(rule.getDstPortStop());
+
+    u_int8_t flags = 0;
+
+    if ( rule.getSrcPortNeg() )
+        flags |= FLAG_SRC_PORT_NEG;
+
+    if ( rule.getDstPortNeg() )
+        flags |= FLAG_DST_PORT_NEG;
+
+    int protocol = rule.getProtocol();
+
+    if ( protocol == PROTO_ANY )
+        flags |= FLAG_PROTO_ANY;
+    else if ( protocol == PROTO_IPv4 )
+        flags |= FLAG_PROTO_IPv4;
+
+    m_protocol.push_back((protocol < 0) ? 0 : protocol);
+    m_action.push_back(rule.getAction());
+    m_flags.push_back(flags);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method reserves the memory of all arrays for passed number of rules.
+ *
+ * @param numOfRules expected number of rules in the store.
+ */
+void AclRuleStore::reserve(size_t numOfRules)
+{
+    m_srcIpStart.reserve(numOfRules);
+    m_srcIpStop.reserve(numOfRules);
+    m_dstIpStart.reserve(numOfRules);
+    m_dstIpStop.reserve(numOfRules);
+    m_srcPortStart.reserve(numOfRules);
+    m_srcPortStop.reserve(numOfRules);
+    m_dstPortStart.reserve(numOfRules);
+    m_dstPortStop.reserve(numOfRules);
+    m_protocol.reserve(numOfRules);
+    m_action.reserve(numOfRules);
+    m_flags.reserve(numOfRules);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of rules in the store.
+ *
+ * @return number of rules in the store.
+ */
+size_t AclRuleStore::size() const
+{
+    return m_flags.size();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method converts passed IPv4 address to 32bit number.
+ *
+ * Numbers keep the order of addresses, so ranges of addresses can be compared as numbers.
+ *
+ * @param address reference to structure IP_ADDRESS containing the address.
+ * @return number representing the address (A is the most significant byte).
+ */
+u_int32_t AclRuleStore::ipToNumber(const IP_ADDRESS& address)
+{
+    return ((u_int32_t) address.A << 24) | ((u_int32_t) address.B << 16) | ((u_int32_t) address.C << 8) | (u_int32_t) address.D;
+}
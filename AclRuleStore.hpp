@@ -0,0 +1,99 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <vector>
+#include <sys/types.h>
+
+#include "AclRule.hpp"
+
+#ifndef ACL_RULE_STORE_HPP__4827163504918273645019283746501928374650192837
+#define ACL_RULE_STORE_HPP__4827163504918273645019283746501928374650192837
+
+/**
+ * Class AclRuleStore represents fields of ACL rules needed by the classification of conflicts.
+ *
+ * Fields are stored in parallel arrays (one array per field) indexed by the position of the rule,
+ * so the classification of many pairs of rules reads only a few compact arrays and does not
+ * touch objects AclRule with their prefixes, names and strings. IPv4 addresses are stored as
+ * 32bit numbers (A is the most significant byte), ports as 16bit numbers and the protocol,
+ * the action and flags as bytes. Protocols "any" and "ip", which do not have a number,
+ * are stored as flags.
+ */
+class AclRuleStore
+{
+    private:
+        std::vector< u_int32_t > m_srcIpStart;          /** Start addresses of source address ranges. */
+        std::vector< u_int32_t > m_srcIpStop;           /** End addresses of source address ranges. */
+        std::vector< u_int32_t > m_dstIpStart;          /** Start addresses of destination address ranges. */
+        std::vector< u_int32_t > m_dstIpStop;           /** End addresses of destination address ranges. */
+        std::vector< u_int16_t > m_srcPortStart;        /** Start ports of source port ranges. */
+        std::vector< u_int16_t > m_srcPortStop;         /** End ports of source port ranges. */
+        std::vector< u_int16_t > m_dstPortStart;        /** Start ports of destination port ranges. */
+        std::vector< u_int16_t > m_dstPortStop;         /** End ports of destination port ranges. */
+        std::vector< u_int8_t > m_protocol;             /** Protocol numbers (0 for protocols "any" and "ip"). */
+        std::vector< u_int8_t > m_action;               /** Rule actions (ACTION_XXX). */
+        std::vector< u_int8_t > m_flags;                /** Flags of rules (FLAG_XXX). */
+
+    public:
+        static const u_int8_t FLAG_SRC_PORT_NEG = 0x01;     /** Source port range is negated. */
+        static const u_int8_t FLAG_DST_PORT_NEG = 0x02;     /** Destination port range is negated. */
+        static const u_int8_t FLAG_PROTO_ANY = 0x04;        /** Protocol is PROTO_ANY. */
+        static const u_int8_t FLAG_PROTO_IPv4 = 0x08;       /** Protocol is PROTO_IPv4. */
+
+        AclRuleStore();
+        virtual ~AclRuleStore();
+
+        void pushBack(const AclRule& rule);
+        void reserve(size_t numOfRules);
+        size_t size() const;
+
+        static u_int32_t ipToNumber(const IP_ADDRESS& address);
+
+        u_int32_t srcIpStart(size_t n) const { return m_srcIpStart[n]; }
+        u_int32_t srcIpStop(size_t n) const { return m_srcIpStop[n]; }
+        u_int32_t dstIpStart(size_t n) const { return m_dstIpStart[n]; }
+        u_int32_t dstIpStop(size_t n) const { return m_dstIpStop[n]; }
+        u_int16_t srcPortStart(size_t n) const { return m_srcPortStart[n]; }
+        u_int16_t srcPortStop(size_t n) const { return m_srcPortStop[n]; }
+        u_int16_t dstPortStart(size_t n) const { return m_dstPortStart[n]; }
+        u_int16_t dstPortStop(size_t n) const { return m_dstPortStop[n]; }
+        bool srcPortNeg(size_t n) const { return (m_flags[n] & FLAG_SRC_PORT_NEG) != 0; }
+        bool dstPortNeg(size_t n) const { return (m_flags[n] & FLAG_DST_PORT_NEG) != 0; }
+        int action(size_t n) const { return m_action[n]; }
+        u_int8_t protocolNumber(size_t n) const { return m_protocol[n]; }
+        u_int8_t flags(size_t n) const { return m_flags[n]; }
+
+        /**
+         * Method returns the protocol of the rule in the form used by AclRule (constant PROTO_XXX).
+         *
+         * @param n position of the rule.
+         * @return protocol number, PROTO_ANY or PROTO_IPv4.
+         */
+        int protocol(size_t n) const
+        {
+            if ( m_flags[n] & FLAG_PROTO_ANY )
+                return PROTO_ANY;
+
+            if ( m_flags[n] & FLAG_PROTO_IPv4 )
+                return PROTO_IPv4;
+
+            return m_protocol[n];
+        }
+};
+
+#endif /* ACL_RULE_STORE_HPP__4827163504918273645019283746501928374650192837 */
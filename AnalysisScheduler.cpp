@@ -0,0 +1,363 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <new>
+
+#include "AnalysisScheduler.hpp"
+#include "GlobalDefs.hpp"
+
+using namespace std;
+
+/**
+ * Functor ordering indexes of ACLs from the largest ACL to the smallest one.
+ */
+class AclSizeGreater
+{
+    private:
+        const boost::ptr_vector< AccessControlList >& m_acls;
+
+    public:
+        AclSizeGreater(const boost::ptr_vector< AccessControlList >& acls) : m_acls(acls) { }
+
+        bool operator()(size_t a, size_t b) const
+        {
+            if ( m_acls[a].size() != m_acls[b].size() )
+                return m_acls[a].size() > m_acls[b].size();
+
+            return a < b;
+        }
+};
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class constructor.
+ *
+ * Constructor distributes ACLs to queues of workers. ACLs are sorted from the largest one
+ * and dealt to the queues one by one, so every worker starts with the largest available ACL.
+ *
+ * @param acls reference to the vector of ACLs to analyse.
+ * @param numOfWorkers number of worker threads. If zero is passed, one worker is used. More workers
+ *                     than ACLs are never started, because one ACL is analysed by one worker.
+ * @param insertionMode mode of inserting rules into prefix trees used by analyzers.
+ * @param bitVectorType class of bit vectors used by prefix trees of analyzers.
+ * @param indexType structure used for dimensions of prefix forests of analyzers.
+ */
+AnalysisScheduler::AnalysisScheduler(const boost::ptr_vector< AccessControlList >& acls, unsigned numOfWorkers, int insertionMode,
+                                     int bitVectorType, int indexType) : m_acls(acls),
+                                     m_numOfWorkers(workersFor(numOfWorkers, acls.size())),
+                                     m_insertionMode(insertionMode),
+                                     m_bitVectorType(bitVectorType),
+                                     m_indexType(indexType),
+                                     m_outputWriter(NULL),
+                                     m_verbose(false),
+                                     m_queues(m_numOfWorkers),
+                                     m_results(acls.size(), (AclAnalyzer*) NULL),
+                                     m_finished(acls.size(), false),
+                                     m_errors(acls.size()),
+                                     m_nextToWrite(0)
+{
+    pthread_mutex_init(&m_resultsLock, NULL);
+    pthread_cond_init(&m_resultsCond, NULL);
+
+    for ( unsigned i = 0; i < m_numOfWorkers; ++i )
+        pthread_mutex_init(&m_queues[i].m_lock, NULL);
+
+    vector< size_t > order(acls.size());
+    for ( size_t i = 0; i < order.size(); ++i )
+        order[i] = i;
+
+    sort(order.begin(), order.end(), AclSizeGreater(acls));
+
+    for ( size_t i = 0; i < order.size(); ++i )
+        m_queues[i % m_numOfWorkers].m_tasks.push_back(order[i]);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of workers started for the requested number and the number of ACLs.
+ *
+ * @param numOfWorkers requested number of worker threads.
+ * @param numOfAcls number of ACLs to analyse.
+ * @return number of workers from interval <1, max(numOfAcls, 1)>.
+ */
+unsigned AnalysisScheduler::workersFor(unsigned numOfWorkers, size_t numOfAcls)
+{
+    if ( numOfWorkers > numOfAcls )
+        numOfWorkers = numOfAcls;
+
+    return (numOfWorkers > 0) ? numOfWorkers : 1;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+AnalysisScheduler::~AnalysisScheduler()
+{
+    for ( size_t i = 0; i < m_results.size(); ++i )
+        delete m_results[i];
+
+    for ( unsigned i = 0; i < m_numOfWorkers; ++i )
+        pthread_mutex_destroy(&m_queues[i].m_lock);
+
+    pthread_cond_destroy(&m_resultsCond);
+    pthread_mutex_destroy(&m_resultsLock);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method takes next ACL which should be analysed by the worker.
+ *
+ * Worker takes the ACL from the front of its own queue. If its queue is empty,
+ * it tries to steal an ACL from the back of queues of other workers.
+ *
+ * @param workerId index of the worker.
+ * @param aclIndex reference to variable where the index of taken ACL is stored.
+ * @return TRUE - if some ACL was taken.
+ *         FALSE - if there is no ACL left for the analysis.
+ */
+bool AnalysisScheduler::takeTask(unsigned workerId, size_t& aclIndex)
+{
+    WorkerQueue& own = m_queues[workerId];
+
+    pthread_mutex_lock(&own.m_lock);
+    if ( !own.m_tasks.empty() )
+    {
+        aclIndex = own.m_tasks.front();
+        own.m_tasks.pop_front();
+        pthread_mutex_unlock(&own.m_lock);
+        return true;
+    }
+    pthread_mutex_unlock(&own.m_lock);
+
+    /* own queue is empty -> steal from other workers */
+    for ( unsigned i = 1; i < m_numOfWorkers; ++i )
+    {
+        WorkerQueue& victim = m_queues[(workerId + i) % m_numOfWorkers];
+
+        pthread_mutex_lock(&victim.m_lock);
+        if ( !victim.m_tasks.empty() )
+        {
+            aclIndex = victim.m_tasks.back();
+            victim.m_tasks.pop_back();
+            pthread_mutex_unlock(&victim.m_lock);
+            return true;
+        }
+        pthread_mutex_unlock(&victim.m_lock);
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method finds out whether the ACL is the next one whose results should be written.
+ *
+ * Results of all preceding ACLs are already written in that case and the calling thread
+ * does not use the output writer until the analysis of the ACL is finished.
+ *
+ * @param aclIndex index of the ACL.
+ * @return TRUE - if the conflicts of the ACL can be written directly to the output writer.
+ *         FALSE - otherwise.
+ */
+bool AnalysisScheduler::isNextToWrite(size_t aclIndex)
+{
+    pthread_mutex_lock(&m_resultsLock);
+    bool next = (aclIndex == m_nextToWrite);
+    pthread_mutex_unlock(&m_resultsLock);
+
+    return next;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method writes the beginning of results of the ACL (and its rules in the verbose mode).
+ *
+ * @param aclIndex index of the ACL.
+ */
+void AnalysisScheduler::writeAclHeader(size_t aclIndex)
+{
+    if ( m_verbose )
+        cout << endl << m_acls[aclIndex] << endl;
+
+    m_outputWriter->writeNewACL(m_acls[aclIndex].name());
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores the result of finished ACL analysis and wakes up the writing thread.
+ *
+ * @param aclIndex index of the analysed ACL.
+ * @param analyzer pointer to the analyzer containing stored conflicts (NULL if the analysis failed
+ *                 or the conflicts were written directly).
+ * @param error error message if the analysis failed, empty string otherwise.
+ */
+void AnalysisScheduler::finishTask(size_t aclIndex, AclAnalyzer* analyzer, const std::string& error)
+{
+    pthread_mutex_lock(&m_resultsLock);
+    m_results[aclIndex] = analyzer;
+    m_errors[aclIndex] = error;
+    m_finished[aclIndex] = true;
+    pthread_cond_broadcast(&m_resultsCond);
+    pthread_mutex_unlock(&m_resultsLock);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method containing the main loop of the worker thread.
+ *
+ * If the taken ACL is the next one in the order of writing, its conflicts are written
+ * directly to the output writer. Otherwise they are stored in the analyzer.
+ *
+ * @param workerId index of the worker.
+ */
+void AnalysisScheduler::workerLoop(unsigned workerId)
+{
+    size_t aclIndex;
+
+    while ( takeTask(workerId, aclIndex) )
+    {
+        AclAnalyzer* analyzer = NULL;
+        string error;
+        bool direct = isNextToWrite(aclIndex);
+
+        try {
+            if ( direct )
+                writeAclHeader(aclIndex);
+
+            analyzer = new AclAnalyzer(m_acls[aclIndex], direct ? m_outputWriter : NULL, m_insertionMode, m_bitVectorType,
+                                       CLASSIFY_SHORT_CIRCUIT, m_indexType);
+            analyzer->analyse();
+        }
+        catch ( Exception& e )
+        {
+            error = e.getMessage();
+        }
+        catch ( std::bad_alloc& e )
+        {
+            error = "Not enough memory!";
+        }
+
+        if ( !error.empty() || direct )
+        {
+            delete analyzer;
+            analyzer = NULL;
+        }
+
+        finishTask(aclIndex, analyzer, error);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Entry function of the worker thread.
+ *
+ * @param args pointer to the structure WorkerArgs.
+ * @return always NULL.
+ */
+void* AnalysisScheduler::workerMain(void* args)
+{
+    WorkerArgs* workerArgs = (WorkerArgs*) args;
+    workerArgs->m_scheduler->workerLoop(workerArgs->m_workerId);
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method analyses all ACLs and writes results to the passed output writer.
+ *
+ * Method starts worker threads and writes results of the analysis in the order of ACLs
+ * as soon as they are available. Method returns after all ACLs are analysed and written.
+ * Only conflicts of ACLs finished out of order are stored until they can be written.
+ *
+ * @throw Exception if some worker can not be started or the analysis of some ACL failed.
+ *                  Results of ACLs preceding the failed one (and conflicts of the failed one
+ *                  written directly) are written before the exception is thrown.
+ * @param outputWriter reference to the output writer.
+ * @param verbose flag set if the rules of each ACL should be printed to the standard output.
+ */
+void AnalysisScheduler::run(OutputWriter& outputWriter, bool verbose) throw(Exception)
+{
+    vector< pthread_t > threads(m_numOfWorkers);
+    vector< WorkerArgs > args(m_numOfWorkers);
+    unsigned started = 0;
+
+    m_outputWriter = &outputWriter;
+    m_verbose = verbose;
+
+    for ( ; started < m_numOfWorkers; ++started )
+    {
+        args[started].m_scheduler = this;
+        args[started].m_workerId = started;
+
+        if ( pthread_create(&threads[started], NULL, AnalysisScheduler::workerMain, &args[started]) != 0 )
+            break;
+    }
+
+    /* no thread started -> analyse in this thread */
+    if ( started == 0 )
+        workerLoop(0);
+
+    string error;
+    size_t size = m_acls.size();
+
+    for ( size_t i = 0; (i < size) && error.empty(); ++i )
+    {
+        pthread_mutex_lock(&m_resultsLock);
+        while ( !m_finished[i] )
+            pthread_cond_wait(&m_resultsCond, &m_resultsLock);
+        AclAnalyzer* analyzer = m_results[i];
+        m_results[i] = NULL;
+        error = m_errors[i];
+        pthread_mutex_unlock(&m_resultsLock);
+
+        /* analyzer is NULL also if the conflicts were written directly by the worker */
+        if ( analyzer != NULL )
+        {
+            writeAclHeader(i);
+            analyzer->writeConflicts(outputWriter);
+            delete analyzer;
+        }
+
+        if ( error.empty() )
+        {
+            pthread_mutex_lock(&m_resultsLock);
+            m_nextToWrite = i + 1;
+            pthread_mutex_unlock(&m_resultsLock);
+        }
+    }
+
+    for ( unsigned i = 0; i < started; ++i )
+        pthread_join(threads[i], NULL);
+
+    if ( !error.empty() )
+        throw Exception(error);
+}
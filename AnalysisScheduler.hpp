@@ -0,0 +1,99 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <pthread.h>
+#include <deque>
+#include <vector>
+#include <string>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include "AccessControlList.hpp"
+#include "AclAnalyzer.hpp"
+#include "OutputWriter.hpp"
+#include "Exception.hpp"
+
+#ifndef ANALYSIS_SCHEDULER_HPP__9283746510293847561092837465019283746501928374
+#define ANALYSIS_SCHEDULER_HPP__9283746510293847561092837465019283746501928374
+
+/**
+ * Class AnalysisScheduler analyses more Access Control Lists concurrently.
+ *
+ * Scheduler starts a pool of worker threads, each of them analysing whole ACLs using
+ * the class AclAnalyzer. ACLs are distributed to queues of workers from the largest one.
+ * Worker takes ACLs from the front of its own queue and when its queue is empty, it steals
+ * ACLs from the back of queues of other workers. One large ACL therefore does not stall
+ * analysis of the other ACLs. Results are written to the output writer strictly in the original
+ * order of ACLs, so the output does not depend on number of workers. The worker analysing the ACL
+ * which is next in the order writes its conflicts directly, conflicts of other ACLs are stored
+ * by their analyzers and written by the calling thread when all preceding ACLs are written.
+ */
+class AnalysisScheduler
+{
+    private:
+        /**
+         * Structure representing the queue of ACLs (their indexes) assigned to one worker.
+         */
+        struct WorkerQueue
+        {
+            std::deque< size_t > m_tasks;       /** Indexes of ACLs waiting for the analysis. */
+            pthread_mutex_t m_lock;             /** Mutex protecting the queue. */
+        };
+
+        /**
+         * Structure passed to the worker thread.
+         */
+        struct WorkerArgs
+        {
+            AnalysisScheduler* m_scheduler;     /** Pointer to the scheduler which started the worker. */
+            unsigned m_workerId;                /** Index of the worker (and its queue). */
+        };
+
+        const boost::ptr_vector< AccessControlList >& m_acls;  /** Reference to the vector of ACLs to analyse. */
+        const unsigned m_numOfWorkers;                          /** Number of worker threads. */
+        const int m_insertionMode;                              /** Mode of inserting rules into prefix trees. */
+        const int m_bitVectorType;                              /** Class of bit vectors used by prefix trees. */
+        const int m_indexType;                                  /** Structure used for dimensions of prefix forests. */
+        OutputWriter* m_outputWriter;                           /** Pointer to the output writer passed to run(). */
+        bool m_verbose;                                         /** Flag set if rules of ACLs are printed to the standard output. */
+
+        std::vector< WorkerQueue > m_queues;            /** Queues of ACLs, one per worker. */
+        std::vector< AclAnalyzer* > m_results;          /** Finished analyzers, indexed by ACL index. */
+        std::vector< bool > m_finished;                 /** Flags set if the ACL analysis is finished. */
+        std::vector< std::string > m_errors;            /** Error messages of failed analyses, indexed by ACL index. */
+        size_t m_nextToWrite;                           /** Index of the first ACL whose results are not written yet. */
+        pthread_mutex_t m_resultsLock;                  /** Mutex protecting results, flags and errors. */
+        pthread_cond_t m_resultsCond;                   /** Condition signalled when some analysis finishes. */
+
+    protected:
+        bool takeTask(unsigned workerId, size_t& aclIndex);
+        bool isNextToWrite(size_t aclIndex);
+        void writeAclHeader(size_t aclIndex);
+        void finishTask(size_t aclIndex, AclAnalyzer* analyzer, const std::string& error);
+        void workerLoop(unsigned workerId);
+        static void* workerMain(void* args);
+        static unsigned workersFor(unsigned numOfWorkers, size_t numOfAcls);
+
+    public:
+        AnalysisScheduler(const boost::ptr_vector< AccessControlList >& acls, unsigned numOfWorkers, int insertionMode = INSERTION_SEQUENTIAL,
+                          int bitVectorType = BITVECTOR_AUTO, int indexType = INDEX_BINARY_TRIE);
+        virtual ~AnalysisScheduler();
+
+        void run(OutputWriter& outputWriter, bool verbose = false) throw(Exception);
+};
+
+#endif /* ANALYSIS_SCHEDULER_HPP__9283746510293847561092837465019283746501928374 */
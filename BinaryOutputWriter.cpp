@@ -0,0 +1,444 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include "BinaryOutputWriter.hpp"
+#include "AclRuleStore.hpp"
+
+using namespace std;
+
+const char BinaryOutputWriter::REPORT_MAGIC[8] = { 'A', 'C', 'L', 'C', 'H', 'E', 'C', 'K' };
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Function reads passed number of bytes from the report.
+ *
+ * @throw Exception if the report ends before all bytes are read.
+ * @param input reference to the input stream with the report.
+ * @param buffer pointer to the memory where read bytes are stored.
+ * @param size number of bytes.
+ */
+static void readBytes(istream& input, char* buffer, size_t size) throw(Exception)
+{
+    if ( !input.read(buffer, size) )
+        throw Exception("Unexpected end of the binary report!");
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Function reads little-endian unsigned number of passed size from the report.
+ *
+ * @throw Exception if the report ends before the number is read.
+ * @param input reference to the input stream with the report.
+ * @param size number of bytes of the number (1, 2 or 4).
+ * @return read number.
+ */
+static u_int32_t readNumber(istream& input, size_t size) throw(Exception)
+{
+    unsigned char bytes[4];
+    u_int32_t value = 0;
+
+    readBytes(input, (char*) bytes, size);
+
+    for ( size_t i = size; i > 0; --i )
+        value = (value << 8) | bytes[i - 1];
+
+    return value;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Function reads the string stored with its length from the report.
+ *
+ * @throw Exception if the stored length exceeds the rest of the report, or the report ends before the string is read.
+ * @param input reference to the input stream with the report.
+ * @param end position of the end of the report, -1 if the stream is not seekable.
+ * @return read string.
+ */
+static string readString(istream& input, streampos end) throw(Exception)
+{
+    u_int32_t length = readNumber(input, 4);
+
+    if ( end != streampos(-1) )
+    {
+        streampos position = input.tellg();
+        if ( (position == streampos(-1)) || ((streamoff) length > (end - position)) )
+            throw Exception("String exceeds the end of the binary report!");
+    }
+
+    string value(length, '\0');
+
+    if ( length > 0 )
+        readBytes(input, &value[0], length);
+
+    return value;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Function finds the position of the end of the report.
+ *
+ * @param input reference to the input stream with the report.
+ * @return position of the end of the report, -1 if the stream is not seekable.
+ */
+static streampos reportEnd(istream& input)
+{
+    streampos position = input.tellg();
+    if ( position == streampos(-1) )
+        return position;
+
+    input.seekg(0, ios::end);
+    streampos end = input.tellg();
+    input.seekg(position);
+
+    if ( !input )
+    {
+        input.clear();
+        return streampos(-1);
+    }
+
+    return end;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Function converts the numerical form of IPv4 address to the structure IP_ADDRESS.
+ *
+ * @param number IPv4 address in the numerical form (see AclRuleStore::ipToNumber()).
+ * @return structure with the address.
+ */
+static IP_ADDRESS numberToIp(u_int32_t number)
+{
+    IP_ADDRESS address;
+
+    address.A = number >> 24;
+    address.B = number >> 16;
+    address.C = number >> 8;
+    address.D = number;
+
+    return address;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class constructor.
+ *
+ * The header of the report is written to the buffer immediately.
+ *
+ * @param outputStream reference to the output stream to which the report will be written.
+ */
+BinaryOutputWriter::BinaryOutputWriter(std::ostream& outputStream) : OutputWriter(outputStream, OUTPUT_DETAIL_4),
+                                                                     m_numOfRules(0),
+                                                                     m_aclOpened(false),
+                                                                     m_finished(false)
+{
+    m_buffer.reserve(BUFFER_SIZE + 4096);
+
+    m_buffer.append(REPORT_MAGIC, sizeof(REPORT_MAGIC));
+    appendU8(REPORT_VERSION);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+BinaryOutputWriter::~BinaryOutputWriter() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method appends one byte to the buffer.
+ *
+ * @param value appended value.
+ */
+void BinaryOutputWriter::appendU8(u_int8_t value)
+{
+    m_buffer += (char) value;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method appends 16bit number to the buffer in little-endian order.
+ *
+ * @param value appended value.
+ */
+void BinaryOutputWriter::appendU16(u_int16_t value)
+{
+    m_buffer += (char) value;
+    m_buffer += (char) (value >> 8);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method appends 32bit number to the buffer in little-endian order.
+ *
+ * @param value appended value.
+ */
+void BinaryOutputWriter::appendU32(u_int32_t value)
+{
+    m_buffer += (char) value;
+    m_buffer += (char) (value >> 8);
+    m_buffer += (char) (value >> 16);
+    m_buffer += (char) (value >> 24);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method appends the string with its length to the buffer.
+ *
+ * @param value reference to the appended string.
+ */
+void BinaryOutputWriter::appendString(const std::string& value)
+{
+    appendU32(value.size());
+    m_buffer += value;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of passed rule in the actual ACL.
+ *
+ * If the rule was not written yet, its record is appended to the buffer.
+ *
+ * @param rule reference to the rule.
+ * @return number of the rule used by records of conflicts.
+ */
+u_int32_t BinaryOutputWriter::appendRule(const AclRule& rule)
+{
+    unsigned position = rule.getPosition();
+
+    if ( position >= m_ruleNumbers.size() )
+        m_ruleNumbers.resize(position + 1, 0);
+
+    if ( m_ruleNumbers[position] != 0 )
+        return m_ruleNumbers[position] - 1;
+
+    m_buffer += RECORD_RULE;
+    appendString(rule.getName());
+    appendU32((u_int32_t) rule.getProtocol());
+    appendU32(AclRuleStore::ipToNumber(rule.getSrcIpStart()));
+    appendU32(AclRuleStore::ipToNumber(rule.getSrcIpStop()));
+    appendU32(AclRuleStore::ipToNumber(rule.getDstIpStart()));
+    appendU32(AclRuleStore::ipToNumber(rule.getDstIpStop()));
+    appendU16(rule.getSrcPortStart());
+    appendU16(rule.getSrcPortStop());
+    appendU16(rule.getDstPortStart());
+    appendU16(rule.getDstPortStop());
+    appendU8((rule.getSrcPortNeg() ? RULE_FLAG_SRC_PORT_NEG : 0) | (rule.getDstPortNeg() ? RULE_FLAG_DST_PORT_NEG : 0));
+    appendU8(rule.getAction());
+
+    m_ruleNumbers[position] = ++m_numOfRules;
+
+    return m_numOfRules - 1;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method writes the content of the buffer to the output stream and clears the buffer.
+ */
+void BinaryOutputWriter::writeBuffer()
+{
+    m_outStream.write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method for writing a new ACL with given name (ID).
+ *
+ * The following new conflicts belong to the new ACL and the table of its rules is empty.
+ *
+ * @param aclID reference to a string containing name (ID) of the ACL.
+ */
+void BinaryOutputWriter::writeNewACL(std::string aclID)
+{
+    if ( m_finished )
+        return;
+
+    m_buffer += RECORD_ACL;
+    appendString(aclID);
+
+    m_ruleNumbers.assign(m_ruleNumbers.size(), 0);
+    m_numOfRules = 0;
+    m_aclOpened = true;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method for writing new conflict under the actual ACL.
+ *
+ * Records of rules of the conflict are written before the conflict, if they were not
+ * written for the actual ACL yet.
+ *
+ * @param confl reference to the object containing conflict data.
+ */
+void BinaryOutputWriter::writeNewConflict(const Conflict& confl)
+{
+    if ( m_finished )
+        return;
+
+    if ( !m_aclOpened )
+        writeNewACL("no-id");
+
+    u_int32_t ruleX = appendRule(confl.getRuleXRef());
+    u_int32_t ruleY = appendRule(confl.getRuleYRef());
+
+    m_buffer += RECORD_CONFLICT;
+    appendU32(ruleX);
+    appendU32(ruleY);
+    appendU8(confl.conflictType());
+
+    for ( int d = DIMENSION_MIN; d <= DIMENSION_MAX; ++d )
+        appendU8(confl.getDimensionsRelation(d));
+
+    if ( m_buffer.size() >= BUFFER_SIZE )
+        writeBuffer();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method finishes the report and writes the rest of it to the output stream given in constructor.
+ *
+ * Conflicts written after the report is finished are ignored.
+ */
+void BinaryOutputWriter::flush()
+{
+    if ( !m_finished )
+    {
+        m_buffer += RECORD_END;
+        m_finished = true;
+    }
+
+    writeBuffer();
+    m_outStream.flush();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method converts the binary report to passed output writer.
+ *
+ * ACLs and conflicts of the report are written to the output writer in the original order,
+ * so e.g. XmlStreamOutputWriter produces the same document as if it was used by the analysis.
+ * The output writer is not flushed.
+ *
+ * @throw Exception if the report is not a valid binary report (e.g. it contains unknown type of conflict
+ *                  or relation of dimensions, or string longer than the rest of the report).
+ * @param input reference to the input stream with the binary report.
+ * @param outputWriter reference to the output writer.
+ */
+void BinaryOutputWriter::convert(std::istream& input, OutputWriter& outputWriter) throw(Exception)
+{
+    char magic[sizeof(REPORT_MAGIC)];
+    boost::ptr_vector< AclRule > rules;
+    streampos end = reportEnd(input);
+
+    readBytes(input, magic, sizeof(magic));
+    if ( (string(magic, sizeof(magic)) != string(REPORT_MAGIC, sizeof(REPORT_MAGIC))) || (readNumber(input, 1) != REPORT_VERSION) )
+        throw Exception("Input is not a binary report of supported version!");
+
+    while ( true )
+    {
+        char record;
+        readBytes(input, &record, 1);
+
+        switch ( record )
+        {
+            case RECORD_ACL:
+            {
+                rules.clear();
+                outputWriter.writeNewACL(readString(input, end));
+                break;
+            }
+
+            case RECORD_RULE:
+            {
+                auto_ptr< AclRule > rule(new AclRule(rules.size(), readString(input, end)));
+
+                int protocol = (int32_t) readNumber(input, 4);
+                IP_ADDRESS srcIpStart = numberToIp(readNumber(input, 4));
+                IP_ADDRESS srcIpStop = numberToIp(readNumber(input, 4));
+                IP_ADDRESS dstIpStart = numberToIp(readNumber(input, 4));
+                IP_ADDRESS dstIpStop = numberToIp(readNumber(input, 4));
+                u_int16_t srcPortStart = readNumber(input, 2);
+                u_int16_t srcPortStop = readNumber(input, 2);
+                u_int16_t dstPortStart = readNumber(input, 2);
+                u_int16_t dstPortStop = readNumber(input, 2);
+                u_int8_t flags = readNumber(input, 1);
+                int action = readNumber(input, 1);
+
+                if ( (rule->setProtocol(protocol) != 0) || (rule->setAction(action) != 0) )
+                    throw Exception("Invalid rule in the binary report!");
+
+                rule->setSrcIP(srcIpStart, srcIpStop);
+                rule->setDstIP(dstIpStart, dstIpStop);
+                rule->setSrcPort(srcPortStart, srcPortStop, (flags & RULE_FLAG_SRC_PORT_NEG) != 0);
+                rule->setDstPort(dstPortStart, dstPortStop, (flags & RULE_FLAG_DST_PORT_NEG) != 0);
+
+                rules.push_back(rule.release());
+                break;
+            }
+
+            case RECORD_CONFLICT:
+            {
+                u_int32_t ruleX = readNumber(input, 4);
+                u_int32_t ruleY = readNumber(input, 4);
+                CONFLICT_RESULT result;
+
+                result.conflictType = readNumber(input, 1);
+                if ( (result.conflictType < CONFLICT_REDUNDANCY) || (result.conflictType > CONFLICT_CORELATION) )
+                    throw Exception("Unknown type of conflict in the binary report!");
+
+                for ( int d = DIMENSION_MIN; d <= DIMENSION_MAX; ++d )
+                {
+                    result.dimensionsRelation[d] = readNumber(input, 1);
+                    if ( result.dimensionsRelation[d] > RELATION_1_SMALLER_2 )
+                        throw Exception("Unknown relation of dimensions in the binary report!");
+                }
+
+                if ( (ruleX >= rules.size()) || (ruleY >= rules.size()) )
+                    throw Exception("Conflict refers to unknown rule in the binary report!");
+
+                outputWriter.writeNewConflict(Conflict(rules[ruleX], rules[ruleY], result));
+                break;
+            }
+
+            case RECORD_END:
+                return;
+
+            default:
+                throw Exception("Invalid record in the binary report!");
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "OutputWriter.hpp"
+#include "Exception.hpp"
+
+#ifndef BINARY_OUTPUTWRITER_HPP__1937461028374650192837465019283746510293847561
+#define BINARY_OUTPUTWRITER_HPP__1937461028374650192837465019283746510293847561
+
+/**
+ * Class BinaryOutputWriter writes the compact binary report of the analysis.
+ *
+ * Report always contains all data of conflicts (as OUTPUT_DETAIL_4), the detail level is
+ * chosen when the report is converted to XML by convert(). Report starts with REPORT_MAGIC
+ * followed by the version byte and it is a sequence of records starting with a tag byte.
+ * All numbers are little-endian:
+ *
+ * RECORD_ACL      - u32 length, ID of the ACL. Following records belong to this ACL.
+ * RECORD_RULE     - u32 length, name, i32 protocol, u32 source IP start, stop, u32 destination
+ *                   IP start, stop, u16 source port start, stop, u16 destination port start, stop,
+ *                   u8 flags (RULE_FLAG_XXX), u8 action. Rules of the ACL are numbered from 0
+ *                   in the order of their records, every rule is written once, before the first
+ *                   conflict which refers to it.
+ * RECORD_CONFLICT - u32 number of rule X, u32 number of rule Y, u8 conflict type,
+ *                   u8 relations of dimensions DIMENSION_MIN ... DIMENSION_MAX.
+ * RECORD_END      - end of the report, written by flush().
+ */
+class BinaryOutputWriter : public OutputWriter
+{
+    public:
+        static const char REPORT_MAGIC[8];              /** Bytes at the beginning of the report. */
+        static const u_int8_t REPORT_VERSION = 1;       /** Version of the format of the report. */
+
+        static const char RECORD_ACL = 'A';
+        static const char RECORD_RULE = 'R';
+        static const char RECORD_CONFLICT = 'C';
+        static const char RECORD_END = 'E';
+
+        static const u_int8_t RULE_FLAG_SRC_PORT_NEG = 1;   /** Source port range is negated. */
+        static const u_int8_t RULE_FLAG_DST_PORT_NEG = 2;   /** Destination port range is negated. */
+
+    private:
+        static const size_t BUFFER_SIZE = 64 * 1024;   /** Size of the buffer after which it is written to the stream. */
+
+        std::string m_buffer;                   /** Buffer with records not written to the stream yet. */
+        std::vector< u_int32_t > m_ruleNumbers; /** Number of written rule + 1 indexed by the rule position, 0 if not written. */
+        u_int32_t m_numOfRules;                 /** Number of rules written for the actual ACL. */
+        bool m_aclOpened;                       /** Flag set if a record of an ACL was written. */
+        bool m_finished;                        /** Flag set if the report was finished by flush(). */
+
+    protected:
+        void appendU8(u_int8_t value);
+        void appendU16(u_int16_t value);
+        void appendU32(u_int32_t value);
+        void appendString(const std::string& value);
+        u_int32_t appendRule(const AclRule& rule);
+        void writeBuffer();
+
+    public:
+        BinaryOutputWriter(std::ostream& outputStream);
+        virtual ~BinaryOutputWriter();
+
+        virtual void writeNewACL(std::string aclID);
+        virtual void writeNewConflict(const Conflict& confl);
+        virtual void flush();
+
+        static void convert(std::istream& input, OutputWriter& outputWriter) throw(Exception);
+};
+
+#endif /* BINARY_OUTPUTWRITER_HPP__1937461028374650192837465019283746510293847561 */
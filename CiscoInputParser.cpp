@@ -22,10 +22,43 @@
 #include <algorithm>
 
 #include "CiscoInputParser.hpp"
+#include "LineScanner.hpp"
 #include "PortsDef.hpp"
+#include "ProtocolsDef.hpp"
 
 using namespace std;
 
+/**
+ * First words of commands recognized by parseCommand().
+ */
+static const KEYWORD COMMAND_KEYWORDS[] =
+{
+    { "access-list", CMD_ACCESS_LIST },
+    { "ip", CMD_IP_ACCESS_LIST },
+    { "permit", CMD_IP_ACCESS_LIST_RULE },
+    { "deny", CMD_IP_ACCESS_LIST_RULE },
+    { "remark", CMD_ACL_RULE_REMARK }
+};
+
+/**
+ * Operators of port definitions recognized by parsePort().
+ */
+static const KEYWORD PORT_OPERATOR_KEYWORDS[] =
+{
+    { "eq", PORT_OP_EQ },
+    { "neq", PORT_OP_NEQ },
+    { "lt", PORT_OP_LT },
+    { "gt", PORT_OP_GT },
+    { "range", PORT_OP_RANGE }
+};
+
+const KeywordTable CiscoInputParser::COMMAND_TABLE(COMMAND_KEYWORDS, sizeof(COMMAND_KEYWORDS) / sizeof(COMMAND_KEYWORDS[0]));
+const KeywordTable CiscoInputParser::PROTOCOL_TABLE(PROTO_KEYWORDS, PROTO_KEYWORDS_COUNT);
+const KeywordTable CiscoInputParser::PORT_TABLE(PORT_KEYWORDS, PORT_KEYWORDS_COUNT);
+const KeywordTable CiscoInputParser::PORT_OPERATOR_TABLE(PORT_OPERATOR_KEYWORDS, sizeof(PORT_OPERATOR_KEYWORDS) / sizeof(PORT_OPERATOR_KEYWORDS[0]));
+
+//--------------------------------------------------------------------------------
+
 /**
  * Method for getting pointer to an ACL with entered name (ID).
  *
@@ -118,40 +151,27 @@ AccessControlList* CiscoInputParser::createNewAcl(const std::string& name)
  */
 int CiscoInputParser::parseCommand(const char* str, unsigned& charsExtracted)
 {
-    switch ( str[0] )
-    {
-        case 'a':
-            if ( strncmp(str, "access-list", 11) == 0 )
-            {
-                charsExtracted = 12;
-                return CMD_ACCESS_LIST;
-            }
-
-        case 'i':
-            if ( strncmp(str, "ip access-list", 14) == 0 )
-            {
-                charsExtracted = 15;
-                return CMD_IP_ACCESS_LIST;
-            }
+    unsigned length = KeywordTable::tokenLength(str);
+    int cmd;
 
-        case 'p':
-        case 'd':
-            if ( (strncmp(str, "permit", 6) == 0) || (strncmp(str, "deny", 4) == 0) )
-            {
-                charsExtracted = 1;
-                return CMD_IP_ACCESS_LIST_RULE;
-            }
-
-        case 'r':
-            if ( strncmp(str, "remark", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return CMD_ACL_RULE_REMARK;
-            }
+    if ( !COMMAND_TABLE.find(str, length, cmd) )
+    {
+        return CMD_MISC;
+    }
 
-        default:
+    /* "ip" has to be followed by "access-list" */
+    if ( cmd == CMD_IP_ACCESS_LIST )
+    {
+        if ( strncmp(str + length, " access-list", 12) != 0 )
+        {
             return CMD_MISC;
+        }
+
+        length += 12;
     }
+
+    charsExtracted = tokenExtent(str, length);
+    return cmd;
 }
 
 //--------------------------------------------------------------------------------
@@ -196,7 +216,10 @@ int CiscoInputParser::parseAction(const char* str, unsigned& charsExtracted)
  * Method parses communication protocol from passed string. String has
  * to begin with the protocol! Method also stores to variable 
  * charsExtracted number of characters extracted by parsing the protocol.
+ * Names of protocols are looked up in PROTOCOL_TABLE, other words are
+ * parsed as the protocol number.
  *
+ * @throw Exception if the protocol is neither known name nor protocol number.
  * @param str pointer to string beginning with a protocol.
  * @param charsExtracted reference to variable where the number of extracted characters will be stored.
  * @return PROTO_XXX - value representing known protocol.
@@ -204,91 +227,16 @@ int CiscoInputParser::parseAction(const char* str, unsigned& charsExtracted)
  */
 int CiscoInputParser::parseProtocol(const char* str, unsigned& charsExtracted)
 {
-    switch ( str[0] )
-    {
-        case 'a':
-            /* protocol "ahp" */
-            charsExtracted = 4;
-            return PROTO_AH;
-
-        case 'g':
-            /*  protocol "gre" */
-            charsExtracted = 4;
-            return PROTO_GRE;
-
-        case 'n':
-            /* protocol "nos" - old name for protocol number "4" */
-            charsExtracted = 4;
-            return PROTO_IP_IN_IP;
-
-        case 'o':
-            /* protocol "ospf" */
-            charsExtracted = 5;
-            return PROTO_OSPF;
-
-        case 'p':
-            /* protocol "pim" */
-            charsExtracted = 4;
-            return PROTO_PIM;
-
-        case 't':
-            /* protocol "tcp" */
-            charsExtracted = 4;
-            return PROTO_TCP;
-
-        case 'u':
-            /* protocol "udp" */
-            charsExtracted = 4;
-            return PROTO_UDP;
-
-        case 'e':
-            /* protocols "esp" and "eigrp" */
-            switch ( str[1] )
-            {
-                case 's':
-                    /* protocol "esp" */
-                    charsExtracted = 4;
-                    return PROTO_ESP;
-
-                default:
-                    /* protocol "eigrp" */
-                    charsExtracted = 6;
-                    return PROTO_EIGRP;
-            }
+    unsigned length = KeywordTable::tokenLength(str);
+    int protocol;
 
-        case 'i':
-            /* protocols "icmp", "igmp", "ipinip" and "ip" */
-            switch ( str[1] )
-            {
-                case 'c':
-                    /* protocol "icmp" */
-                    charsExtracted = 5;
-                    return PROTO_ICMPv4;
-
-                case 'g':
-                    /* protocol "igmp" */
-                    charsExtracted = 5;
-                    return PROTO_IGMP;
-
-                default:
-                    /* protocols "ipinip" and "ip" */
-                    switch ( str [2])
-                    {
-                        case 'i':
-                            /* protocol "ipinip" */
-                            charsExtracted = 7;
-                            return PROTO_IP_IN_IP;
-
-                        default:
-                            /* protocol "ip" */
-                            charsExtracted = 3;
-                            return PROTO_IPv4;
-                    }
-            }
-
-        default:
-            return parseProtocolByNum(str, charsExtracted);
+    if ( PROTOCOL_TABLE.find(str, length, protocol) )
+    {
+        charsExtracted = tokenExtent(str, length);
+        return protocol;
     }
+
+    return parseProtocolByNum(str, charsExtracted);
 }
 
 //--------------------------------------------------------------------------------
@@ -301,20 +249,21 @@ int CiscoInputParser::parseProtocol(const char* str, unsigned& charsExtracted)
  * to variable charsExtracted number of characters extracted by 
  * parsing the protocol number.
  *
+ * @throw Exception if the string doesn't begin with a number from 0 to 255.
  * @param str pointer to string beginning with a protocol number.
  * @param charsExtracted reference to variable where the number of extracted characters will be stored.
  * @return value representing communication protocol (value from 0 to 255).
  */
 int CiscoInputParser::parseProtocolByNum(const char* str, unsigned& charsExtracted)
 {
-    char buffer[8];
-    stringstream ss;
-    ss.str(str);
-    ss.getline(buffer, 8, ' ');
+    unsigned length = KeywordTable::tokenLength(str);
 
-    charsExtracted = (unsigned) ss.gcount();
+    if ( !isNumber(str, length) || (parseNumber(str) > (unsigned long) PROTO__MAX) )
+        throw Exception("Unknown protocol \"" + string(str, length) + "\" in ACL rule definition!");
 
-    return atoi(buffer);
+    charsExtracted = tokenExtent(str, length);
+
+    return (int) parseNumber(str);
 }
 
 //--------------------------------------------------------------------------------
@@ -325,7 +274,10 @@ int CiscoInputParser::parseProtocolByNum(const char* str, unsigned& charsExtract
  * Method parses start and end port number of a port range from passed string.
  * String has to begin with the port range! Method also stores to variable
  * charsExtracted number of characters extracted by parsing the port numbers.
+ * The operator is looked up as a whole word in PORT_OPERATOR_TABLE, any other
+ * word (e.g. "log" or "established") means there is no port range.
  *
+ * @throw Exception if the port after the operator is missing or unknown.
  * @param str pointer to string beginning with a definition of port range.
  * @param charsExtracted reference to variable where the number of extracted characters will be stored.
  * @param portStart reference to variable where the start port number will be stored.
@@ -336,79 +288,88 @@ int CiscoInputParser::parseProtocolByNum(const char* str, unsigned& charsExtract
  */
 int CiscoInputParser::parsePort(const char* str, unsigned& charsExtracted, u_int16_t& portStart, u_int16_t& portStop, bool& portNeg)
 {
+    unsigned length = KeywordTable::tokenLength(str);
+    int portOperator;
     u_int16_t tmp_portNumber;
-    unsigned tmp_chExtr = 0;
-    
-    
-    switch ( str[0] )
+
+    /* any other word (log, established, ...) is not a port definition */
+    if ( !PORT_OPERATOR_TABLE.find(str, length, portOperator) )
+    {
+        charsExtracted = 0;
+        return 0;
+    }
+
+    charsExtracted = tokenExtent(str, length);
+    tmp_portNumber = parsePortOperand(str, charsExtracted);
+
+    switch ( portOperator )
     {
         /* "lt" - less than */
-        case 'l':
-            charsExtracted = 3;
-            ( isdigit(*(str + charsExtracted)) ) ? tmp_portNumber = parsePortByNum(str + charsExtracted, tmp_chExtr) : tmp_portNumber = parsePortByName(str + charsExtracted, tmp_chExtr);
-            charsExtracted += tmp_chExtr;
-            
+        case PORT_OP_LT:
             portStart = 0x0000;
             ( tmp_portNumber == 0 ) ? portStop = 0x0000 : portStop = tmp_portNumber - 1;
             portNeg = false;
-
-            return 1;
+            break;
 
         /* "gt" - greather than */
-        case 'g':
-            charsExtracted = 3;
-            ( isdigit(*(str + charsExtracted)) ) ? tmp_portNumber = parsePortByNum(str + charsExtracted, tmp_chExtr) : tmp_portNumber = parsePortByName(str + charsExtracted, tmp_chExtr);
-            charsExtracted += tmp_chExtr;
-
+        case PORT_OP_GT:
             ( tmp_portNumber == 0xFFFF ) ? portStart = 0xFFFF : portStart = tmp_portNumber + 1;
             portStop = 0xFFFF;
             portNeg = false;
-            
-            return 1;
+            break;
 
         /* "eq" - equal */
-        case 'e':
-            charsExtracted = 3;
-            ( isdigit(*(str + charsExtracted)) ) ? tmp_portNumber = parsePortByNum(str + charsExtracted, tmp_chExtr) : tmp_portNumber = parsePortByName(str + charsExtracted, tmp_chExtr);
-            charsExtracted += tmp_chExtr;
-
+        case PORT_OP_EQ:
             portStart = portStop = tmp_portNumber;
             portNeg = false;
-            
-            return 1;
+            break;
 
         /* "neq" - not equal */
-        case 'n':
-            charsExtracted = 4;
-            ( isdigit(*(str + charsExtracted)) ) ? tmp_portNumber = parsePortByNum(str + charsExtracted, tmp_chExtr) : tmp_portNumber = parsePortByName(str + charsExtracted, tmp_chExtr);
-            charsExtracted += tmp_chExtr;
-
+        case PORT_OP_NEQ:
             portStart = portStop = tmp_portNumber;
             portNeg = true;
-            
-            return 1;
+            break;
 
         /* "range" - range */
-        case 'r':
-            charsExtracted = 6;
-            ( isdigit(*(str + charsExtracted)) ) ? tmp_portNumber = parsePortByNum(str + charsExtracted, tmp_chExtr) : tmp_portNumber = parsePortByName(str + charsExtracted, tmp_chExtr);
-            charsExtracted += tmp_chExtr;
-            
+        case PORT_OP_RANGE:
             portStart = tmp_portNumber;
+            portStop = parsePortOperand(str, charsExtracted);
+            portNeg = false;
+            break;
+    }
 
-            ( isdigit(*(str + charsExtracted)) ) ? tmp_portNumber = parsePortByNum(str + charsExtracted, tmp_chExtr) : tmp_portNumber = parsePortByName(str + charsExtracted, tmp_chExtr);
-            charsExtracted += tmp_chExtr;
+    return 1;
+}
 
-            portStop = tmp_portNumber;
-            
-            portNeg = false;
+//--------------------------------------------------------------------------------
 
-            return 1;
+/**
+ * Method for parsing one port operand of port definition.
+ *
+ * Method skips white characters at position charsExtracted of passed string,
+ * parses the port number or port name found there and moves charsExtracted
+ * behind it. It never moves beyond the end of the line.
+ *
+ * @throw Exception if there is no port or the port is unknown.
+ * @param str pointer to string containing the port definition.
+ * @param charsExtracted reference to position in the string which will be moved behind the parsed port.
+ * @return value representing the port number.
+ */
+u_int16_t CiscoInputParser::parsePortOperand(const char* str, unsigned& charsExtracted)
+{
+    unsigned tmp_chExtr;
+    u_int16_t tmp_portNumber;
 
-        default:
-            charsExtracted = 0;
-            return 0;
-    }
+    skipWhiteChars(str + charsExtracted, tmp_chExtr);
+    charsExtracted += tmp_chExtr;
+
+    if ( str[charsExtracted] == '\0' )
+        throw Exception("Missing port in ACL rule definition!");
+
+    ( isdigit(*(str + charsExtracted)) ) ? tmp_portNumber = parsePortByNum(str + charsExtracted, tmp_chExtr) : tmp_portNumber = parsePortByName(str + charsExtracted, tmp_chExtr);
+    charsExtracted += tmp_chExtr;
+
+    return tmp_portNumber;
 }
 
 //--------------------------------------------------------------------------------
@@ -421,20 +382,21 @@ int CiscoInputParser::parsePort(const char* str, unsigned& charsExtracted, u_int
  * to variable charsExtracted number of characters extracted by parsing
  * the port number.
  *
+ * @throw Exception if the string doesn't begin with a number from 0 to 65535.
  * @param str pointer to string beginning with a port number.
  * @param charsExtracted reference to variable where the number of extracted characters will be stored.
  * @return value representing port number.
  */
 u_int16_t CiscoInputParser::parsePortByNum(const char* str, unsigned& charsExtracted)
 {
-    char buffer[8];
-    stringstream ss;
-    ss.str(str);
-    ss.getline(buffer, 8, ' ');
+    unsigned length = KeywordTable::tokenLength(str);
+
+    if ( !isNumber(str, length) || (parseNumber(str) > 0xFFFF) )
+        throw Exception("Unknown port \"" + string(str, length) + "\" in ACL rule definition!");
 
-    charsExtracted = (unsigned) ss.gcount();
+    charsExtracted = tokenExtent(str, length);
 
-    return (u_int16_t)atoi(buffer);
+    return (u_int16_t) parseNumber(str);
 }
 
 //--------------------------------------------------------------------------------
@@ -443,338 +405,28 @@ u_int16_t CiscoInputParser::parsePortByNum(const char* str, unsigned& charsExtra
  * Method for parsing port number from port name contained in passed string.
  * 
  * Method parses port number from port name contained in passed string. 
- * String has to begin with the port name! Method also stores
- * to variable charsExtracted number of characters extracted by parsing
- * the port number.
+ * String has to begin with the port name! Method also stores to variable
+ * charsExtracted number of characters extracted by parsing the port number.
+ * Names of ports are looked up in PORT_TABLE, unknown names are parsed
+ * as the port number.
  *
+ * @throw Exception if the port is neither known name nor port number.
  * @param str pointer to string beginning with a port name.
  * @param charsExtracted reference to variable where the number of extracted characters will be stored.
  * @return value representing port name.
  */
 u_int16_t CiscoInputParser::parsePortByName(const char* str, unsigned& charsExtracted)
 {
-    switch ( str[0] )
-    {
-        case 'b':
-            if ( strncmp(str, "bgp", 3) == 0 )
-            {
-                charsExtracted = 4;
-                return PORT_BGP;
-            }
-            else if ( strncmp(str, "biff", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_BIFF;
-            }
-            else if ( strncmp(str, "bootpc", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_BOOTPC;
-            }
-            /* bootps */
-            else
-            {
-                charsExtracted = 7;
-                return PORT_BOOTPS;
-            }
-
-        case 'c':
-            if ( strncmp(str, "chargen", 7) == 0 )
-            {
-                charsExtracted = 8;
-                return PORT_CHARGEN;
-            }
-            else if ( strncmp(str, "comsat", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_BIFF;       /* port # same as comsat */
-            }
-            /* cmd */
-            else
-            {
-                charsExtracted = 4;
-                return PORT_CMD;
-            }
+    unsigned length = KeywordTable::tokenLength(str);
+    int port;
 
-        case 'd':
-            if ( strncmp(str, "daytime", 7) == 0 )
-            {
-                charsExtracted = 8;
-                return PORT_DAYTIME;
-            }
-            else if ( strncmp(str, "discard", 7) == 0 )
-            {
-                charsExtracted = 8;
-                return PORT_DISCARD;
-            }
-            else if ( strncmp(str, "dnsix", 5) == 0 )
-            {
-                charsExtracted = 6;
-                return PORT_DNSIX;
-            }
-            /* domain */
-            else
-            {
-                charsExtracted = 7;
-                return PORT_DOMAIN;
-            }
-
-        case 'e':
-            if ( strncmp(str, "echo", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_ECHO;
-            }
-            /* exec */
-            else
-            {
-                charsExtracted = 5;
-                return PORT_EXEC;
-            }
-
-        case 'f':
-            if ( strncmp(str, "finger", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_FINGER;
-            }
-            else if ( strncmp(str, "ftp", 3) == 0 )
-            {
-                charsExtracted = 4;
-                return PORT_FTP;
-            }
-            /* ftp-data */
-            else
-            {
-                charsExtracted = 9;
-                return PORT_FTP_DATA;
-            }
-
-        case 'g':
-            /* gopher */
-            charsExtracted = 7;
-            return PORT_GOPHER;
-
-        case 'h':
-            if ( strncmp(str, "http", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_WWW;
-            }
-            /* hostname */
-            else
-            {
-                charsExtracted = 9;
-                return PORT_HOSTNAME;
-            }
-
-        case 'i':
-            if ( strncmp(str, "ident", 5) == 0 )
-            {
-                charsExtracted = 6;
-                return PORT_IDENT;
-            }
-            else if ( strncmp(str, "irc", 3) == 0)
-            {
-                charsExtracted = 4;
-                return PORT_IRC;
-            }
-            /* isakmp */
-            else
-            {
-                charsExtracted = 7;
-                return PORT_ISAKMP;
-            }
-
-        case 'k':
-            if ( strncmp(str, "klogin", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_KLOGIN;
-            }
-            /* kshell */
-            else
-            {
-                charsExtracted = 7;
-                return PORT_KSHELL;
-            }
-
-        case 'l':
-            if ( strncmp(str, "login", 5) == 0 )
-            {
-                charsExtracted = 6;
-                return PORT_LOGIN;
-            }
-            /* lpd */
-            else
-            {
-                charsExtracted = 4;
-                return PORT_LPD;
-            }
-
-        case 'm':
-            /* mobile-ip */
-            charsExtracted = 10;
-            return PORT_MOBILE_IP;
-
-        case 'n':
-            if ( strncmp(str, "nameserver", 10) == 0 )
-            {
-                charsExtracted = 11;
-                return PORT_NAMESERVER;
-            }
-            else if ( strncmp(str, "netbios-dgm", 11) == 0 )
-            {
-                charsExtracted = 12;
-                return PORT_NETBIOS_DGM;
-            }
-            else if ( strncmp(str, "netbios-ns", 10) == 0 )
-            {
-                charsExtracted = 11;
-                return PORT_NETBIOS_NS;
-            }
-            else if ( strncmp(str, "netbios-ss", 10) == 0 )
-            {
-                charsExtracted = 11;
-                return PORT_NETBIOS_SS;
-            }
-            else if ( strncmp(str, "nntp", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_NNTP;
-            }
-            else if ( strncmp(str, "non500-isakmp", 13) == 0 )
-            {
-                charsExtracted = 14;
-                return PORT_NON500_ISAKMP;
-            }
-            /* ntp */
-            else
-            {
-                charsExtracted = 4;
-                return PORT_NTP;
-            }
-
-        case 'p':
-            if ( strncmp(str, "pim-auto-rp", 11) == 0 )
-            {
-                charsExtracted = 12;
-                return PORT_PIM_AUTO_RP;
-            }
-            else if ( strncmp(str, "pop2", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_POP2;
-            }
-            /* pop3 */
-            else
-            {
-                charsExtracted = 5;
-                return PORT_POP3;
-            }
-
-        case 'r':
-            if ( strncmp(str, "rwho", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_WHO;
-            }
-            else if ( strncmp(str, "router", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_RIP;
-            }
-            /* rip */
-            else
-            {
-                charsExtracted = 4;
-                return PORT_RIP;
-            }
-
-        case 's':
-            if ( strncmp(str, "smtp", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_SMTP;
-            }
-            else if ( strncmp(str, "snmp", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_SNMP;
-            }
-            else if ( strncmp(str, "snmptrap", 8) == 0 )
-            {
-                charsExtracted = 9;
-                return PORT_SNMPTRAP;
-            }
-            else if ( strncmp(str, "sunrpc", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_SUNRPC;
-            }
-            /* syslog */
-            else
-            {
-                charsExtracted = 7;
-                return PORT_SYSLOG;
-            }
-
-        case 't':
-            if ( strncmp(str, "tacacs", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_TACACS;
-            }
-            else if ( strncmp(str, "talk", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_TALK;
-            }
-            else if ( strncmp(str, "telnet", 6) == 0 )
-            {
-                charsExtracted = 7;
-                return PORT_TELNET;
-            }
-            else if ( strncmp(str, "tftp", 4) == 0 )
-            {
-                charsExtracted = 5;
-                return PORT_TFTP;
-            }
-            /* time */
-            else
-            {
-                charsExtracted = 5;
-                return PORT_TIME;
-            }
-
-        case 'u':
-            /* uucp */
-            charsExtracted = 5;
-            return PORT_UUCP;
-
-        case 'w':
-            if ( strncmp(str, "who", 3) == 0 )
-            {
-                charsExtracted = 4;
-                return PORT_WHO;
-            }
-            else if ( strncmp(str, "whois", 5) == 0 )
-            {
-                charsExtracted = 6;
-                return PORT_WHOIS;
-            }
-            /* www */
-            else
-            {
-                charsExtracted = 4;
-                return PORT_WWW;
-            }
-
-        /* xdmcp */
-        default:
-            charsExtracted = 6;
-            return PORT_XDMCP;
+    if ( PORT_TABLE.find(str, length, port) )
+    {
+        charsExtracted = tokenExtent(str, length);
+        return (u_int16_t) port;
     }
+
+    return parsePortByNum(str, charsExtracted);
 }
 
 //--------------------------------------------------------------------------------
@@ -1013,19 +665,19 @@ int CiscoInputParser::resolveAccessListType(const char* str, unsigned& charsExtr
  *
  * @param str pointer to string containing number of unnamed ACL.
  * @param charsExtracted reference to variable where the number of extracted characters will be stored.
- * @return parsed number of unnamed ACL.
+ * @return parsed number of unnamed ACL, ERROR_FLAG if the string doesn't begin with a number
+ *         (other "access-list" commands).
  */
 int CiscoInputParser::parseAccessListNumber(const char* str, unsigned& charsExtracted)
 {
-    char buffer[8];
-    stringstream ss;
+    unsigned length = KeywordTable::tokenLength(str);
 
-    ss.str(str);
-    ss.getline(buffer, 8, ' ');
-    charsExtracted = ss.gcount();
-    int number = atoi(buffer);
+    charsExtracted = tokenExtent(str, length);
 
-    return number;
+    if ( !isNumber(str, length) )
+        return ERROR_FLAG;
+
+    return (int) parseNumber(str);
 }
 
 //--------------------------------------------------------------------------------
@@ -1077,13 +729,9 @@ void CiscoInputParser::parseAddrAndWildcard(const char* str, IP_ADDRESS& addr, I
         /* address contains "host" */
         case 'h':
         {
-            char tmp[16];
-            stringstream ss;
-            ss.str(str + 5);                    /* shift after "host " */
-            
-            ss.getline(tmp, 16, ' ');           /* get IP address */
-            charsExtracted = ss.gcount();       /* number of characters extracted by last getline() */
-            charsExtracted += 5;                /* add one more "host " */
+            const char* tmp = str + 5;          /* shift after "host " */
+
+            charsExtracted = 5 + tokenExtent(tmp, KeywordTable::tokenLength(tmp));
             addr = parseIPv4addr(tmp);          /* parse IP address */
             *((u_int32_t*)&wildC) = 0x00000000;
             return;
@@ -1092,22 +740,19 @@ void CiscoInputParser::parseAddrAndWildcard(const char* str, IP_ADDRESS& addr, I
         /* address contains "addr a wildCard" */
         default:
         {
-            char tmp[16];
-            stringstream ss;
-            ss.str(str);
-            ss.getline(tmp, 16, ' ');           /* get IP address */
-            charsExtracted = ss.gcount();       /* number of characters extracted by last getline() */
-            addr = parseIPv4addr(tmp);
+            charsExtracted = tokenExtent(str, KeywordTable::tokenLength(str));
+            addr = parseIPv4addr(str);
 
             unsigned tmpCount = 0;
             skipWhiteChars(str + charsExtracted, tmpCount);
             charsExtracted += tmpCount;
-            ss.ignore(tmpCount);
 
-            if ( !ss.eof() )
+            /* wildcard is optional at the end of the line */
+            if ( str[charsExtracted] != '\0' )
             {
-                ss.getline(tmp, 16, ' ');           /* get wildcard */
-                charsExtracted += ss.gcount();      /* number of characters extracted by last getline() */
+                const char* tmp = str + charsExtracted;
+
+                charsExtracted += tokenExtent(tmp, KeywordTable::tokenLength(tmp));
                 wildC = parseIPv4addr(tmp);
             }
             else
@@ -1126,26 +771,40 @@ void CiscoInputParser::parseAddrAndWildcard(const char* str, IP_ADDRESS& addr, I
  * Method parses IPv4 address from passed string.
  *
  * Method parses IPv4, network mask or wildcard from passed string.
+ * Parsing stops at the first character, which is not a digit or a dot,
+ * missing octets are set to zero.
  *
- * @param str pointer to string containing IP address.
+ * @param str pointer to string beginning with IP address.
  * @return structure IP_ADDRESS containing parsed IP address.
  */
 IP_ADDRESS CiscoInputParser::parseIPv4addr(const char* str)
 {
+    u_int8_t octets[4] = { 0, 0, 0, 0 };
+    const char* tmp = str;
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        octets[i] = (u_int8_t) parseNumber(tmp);
+
+        while ( isdigit(*tmp) )
+        {
+            tmp++;
+        }
+
+        if ( *tmp != '.' )
+        {
+            break;
+        }
+
+        tmp++;
+    }
+
     IP_ADDRESS address;
 
-    char tmp[4];
-    stringstream ss;
-    ss.str(str);
-
-    ss.getline(tmp, 4, '.');
-    address.A = atoi(tmp);
-    ss.getline(tmp, 4, '.');
-    address.B = atoi(tmp);
-    ss.getline(tmp, 4, '.');
-    address.C = atoi(tmp);
-    ss.getline(tmp, 4, '.');
-    address.D = atoi(tmp);
+    address.A = octets[0];
+    address.B = octets[1];
+    address.C = octets[2];
+    address.D = octets[3];
     
     return address;
 }
@@ -1206,17 +865,62 @@ void CiscoInputParser::skipWhiteChars(const char* str, unsigned& charsExtracted)
 //--------------------------------------------------------------------------------
 
 /**
- * Method rolls back in passed std::istream-e by passed number of read characters.
+ * Method parses decimal number at the beginning of passed string.
  *
- * @param stream reference to stream which will be rolled back.
- * @param size the value representing number of characters we want to roll back.
+ * @param str pointer to string beginning with the number.
+ * @return parsed number, 0 if the string doesn't begin with a digit.
  */
-void CiscoInputParser::rollbackStream(std::istream& stream, std::streamsize size)
+unsigned long CiscoInputParser::parseNumber(const char* str)
 {
-    for ( streamsize i = 0; i < size; ++i )
+    unsigned long number = 0;
+
+    while ( isdigit(*str) )
     {
-        stream.unget();
+        number = number * 10 + (*str - '0');
+        str++;
     }
+
+    return number;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Method checks if the token consists only of decimal digits.
+ *
+ * @param str pointer to string beginning with the token.
+ * @param length length of the token.
+ * @return true if the token is not empty and all its characters are digits, false otherwise.
+ */
+bool CiscoInputParser::isNumber(const char* str, unsigned length)
+{
+    /* longer numbers would overflow all checked ranges */
+    if ( (length == 0) || (length > 9) )
+        return false;
+
+    for ( unsigned i = 0; i < length; ++i )
+    {
+        if ( !isdigit((unsigned char) str[i]) )
+            return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of characters extracted by parsing a token.
+ *
+ * Token is extracted together with one following separator (if it is not the end of line).
+ *
+ * @param str pointer to string beginning with the token.
+ * @param length length of the token.
+ * @return number of extracted characters.
+ */
+unsigned CiscoInputParser::tokenExtent(const char* str, unsigned length)
+{
+    return ( str[length] != '\0' ) ? length + 1 : length;
 }
 
 //--------------------------------------------------------------------------------
@@ -1253,31 +957,49 @@ string CiscoInputParser::commandToString(int cmd)
 /**
  * Method parses passed input stream and returns the vector of parsed ACL with corresponding rules.
  *
+ * The whole stream is read into InputBuffer and parsed by parse(InputBuffer&).
+ *
  * @param inputStream reference to input stream std::istream containing input configuration.
  * @return smart pointer containing the pointer to the vector of ACL with rules.
  */
 auto_ptr< boost::ptr_vector< AccessControlList > > CiscoInputParser::parse(std::istream& inputStream)
+{
+    auto_ptr< InputBuffer > input = InputBuffer::fromStream(inputStream);
+
+    return parse(*input);
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Method parses configuration held by passed buffer and returns the vector of parsed ACL with corresponding rules.
+ *
+ * Lines are terminated in place by LineScanner, so the data of the buffer are modified.
+ *
+ * @param input reference to the buffer containing input configuration.
+ * @return smart pointer containing the pointer to the vector of ACL with rules.
+ */
+auto_ptr< boost::ptr_vector< AccessControlList > > CiscoInputParser::parse(InputBuffer& input)
 {
     /* use smart pointer to store address and control allocated memory */
     m_aclsVector = auto_ptr< boost::ptr_vector< AccessControlList > >(new boost::ptr_vector< AccessControlList >);
 
-    char buffer[256];
+    LineScanner scanner(input);
+    const char* line;
 
-    /* read whole input till EOF */
-    while ( !inputStream.eof() )
+    /* read whole input till the end */
+    while ( (line = scanner.nextLine()) != NULL )
     {
-        inputStream.getline(buffer, 256);
         unsigned tmp_extracted = 0;
 
-        char* tmp_buffer = buffer;
+        const char* tmp_buffer = line;
 
         /* skip white characters at the beginning */
-        if ( isspace(buffer[0]) )
+        if ( isspace(line[0]) )
         {
-            skipWhiteChars(buffer, tmp_extracted);
+            skipWhiteChars(line, tmp_extracted);
             tmp_buffer += tmp_extracted;
         }
-
         /* find out the type of command in line */
         int cmd = parseCommand(tmp_buffer, tmp_extracted);
 
@@ -1293,6 +1015,12 @@ auto_ptr< boost::ptr_vector< AccessControlList > > CiscoInputParser::parse(std::
             int aclNum = parseAccessListNumber(tmp_buffer, tmp_extracted);
             tmp_buffer += tmp_extracted;        /* shift after the number of ACL to the first next character */
 
+            /* skip commands which don't define rules of numbered ACLs */
+            if ( aclNum == ERROR_FLAG )
+            {
+                continue;
+            }
+
             skipWhiteChars(tmp_buffer, tmp_extracted);
             tmp_buffer += tmp_extracted;
 
@@ -1328,15 +1056,14 @@ auto_ptr< boost::ptr_vector< AccessControlList > > CiscoInputParser::parse(std::
             AccessControlList* tmp_curentAcl = getAclByName(parseAccessListName(tmp_buffer));
 
             /* reading rules of named ACL */
-            while ( !inputStream.eof() )
+            while ( (line = scanner.nextLine()) != NULL )
             {
-                inputStream.getline(buffer, 256);
-                tmp_buffer = buffer;
+                tmp_buffer = line;
 
                 /* get the type of rule in line */
-                if ( isspace(buffer[0]) )
+                if ( isspace(line[0]) )
                 {
-                    skipWhiteChars(buffer, tmp_extracted);
+                    skipWhiteChars(line, tmp_extracted);
                     tmp_buffer += tmp_extracted;
                 }
 
@@ -1364,7 +1091,7 @@ auto_ptr< boost::ptr_vector< AccessControlList > > CiscoInputParser::parse(std::
                 /* if it is not the rule of named ACL, return read line and break the cycle! */
                 else if ( cmd != CMD_IP_ACCESS_LIST_RULE )
                 {
-                    rollbackStream(inputStream, inputStream.gcount());
+                    scanner.unreadLine();
                     break;
                 }
                 
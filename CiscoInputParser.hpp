@@ -22,6 +22,7 @@
 
 #include "AclRule.hpp"
 #include "InputParser.hpp"
+#include "KeywordTable.hpp"
 
 #ifndef CISCO_INPUTPARSER_HPP__563783712536778984765487984387687179468452747276463790
 #define CISCO_INPUTPARSER_HPP__563783712536778984765487984387687179468452747276463790
@@ -43,6 +44,15 @@ const int CMD_IP_ACCESS_LIST = 2;
 const int CMD_IP_ACCESS_LIST_RULE = 3;
 const int CMD_ACL_RULE_REMARK = 4;
 
+/*
+ * Constants representing operator of port definition.
+ */
+const int PORT_OP_EQ = 0;
+const int PORT_OP_NEQ = 1;
+const int PORT_OP_LT = 2;
+const int PORT_OP_GT = 3;
+const int PORT_OP_RANGE = 4;
+
 /*
  * Constants representing type of ACL.
  */
@@ -55,8 +65,11 @@ const int ACL_EXTENDED = 1;
  * Class CiscoInputParser represents input parser of Cisco configuration file.
  *
  * Class provides only one public method parse() which is used to parse Cisco
- * configuration entered as an input data stream std::istream. Method output
- * is smart pointer to vector containing all parsed ACLs from configuration.
+ * configuration entered as an input data stream std::istream or held by InputBuffer.
+ * Method output is smart pointer to vector containing all parsed ACLs from configuration.
+ *
+ * Configuration is split into lines in place by LineScanner (lines have no length limit)
+ * and commands, protocols and ports are recognized by lookups into KeywordTable-s.
  */
 class CiscoInputParser : public InputParser
 {
@@ -64,6 +77,11 @@ class CiscoInputParser : public InputParser
         std::map< std::string, AccessControlList* > m_aclsByName;               /** Map used to access existing ACLs by their name (ID). */
         std::auto_ptr< boost::ptr_vector< AccessControlList > > m_aclsVector;   /** Vector containing parsed ACLs. */
 
+        static const KeywordTable COMMAND_TABLE;        /** Table of the first words of commands. */
+        static const KeywordTable PROTOCOL_TABLE;       /** Table of protocol names. */
+        static const KeywordTable PORT_TABLE;           /** Table of port names. */
+        static const KeywordTable PORT_OPERATOR_TABLE;  /** Table of port operators. */
+
         AccessControlList* getAclByName(int name);
         AccessControlList* getAclByName(const std::string& name);
         AccessControlList* createNewAcl(const std::string& name);
@@ -86,6 +104,7 @@ class CiscoInputParser : public InputParser
         static int parseProtocolByNum(const char* str, unsigned& charsExtracted);
 
         static int parsePort(const char* str, unsigned& charsExtracted, u_int16_t& portStart, u_int16_t& portStop, bool& portNeg);
+        static u_int16_t parsePortOperand(const char* str, unsigned& charsExtracted);
         static u_int16_t parsePortByNum(const char* str, unsigned& charsExtracted);
         static u_int16_t parsePortByName(const char* str, unsigned& charsExtracted);
 
@@ -95,13 +114,16 @@ class CiscoInputParser : public InputParser
         static void fillIPv4Range(const IP_ADDRESS& addr, const IP_ADDRESS& wildc, IP_ADDRESS& range_start, IP_ADDRESS& range_stop);
 
         static void skipWhiteChars(const char* str, unsigned& charsExtracted);
-        static void rollbackStream(std::istream& stream, std::streamsize size);
+        static unsigned long parseNumber(const char* str);
+        static bool isNumber(const char* str, unsigned length);
+        static unsigned tokenExtent(const char* str, unsigned length);
         static std::string commandToString(int cmd);
         
     public:
         CiscoInputParser() { };
         virtual ~CiscoInputParser() { };
         virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(std::istream& inputStream);
+        virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(InputBuffer& input);
 };
 
 #endif /* CISCO_INPUTPARSER_HPP__563783712536778984765487984387687179468452747276463790 */
\ No newline at end of file
@@ -210,7 +210,6 @@ auto_ptr< boost::ptr_vector< AccessControlList > > ClassBenchInputParser::parse(
     unsigned position = 0;              /* the position of the rule */
     while ( !inputStream.eof() )
     {
-        AclRule* newRule = NULL;
         IP_ADDRESS addr1, addr2;
         u_int16_t port1, port2;
         stringstream ss;
@@ -225,8 +224,7 @@ auto_ptr< boost::ptr_vector< AccessControlList > > ClassBenchInputParser::parse(
             continue;
         }
 
-        newRule = new AclRule(position);
-        newAcl->pushBack(newRule);
+        auto_ptr< AclRule > newRule(new AclRule(position));
 
         ss.str(&(line[1]));     /* skip first character '@' */
 
@@ -287,7 +285,8 @@ auto_ptr< boost::ptr_vector< AccessControlList > > ClassBenchInputParser::parse(
         /**********/
         /* ACTION */
         newRule->setAction(ACTION_ALLOW);
-        
+
+        newAcl->pushBack(newRule.release());    /* add the complete rule to ACL */
         ++position;
     }
 
@@ -18,11 +18,69 @@
 
 #include <iostream>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "Conflict.hpp"
 #include "GlobalDefs.hpp"
 
 using namespace std;
 
+/*
+ * Lookup tables used by classifyBatch() instead of chains of conditions. Relations are indexed
+ * by their values (RELATION_NONE = 0 ... RELATION_1_INTERLEAVING_2 = 4), rule Y is always
+ * the rule "1" of relations.
+ */
+
+/* relation of ranges by the code (overlapping << 2) | (Y subset of X << 1) | (Y superset of X) */
+static const int RANGE_RELATION[8] = { RELATION_NONE, RELATION_NONE, RELATION_NONE, RELATION_NONE,
+                                       RELATION_1_INTERLEAVING_2, RELATION_1_SUPERSET_2, RELATION_1_SUBSET_2, RELATION_1_EQUIV_2 };
+
+/* relation of port ranges by relation of non-negated ranges and (Y negated << 1) | (X negated), see compareTwoPortRanges() */
+static const int PORT_RELATION[5][4] = {
+    { RELATION_NONE, RELATION_1_SUBSET_2, RELATION_1_SUPERSET_2, RELATION_1_INTERLEAVING_2 },                   /* RELATION_NONE */
+    { RELATION_1_SUPERSET_2, RELATION_1_INTERLEAVING_2, RELATION_NONE, RELATION_1_SUBSET_2 },                   /* RELATION_1_SUPERSET_2 */
+    { RELATION_1_SUBSET_2, RELATION_NONE, RELATION_1_INTERLEAVING_2, RELATION_1_SUPERSET_2 },                   /* RELATION_1_SUBSET_2 */
+    { RELATION_1_EQUIV_2, RELATION_NONE, RELATION_NONE, RELATION_1_EQUIV_2 },                                   /* RELATION_1_EQUIV_2 */
+    { RELATION_1_INTERLEAVING_2, RELATION_1_INTERLEAVING_2, RELATION_1_INTERLEAVING_2, RELATION_1_INTERLEAVING_2 } /* RELATION_1_INTERLEAVING_2 */
+};
+
+/* relation of protocols by the code (same << 4) | (Y any << 3) | (X any << 2) | (Y ip << 1) | (X ip), see compareProtocol() */
+static const int PROTOCOL_RELATION[32] = {
+    RELATION_NONE, RELATION_1_SUBSET_2, RELATION_1_SUPERSET_2, RELATION_1_SUPERSET_2,
+    RELATION_1_SUBSET_2, RELATION_1_SUBSET_2, RELATION_1_SUBSET_2, RELATION_1_SUBSET_2,
+    RELATION_1_SUPERSET_2, RELATION_1_SUPERSET_2, RELATION_1_SUPERSET_2, RELATION_1_SUPERSET_2,
+    RELATION_1_SUPERSET_2, RELATION_1_SUPERSET_2, RELATION_1_SUPERSET_2, RELATION_1_SUPERSET_2,
+    RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2,
+    RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2,
+    RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2,
+    RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2, RELATION_1_EQUIV_2
+};
+
+/* combination of the global relation (row) and the relation of a dimension (column), see combineRelations() */
+static const int COMBINED_RELATION[5][5] = {
+    { RELATION_NONE, RELATION_NONE, RELATION_NONE, RELATION_NONE, RELATION_NONE },
+    { RELATION_NONE, RELATION_1_SUPERSET_2, RELATION_1_INTERLEAVING_2, RELATION_1_SUPERSET_2, RELATION_1_INTERLEAVING_2 },
+    { RELATION_NONE, RELATION_1_INTERLEAVING_2, RELATION_1_SUBSET_2, RELATION_1_SUBSET_2, RELATION_1_INTERLEAVING_2 },
+    { RELATION_NONE, RELATION_1_SUPERSET_2, RELATION_1_SUBSET_2, RELATION_1_EQUIV_2, RELATION_1_INTERLEAVING_2 },
+    { RELATION_NONE, RELATION_1_INTERLEAVING_2, RELATION_1_INTERLEAVING_2, RELATION_1_INTERLEAVING_2, RELATION_1_INTERLEAVING_2 }
+};
+
+/* type of the conflict by the relation of rules and (action of Y == action of X), see resolveConflictType() */
+static const int CONFLICT_BY_RELATION[5][2] = {
+    { CONFLICT_NONE, CONFLICT_NONE },
+    { CONFLICT_GENERALIZATION, CONFLICT_REDUNDANCY },
+    { CONFLICT_SHADOWING, CONFLICT_REDUNDANCY },
+    { CONFLICT_SHADOWING, CONFLICT_REDUNDANCY },
+    { CONFLICT_CORELATION, CONFLICT_SUPERIMPOSING }
+};
+
+/* bias of values, which allows to compare unsigned values by signed comparisons of SIMD instructions */
+static const u_int32_t COMPARE_BIAS = 0x80000000;
+
 /**
  * Class constructor.
  *
@@ -43,6 +101,25 @@ Conflict::Conflict(const AclRule& ruleX, const AclRule& ruleY) : m_conflictType(
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Class constructor.
+ *
+ * Constructs the object from already computed result of the classification (see classifyResult()).
+ *
+ * @param ruleX reference to rule X (first in the pair).
+ * @param ruleY reference to rule Y (second in the pair).
+ * @param result reference to the result of the classification of rules.
+ */
+Conflict::Conflict(const AclRule& ruleX, const AclRule& ruleY, const CONFLICT_RESULT& result) : m_ruleX(ruleX),
+                                                                                                 m_ruleY(ruleY)
+{
+    for ( int i = DIMENSION_MIN; i <= DIMENSION_MAX; ++i )
+        m_dimensionsRelation[i] = result.dimensionsRelation[i];
+
+    setConflictType(result.conflictType);
+}
+//-----------------------------------------------------------------------------------
+
 /**
  * Class destructor.
  */
@@ -186,10 +263,7 @@ auto_ptr< Conflict > Conflict::classifyConflict(const AclRule& ruleX, const AclR
 {
 //     if ( classifyBy == CLASSIFY_BY_RANGE )
 //     {
-        auto_ptr< Conflict > confObject(new Conflict(ruleX, ruleY));
-        classifyByRange(*confObject, ruleX, ruleY);
-
-        return confObject;
+        return auto_ptr< Conflict >(new Conflict(ruleX, ruleY, classifyResult(ruleX, ruleY)));
 //     }
 //     else if ( classifyBy == CLASSIFY_BY_PREFIX )
 //     {
@@ -201,18 +275,77 @@ auto_ptr< Conflict > Conflict::classifyConflict(const AclRule& ruleX, const AclR
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Method classifies conflict between rules of passed ACL.
+ *
+ * Method works as classifyConflict() for rules, but fields of rules are read from the packed
+ * store of the ACL (see AclRuleStore). Returned object refers to rules of the ACL.
+ *
+ * @param acl reference to the ACL containing both rules.
+ * @param ruleXIndex position of rule X in the ACL.
+ * @param ruleYIndex position of rule Y in the ACL.
+ * @return smart pointer containing pointer to object of class Conflict containing information about the analysis.
+ */
+auto_ptr< Conflict > Conflict::classifyConflict(const AccessControlList& acl, size_t ruleXIndex, size_t ruleYIndex)
+{
+    return auto_ptr< Conflict >(new Conflict(acl[ruleXIndex], acl[ruleYIndex], classifyResult(acl, ruleXIndex, ruleYIndex)));
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method classifies conflict between passed rules and returns the result by value.
+ *
+ * Unlike classifyConflict(), no object is allocated, so the method is suitable for classification
+ * of many pairs of rules, which are mostly not in conflict.
+ *
+ * @param ruleX reference to object AclRule containing information about X ACL rule.
+ * @param ruleY reference to object AclRule containing information about Y ACL rule.
+ * @return result of the classification.
+ */
+CONFLICT_RESULT Conflict::classifyResult(const AclRule& ruleX, const AclRule& ruleY)
+{
+    CONFLICT_RESULT result;
+    classifyByRange(result, ruleX, ruleY);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method classifies conflict between rules of passed ACL and returns the result by value.
+ *
+ * Fields of rules are read from the packed store of the ACL (see AclRuleStore).
+ *
+ * @param acl reference to the ACL containing both rules.
+ * @param ruleXIndex position of rule X in the ACL.
+ * @param ruleYIndex position of rule Y in the ACL.
+ * @return result of the classification.
+ */
+CONFLICT_RESULT Conflict::classifyResult(const AccessControlList& acl, size_t ruleXIndex, size_t ruleYIndex)
+{
+    CONFLICT_RESULT result;
+    classifyByRange(result, acl.ruleStore(), ruleXIndex, ruleYIndex);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
 /**
  * Method classifies conflict between passed rules accordin to ranges.
  *
  * Method classifies conflict between dvoma passed rules
  * ruleX a ruleY. Method classifies conflict according to ranges.
  *
- * @param newObject reference to object of class Conflict where the information about analysis will be stored.
+ * @param result reference to the structure where the result of the analysis will be stored.
  * @param ruleX reference to object AclRule containing information about X ACL rule.
  * @param ruleY reference to object AclRule containing information about Y ACL rule.
  */
-void Conflict::classifyByRange(Conflict& newObject, const AclRule& ruleX, const AclRule& ruleY)
+void Conflict::classifyByRange(CONFLICT_RESULT& result, const AclRule& ruleX, const AclRule& ruleY)
 {
+    int* relations = result.dimensionsRelation;
     int tmp_relation = RELATION_1_EQUIV_2;
 
     /*************************************************************/
@@ -224,52 +357,435 @@ void Conflict::classifyByRange(Conflict& newObject, const AclRule& ruleX, const
     #endif
     
     /* protocols comparison */
-    newObject.setDimensionRelation(DIMENSION_PROTO, compareProtocol(ruleY.getProtocol(), ruleX.getProtocol()));
-    tmp_relation = combineRelations(tmp_relation, newObject.getDimensionsRelation(DIMENSION_PROTO));
+    relations[DIMENSION_PROTO] = compareProtocol(ruleY.getProtocol(), ruleX.getProtocol());
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_PROTO]);
 
     #ifdef CONFLICT_DEBUG
-    cout << "\tProtocols relation=" << relationTypeToString(newObject.getDimensionsRelation(DIMENSION_PROTO)) << endl;
+    cout << "\tProtocols relation=" << relationTypeToString(relations[DIMENSION_PROTO]) << endl;
     cout << "\tCombined relation=" << relationTypeToString(tmp_relation) << endl << endl;
     #endif
 
     /* comparison of source IPv4 addresses's ranges */
-    newObject.setDimensionRelation(DIMENSION_SRC_IP, compareTwoIpv4Ranges(ruleY.getSrcIpStart(), ruleY.getSrcIpStop(), ruleX.getSrcIpStart(), ruleX.getSrcIpStop()));
-    tmp_relation = combineRelations(tmp_relation, newObject.getDimensionsRelation(DIMENSION_SRC_IP));
+    relations[DIMENSION_SRC_IP] = compareTwoIpv4Ranges(ruleY.getSrcIpStart(), ruleY.getSrcIpStop(), ruleX.getSrcIpStart(), ruleX.getSrcIpStop());
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_SRC_IP]);
 
     #ifdef CONFLICT_DEBUG
-    cout << "\tSRC IP relation=" << relationTypeToString(newObject.getDimensionsRelation(DIMENSION_SRC_IP)) << endl;
+    cout << "\tSRC IP relation=" << relationTypeToString(relations[DIMENSION_SRC_IP]) << endl;
     cout << "\tCombined relation=" << relationTypeToString(tmp_relation) << endl << endl;
     #endif
 
     /* comparison of destination IPv4 addresses ranges */
-    newObject.setDimensionRelation(DIMENSION_DST_IP, compareTwoIpv4Ranges(ruleY.getDstIpStart(), ruleY.getDstIpStop(), ruleX.getDstIpStart(), ruleX.getDstIpStop()));
-    tmp_relation = combineRelations(tmp_relation, newObject.getDimensionsRelation(DIMENSION_DST_IP));
+    relations[DIMENSION_DST_IP] = compareTwoIpv4Ranges(ruleY.getDstIpStart(), ruleY.getDstIpStop(), ruleX.getDstIpStart(), ruleX.getDstIpStop());
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_DST_IP]);
 
     #ifdef CONFLICT_DEBUG
-    cout << "\tDST IP relation=" << relationTypeToString(newObject.getDimensionsRelation(DIMENSION_DST_IP)) << endl;
+    cout << "\tDST IP relation=" << relationTypeToString(relations[DIMENSION_DST_IP]) << endl;
     cout << "\tCombined relation=" << relationTypeToString(tmp_relation) << endl << endl;
     #endif
 
     /* comparison of source ports ranges */
-    newObject.setDimensionRelation(DIMENSION_SRC_PRT, compareTwoPortRanges(ruleY.getSrcPortStart(), ruleY.getSrcPortStop(), ruleY.getSrcPortNeg(), ruleX.getSrcPortStart(), ruleX.getSrcPortStop(), ruleX.getSrcPortNeg()));
-    tmp_relation = combineRelations(tmp_relation, newObject.getDimensionsRelation(DIMENSION_SRC_PRT));
+    relations[DIMENSION_SRC_PRT] = compareTwoPortRanges(ruleY.getSrcPortStart(), ruleY.getSrcPortStop(), ruleY.getSrcPortNeg(), ruleX.getSrcPortStart(), ruleX.getSrcPortStop(), ruleX.getSrcPortNeg());
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_SRC_PRT]);
 
     #ifdef CONFLICT_DEBUG
-    cout << "\tSRC port relation=" << relationTypeToString(newObject.getDimensionsRelation(DIMENSION_SRC_PRT)) << endl;
+    cout << "\tSRC port relation=" << relationTypeToString(relations[DIMENSION_SRC_PRT]) << endl;
     cout << "\tCombined relation=" << relationTypeToString(tmp_relation) << endl << endl;
     #endif
 
     /* comparison of destination ports ranges */
-    newObject.setDimensionRelation(DIMENSION_DST_PRT, compareTwoPortRanges(ruleY.getDstPortStart(), ruleY.getDstPortStop(), ruleY.getDstPortNeg(), ruleX.getDstPortStart(), ruleX.getDstPortStop(), ruleX.getDstPortNeg()));
-    tmp_relation = combineRelations(tmp_relation, newObject.getDimensionsRelation(DIMENSION_DST_PRT));
+    relations[DIMENSION_DST_PRT] = compareTwoPortRanges(ruleY.getDstPortStart(), ruleY.getDstPortStop(), ruleY.getDstPortNeg(), ruleX.getDstPortStart(), ruleX.getDstPortStop(), ruleX.getDstPortNeg());
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_DST_PRT]);
 
     #ifdef CONFLICT_DEBUG
-    cout << "\tDST port relation=" << relationTypeToString(newObject.getDimensionsRelation(DIMENSION_DST_PRT)) << endl;
+    cout << "\tDST port relation=" << relationTypeToString(relations[DIMENSION_DST_PRT]) << endl;
     cout << "\tCombined relation=" << relationTypeToString(tmp_relation) << endl << endl;
     #endif
 
     /* get type of the conflict */
-    newObject.setConflictType(resolveConflictType(tmp_relation, ruleY.getAction(), ruleX.getAction()));
+    result.conflictType = resolveConflictType(tmp_relation, ruleY.getAction(), ruleX.getAction());
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method classifies conflict between rules of passed store according to ranges.
+ *
+ * Relations of dimensions are computed in the same way as by classifyByRange() for rules.
+ *
+ * @param result reference to the structure where the result of the analysis will be stored.
+ * @param rules reference to the packed store of rules.
+ * @param ruleXIndex position of rule X in the store.
+ * @param ruleYIndex position of rule Y in the store.
+ */
+void Conflict::classifyByRange(CONFLICT_RESULT& result, const AclRuleStore& rules, size_t ruleXIndex, size_t ruleYIndex)
+{
+    int* relations = result.dimensionsRelation;
+    int tmp_relation = RELATION_1_EQUIV_2;
+
+    relations[DIMENSION_PROTO] = compareProtocol(rules.protocol(ruleYIndex), rules.protocol(ruleXIndex));
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_PROTO]);
+
+    relations[DIMENSION_SRC_IP] = compareTwoIpv4Ranges(rules.srcIpStart(ruleYIndex), rules.srcIpStop(ruleYIndex), rules.srcIpStart(ruleXIndex), rules.srcIpStop(ruleXIndex));
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_SRC_IP]);
+
+    relations[DIMENSION_DST_IP] = compareTwoIpv4Ranges(rules.dstIpStart(ruleYIndex), rules.dstIpStop(ruleYIndex), rules.dstIpStart(ruleXIndex), rules.dstIpStop(ruleXIndex));
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_DST_IP]);
+
+    relations[DIMENSION_SRC_PRT] = compareTwoPortRanges(rules.srcPortStart(ruleYIndex), rules.srcPortStop(ruleYIndex), rules.srcPortNeg(ruleYIndex), rules.srcPortStart(ruleXIndex), rules.srcPortStop(ruleXIndex), rules.srcPortNeg(ruleXIndex));
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_SRC_PRT]);
+
+    relations[DIMENSION_DST_PRT] = compareTwoPortRanges(rules.dstPortStart(ruleYIndex), rules.dstPortStop(ruleYIndex), rules.dstPortNeg(ruleYIndex), rules.dstPortStart(ruleXIndex), rules.dstPortStop(ruleXIndex), rules.dstPortNeg(ruleXIndex));
+    tmp_relation = combineRelations(tmp_relation, relations[DIMENSION_DST_PRT]);
+
+    #ifdef CONFLICT_DEBUG
+    cout << "rulex#=" << ruleXIndex << " " << "ruley#=" << ruleYIndex << endl;
+    cout << "\tCombined relation=" << relationTypeToString(tmp_relation) << endl << endl;
+    #endif
+
+    /* get type of the conflict */
+    result.conflictType = resolveConflictType(tmp_relation, rules.action(ruleYIndex), rules.action(ruleXIndex));
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method classifies conflicts between rule Y and passed rules X of the store.
+ *
+ * Results are the same as results of classifyByRange(), but ranges of CLASSIFY_BLOCK rules X
+ * are compared with the range of rule Y at once (using AVX2 or SSE2 instructions, if the compiler
+ * enables them) and relations are combined by lookup tables instead of conditions.
+ *
+ * @param rules reference to the packed store of rules.
+ * @param ruleYIndex position of rule Y in the store.
+ * @param ruleXIndexes array of positions of rules X in the store.
+ * @param count number of rules X.
+ * @param results array of at least count items, where results of the classification are stored.
+ */
+void Conflict::classifyBatch(const AclRuleStore& rules, size_t ruleYIndex, const int32_t* ruleXIndexes, size_t count, CONFLICT_RESULT* results)
+{
+    /* ranges of rule Y in order source IP, destination IP, source port, destination port */
+    u_int32_t yStart[4] = { rules.srcIpStart(ruleYIndex) ^ COMPARE_BIAS, rules.dstIpStart(ruleYIndex) ^ COMPARE_BIAS,
+                            rules.srcPortStart(ruleYIndex) ^ COMPARE_BIAS, rules.dstPortStart(ruleYIndex) ^ COMPARE_BIAS };
+    u_int32_t yStop[4] = { rules.srcIpStop(ruleYIndex) ^ COMPARE_BIAS, rules.dstIpStop(ruleYIndex) ^ COMPARE_BIAS,
+                           rules.srcPortStop(ruleYIndex) ^ COMPARE_BIAS, rules.dstPortStop(ruleYIndex) ^ COMPARE_BIAS };
+
+    u_int8_t yProtocol = rules.protocolNumber(ruleYIndex);
+    u_int8_t yFlags = rules.flags(ruleYIndex);
+    u_int8_t yProtocolFlags = yFlags & (AclRuleStore::FLAG_PROTO_ANY | AclRuleStore::FLAG_PROTO_IPv4);
+    int yAction = rules.action(ruleYIndex);
+    int yProtocolCode = (((yFlags & AclRuleStore::FLAG_PROTO_ANY) != 0) << 3) | (((yFlags & AclRuleStore::FLAG_PROTO_IPv4) != 0) << 1);
+    int ySrcPortNeg = ((yFlags & AclRuleStore::FLAG_SRC_PORT_NEG) != 0) << 1;
+    int yDstPortNeg = ((yFlags & AclRuleStore::FLAG_DST_PORT_NEG) != 0) << 1;
+
+    u_int32_t xStart[4][CLASSIFY_BLOCK];
+    u_int32_t xStop[4][CLASSIFY_BLOCK];
+    int rangeRelations[4][CLASSIFY_BLOCK];
+
+    for ( size_t first = 0; first < count; first += CLASSIFY_BLOCK )
+    {
+        size_t blockSize = ((count - first) < CLASSIFY_BLOCK) ? (count - first) : CLASSIFY_BLOCK;
+
+        /* gather ranges of the block, missing rules of the last block are replaced by the first one */
+        for ( size_t i = 0; i < CLASSIFY_BLOCK; ++i )
+        {
+            size_t x = ruleXIndexes[first + ((i < blockSize) ? i : 0)];
+
+            xStart[0][i] = rules.srcIpStart(x) ^ COMPARE_BIAS;
+            xStop[0][i] = rules.srcIpStop(x) ^ COMPARE_BIAS;
+            xStart[1][i] = rules.dstIpStart(x) ^ COMPARE_BIAS;
+            xStop[1][i] = rules.dstIpStop(x) ^ COMPARE_BIAS;
+            xStart[2][i] = rules.srcPortStart(x) ^ COMPARE_BIAS;
+            xStop[2][i] = rules.srcPortStop(x) ^ COMPARE_BIAS;
+            xStart[3][i] = rules.dstPortStart(x) ^ COMPARE_BIAS;
+            xStop[3][i] = rules.dstPortStop(x) ^ COMPARE_BIAS;
+        }
+
+        for ( int d = 0; d < 4; ++d )
+            compareRangesBlock(yStart[d], yStop[d], xStart[d], xStop[d], rangeRelations[d]);
+
+        /* protocols, negations of ports and combination of relations */
+        for ( size_t i = 0; i < blockSize; ++i )
+        {
+            size_t x = ruleXIndexes[first + i];
+            int* relations = results[first + i].dimensionsRelation;
+            u_int8_t xFlags = rules.flags(x);
+
+            int protocolCode = yProtocolCode | (((xFlags & AclRuleStore::FLAG_PROTO_ANY) != 0) << 2) | ((xFlags & AclRuleStore::FLAG_PROTO_IPv4) != 0);
+            protocolCode |= ((yProtocol == rules.protocolNumber(x)) && (yProtocolFlags == (xFlags & (AclRuleStore::FLAG_PROTO_ANY | AclRuleStore::FLAG_PROTO_IPv4)))) << 4;
+
+            relations[DIMENSION_PROTO] = PROTOCOL_RELATION[protocolCode];
+            relations[DIMENSION_SRC_IP] = rangeRelations[0][i];
+            relations[DIMENSION_DST_IP] = rangeRelations[1][i];
+            relations[DIMENSION_SRC_PRT] = PORT_RELATION[rangeRelations[2][i]][ySrcPortNeg | ((xFlags & AclRuleStore::FLAG_SRC_PORT_NEG) != 0)];
+            relations[DIMENSION_DST_PRT] = PORT_RELATION[rangeRelations[3][i]][yDstPortNeg | ((xFlags & AclRuleStore::FLAG_DST_PORT_NEG) != 0)];
+
+            int relation = RELATION_1_EQUIV_2;
+            for ( int d = DIMENSION_MIN; d <= DIMENSION_MAX; ++d )
+                relation = COMBINED_RELATION[relation][relations[d]];
+
+            results[first + i].conflictType = CONFLICT_BY_RELATION[relation][yAction == rules.action(x)];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method classifies conflicts between rule Y and passed rules X of the store with the short-circuit.
+ *
+ * Dimensions are tested in the order given by passed selectivity structure and testing of every
+ * rule X stops at the first dimension, in which it is disjoint with rule Y (such rules can not be
+ * in conflict). Ranges of the tested dimension are compared for CLASSIFY_BLOCK rules X at once and
+ * the block is finished, when all its rules are disjoint. Conflict types are the same as types
+ * found by classifyBatch() without the selectivity. Relations of all dimensions are set only for
+ * rules in conflict, relations of dimensions which were not tested are RELATION_NONE.
+ *
+ * @param rules reference to the packed store of rules.
+ * @param ruleYIndex position of rule Y in the store.
+ * @param ruleXIndexes array of positions of rules X in the store.
+ * @param count number of rules X.
+ * @param results array of at least count items, where results of the classification are stored.
+ * @param selectivity reference to the structure with the order of dimensions, whose counters are updated.
+ */
+void Conflict::classifyBatch(const AclRuleStore& rules, size_t ruleYIndex, const int32_t* ruleXIndexes, size_t count, CONFLICT_RESULT* results,
+                             DIMENSION_SELECTIVITY& selectivity)
+{
+    /* ranges of rule Y indexed by (dimension - DIMENSION_SRC_IP) */
+    u_int32_t yStart[4] = { rules.srcIpStart(ruleYIndex) ^ COMPARE_BIAS, rules.dstIpStart(ruleYIndex) ^ COMPARE_BIAS,
+                            rules.srcPortStart(ruleYIndex) ^ COMPARE_BIAS, rules.dstPortStart(ruleYIndex) ^ COMPARE_BIAS };
+    u_int32_t yStop[4] = { rules.srcIpStop(ruleYIndex) ^ COMPARE_BIAS, rules.dstIpStop(ruleYIndex) ^ COMPARE_BIAS,
+                           rules.srcPortStop(ruleYIndex) ^ COMPARE_BIAS, rules.dstPortStop(ruleYIndex) ^ COMPARE_BIAS };
+
+    u_int8_t yProtocol = rules.protocolNumber(ruleYIndex);
+    u_int8_t yFlags = rules.flags(ruleYIndex);
+    u_int8_t yProtocolFlags = yFlags & (AclRuleStore::FLAG_PROTO_ANY | AclRuleStore::FLAG_PROTO_IPv4);
+    int yAction = rules.action(ruleYIndex);
+    int yProtocolCode = (((yFlags & AclRuleStore::FLAG_PROTO_ANY) != 0) << 3) | (((yFlags & AclRuleStore::FLAG_PROTO_IPv4) != 0) << 1);
+    int ySrcPortNeg = ((yFlags & AclRuleStore::FLAG_SRC_PORT_NEG) != 0) << 1;
+    int yDstPortNeg = ((yFlags & AclRuleStore::FLAG_DST_PORT_NEG) != 0) << 1;
+
+    size_t x[CLASSIFY_BLOCK];
+    u_int32_t xStart[CLASSIFY_BLOCK];
+    u_int32_t xStop[CLASSIFY_BLOCK];
+    int rangeRelations[CLASSIFY_BLOCK];
+
+    for ( size_t first = 0; first < count; first += CLASSIFY_BLOCK )
+    {
+        size_t blockSize = ((count - first) < CLASSIFY_BLOCK) ? (count - first) : CLASSIFY_BLOCK;
+        unsigned candidates = (1U << blockSize) - 1;    /* bit of the rule X is set, if it was not found disjoint yet */
+
+        /* missing rules of the last block are replaced by the first one */
+        for ( size_t i = 0; i < CLASSIFY_BLOCK; ++i )
+            x[i] = ruleXIndexes[first + ((i < blockSize) ? i : 0)];
+
+        for ( size_t i = 0; i < blockSize; ++i )
+        {
+            for ( int d = DIMENSION_MIN; d <= DIMENSION_MAX; ++d )
+                results[first + i].dimensionsRelation[d] = RELATION_NONE;
+        }
+
+        for ( int k = DIMENSION_MIN; (k <= DIMENSION_MAX) && (candidates != 0); ++k )
+        {
+            int dimension = selectivity.order[k];
+            unsigned disjoint = 0;
+
+            if ( dimension == DIMENSION_PROTO )
+            {
+                for ( size_t i = 0; i < blockSize; ++i )
+                {
+                    if ( (candidates & (1U << i)) == 0 )
+                        continue;
+
+                    u_int8_t xFlags = rules.flags(x[i]);
+                    int protocolCode = yProtocolCode | (((xFlags & AclRuleStore::FLAG_PROTO_ANY) != 0) << 2) | ((xFlags & AclRuleStore::FLAG_PROTO_IPv4) != 0);
+                    protocolCode |= ((yProtocol == rules.protocolNumber(x[i])) && (yProtocolFlags == (xFlags & (AclRuleStore::FLAG_PROTO_ANY | AclRuleStore::FLAG_PROTO_IPv4)))) << 4;
+
+                    int relation = PROTOCOL_RELATION[protocolCode];
+                    results[first + i].dimensionsRelation[DIMENSION_PROTO] = relation;
+                    disjoint |= (relation == RELATION_NONE) << i;
+                }
+            }
+            else
+            {
+                for ( size_t i = 0; i < CLASSIFY_BLOCK; ++i )
+                {
+                    switch ( dimension )
+                    {
+                        case DIMENSION_SRC_IP:
+                            xStart[i] = rules.srcIpStart(x[i]) ^ COMPARE_BIAS;
+                            xStop[i] = rules.srcIpStop(x[i]) ^ COMPARE_BIAS;
+                            break;
+                        case DIMENSION_DST_IP:
+                            xStart[i] = rules.dstIpStart(x[i]) ^ COMPARE_BIAS;
+                            xStop[i] = rules.dstIpStop(x[i]) ^ COMPARE_BIAS;
+                            break;
+                        case DIMENSION_SRC_PRT:
+                            xStart[i] = rules.srcPortStart(x[i]) ^ COMPARE_BIAS;
+                            xStop[i] = rules.srcPortStop(x[i]) ^ COMPARE_BIAS;
+                            break;
+                        default:
+                            xStart[i] = rules.dstPortStart(x[i]) ^ COMPARE_BIAS;
+                            xStop[i] = rules.dstPortStop(x[i]) ^ COMPARE_BIAS;
+                            break;
+                    }
+                }
+
+                compareRangesBlock(yStart[dimension - DIMENSION_SRC_IP], yStop[dimension - DIMENSION_SRC_IP], xStart, xStop, rangeRelations);
+
+                for ( size_t i = 0; i < blockSize; ++i )
+                {
+                    if ( (candidates & (1U << i)) == 0 )
+                        continue;
+
+                    int relation = rangeRelations[i];
+                    if ( dimension == DIMENSION_SRC_PRT )
+                        relation = PORT_RELATION[relation][ySrcPortNeg | ((rules.flags(x[i]) & AclRuleStore::FLAG_SRC_PORT_NEG) != 0)];
+                    else if ( dimension == DIMENSION_DST_PRT )
+                        relation = PORT_RELATION[relation][yDstPortNeg | ((rules.flags(x[i]) & AclRuleStore::FLAG_DST_PORT_NEG) != 0)];
+
+                    results[first + i].dimensionsRelation[dimension] = relation;
+                    disjoint |= (relation == RELATION_NONE) << i;
+                }
+            }
+
+            selectivity.tested[dimension] += __builtin_popcount(candidates);
+            selectivity.disjoint[dimension] += __builtin_popcount(disjoint);
+            candidates &= ~disjoint;
+        }
+
+        /* combination of relations of rules, which are not disjoint in any dimension */
+        for ( size_t i = 0; i < blockSize; ++i )
+        {
+            if ( (candidates & (1U << i)) == 0 )
+            {
+                results[first + i].conflictType = CONFLICT_NONE;
+                continue;
+            }
+
+            const int* relations = results[first + i].dimensionsRelation;
+            int relation = RELATION_1_EQUIV_2;
+            for ( int d = DIMENSION_MIN; d <= DIMENSION_MAX; ++d )
+                relation = COMBINED_RELATION[relation][relations[d]];
+
+            results[first + i].conflictType = CONFLICT_BY_RELATION[relation][yAction == rules.action(x[i])];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method initializes the structure controlling the short-circuit classification.
+ *
+ * Counters are cleared and dimensions are ordered by the selectivity usual for ACLs: ranges
+ * of ports are most often disjoint, prefixes of IP addresses are rarely disjoint, because
+ * the forest of prefix trees returns only rules with overlapping prefixes.
+ *
+ * @param selectivity reference to the initialized structure.
+ */
+void Conflict::initSelectivity(DIMENSION_SELECTIVITY& selectivity)
+{
+    selectivity.order[0] = DIMENSION_DST_PRT;
+    selectivity.order[1] = DIMENSION_SRC_PRT;
+    selectivity.order[2] = DIMENSION_PROTO;
+    selectivity.order[3] = DIMENSION_DST_IP;
+    selectivity.order[4] = DIMENSION_SRC_IP;
+
+    for ( int d = DIMENSION_MIN; d <= DIMENSION_MAX; ++d )
+    {
+        selectivity.tested[d] = 0;
+        selectivity.disjoint[d] = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method orders dimensions by their measured selectivity.
+ *
+ * Dimensions are sorted by the ratio of disjoint and tested pairs of rules in the descending
+ * order, so the dimension which most often stops the classification is tested first. Order of
+ * dimensions with the same ratio is kept.
+ *
+ * @param selectivity reference to the structure with counters, whose order is updated.
+ */
+void Conflict::orderBySelectivity(DIMENSION_SELECTIVITY& selectivity)
+{
+    double ratio[DIMENSION_MAX + 1];
+
+    for ( int d = DIMENSION_MIN; d <= DIMENSION_MAX; ++d )
+        ratio[d] = (selectivity.tested[d] > 0) ? (double(selectivity.disjoint[d]) / selectivity.tested[d]) : 0;
+
+    /* insertion sort of five dimensions */
+    for ( int k = DIMENSION_MIN + 1; k <= DIMENSION_MAX; ++k )
+    {
+        int dimension = selectivity.order[k];
+        int j = k;
+
+        for ( ; (j > DIMENSION_MIN) && (ratio[selectivity.order[j - 1]] < ratio[dimension]); --j )
+            selectivity.order[j] = selectivity.order[j - 1];
+
+        selectivity.order[j] = dimension;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method compares the range of rule Y with ranges of CLASSIFY_BLOCK rules X.
+ *
+ * All values have to be biased by COMPARE_BIAS, so they can be compared by signed comparisons.
+ *
+ * @param yStart start value of the range of rule Y.
+ * @param yStop end value of the range of rule Y.
+ * @param xStart array of start values of ranges of rules X.
+ * @param xStop array of end values of ranges of rules X.
+ * @param relations array where relations (RELATION_XXX) of the range of Y to ranges of X are stored.
+ */
+void Conflict::compareRangesBlock(u_int32_t yStart, u_int32_t yStop, const u_int32_t* xStart, const u_int32_t* xStop, int* relations)
+{
+    unsigned disjoint = 0;      /* bit of the rule X is set, if ranges are disjoint */
+    unsigned notSubset = 0;     /* bit of the rule X is set, if Y is not the subset of X */
+    unsigned notSuperset = 0;   /* bit of the rule X is set, if Y is not the superset of X */
+
+    #if defined(__AVX2__)
+    __m256i ys = _mm256_set1_epi32((int) yStart);
+    __m256i ye = _mm256_set1_epi32((int) yStop);
+    __m256i xs = _mm256_loadu_si256((const __m256i*) xStart);
+    __m256i xe = _mm256_loadu_si256((const __m256i*) xStop);
+
+    disjoint = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpgt_epi32(xs, ye), _mm256_cmpgt_epi32(ys, xe))));
+    notSubset = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpgt_epi32(xs, ys), _mm256_cmpgt_epi32(ye, xe))));
+    notSuperset = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpgt_epi32(ys, xs), _mm256_cmpgt_epi32(xe, ye))));
+    #elif defined(__SSE2__)
+    __m128i ys = _mm_set1_epi32((int) yStart);
+    __m128i ye = _mm_set1_epi32((int) yStop);
+
+    for ( size_t i = 0; i < CLASSIFY_BLOCK; i += 4 )
+    {
+        __m128i xs = _mm_loadu_si128((const __m128i*) (xStart + i));
+        __m128i xe = _mm_loadu_si128((const __m128i*) (xStop + i));
+
+        disjoint |= _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_cmpgt_epi32(xs, ye), _mm_cmpgt_epi32(ys, xe)))) << i;
+        notSubset |= _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_cmpgt_epi32(xs, ys), _mm_cmpgt_epi32(ye, xe)))) << i;
+        notSuperset |= _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_cmpgt_epi32(ys, xs), _mm_cmpgt_epi32(xe, ye)))) << i;
+    }
+    #else
+    for ( size_t i = 0; i < CLASSIFY_BLOCK; ++i )
+    {
+        int32_t xs = xStart[i], xe = xStop[i], ys = yStart, ye = yStop;
+
+        disjoint |= ((xs > ye) || (ys > xe)) << i;
+        notSubset |= ((xs > ys) || (ye > xe)) << i;
+        notSuperset |= ((ys > xs) || (xe > ye)) << i;
+    }
+    #endif
+
+    for ( size_t i = 0; i < CLASSIFY_BLOCK; ++i )
+    {
+        int code = ((~disjoint >> i) & 1) << 2 | ((~notSubset >> i) & 1) << 1 | ((~notSuperset >> i) & 1);
+        relations[i] = RANGE_RELATION[code];
+    }
 }
 
 //-----------------------------------------------------------------------------------
@@ -346,6 +862,46 @@ int Conflict::compareTwoIpv4Ranges(const IP_ADDRESS& addr1_start, const IP_ADDRE
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Method compares two passed ranges of IPv4 addresses in the numerical form and return the result of the comparison.
+ *
+ * @param addr1_start start address of the first range (see AclRuleStore::ipToNumber()).
+ * @param addr1_stop end address of the first range.
+ * @param addr2_start start address of the second range.
+ * @param addr2_stop end address of the second range.
+ * @return value representing relation between the range addr1 (addr1_start - addr1_stop) and addr2 (addr2_start - addr2_stop).
+ *         if addr1 != addr2, returns value RELATION_NONE.
+ *         if addr1 == addr2, returns value RELATION_1_EQUIV_2.
+ *         if addr1 is the subset of addr2, returns value RELATION_1_SUBSET_2.
+ *         if addr1 is the superset of addr2, returns value RELATION_1_SUPERSET_2.
+ *         if sets addr1 and addr2 are interleaving, returns value RELATION_1_INTERLEAVING_2.
+ */
+int Conflict::compareTwoIpv4Ranges(u_int32_t addr1_start, u_int32_t addr1_stop, u_int32_t addr2_start, u_int32_t addr2_stop)
+{
+    if ( (addr1_stop < addr2_start) || (addr2_stop < addr1_start) )
+    {
+        return RELATION_NONE;
+    }
+    else if ( (addr1_start == addr2_start) && (addr1_stop == addr2_stop) )
+    {
+        return RELATION_1_EQUIV_2;
+    }
+    else if ( (addr1_start >= addr2_start) && (addr1_stop <= addr2_stop) )
+    {
+        return RELATION_1_SUBSET_2;
+    }
+    else if ( (addr1_start <= addr2_start) && (addr1_stop >= addr2_stop) )
+    {
+        return RELATION_1_SUPERSET_2;
+    }
+    else
+    {
+        return RELATION_1_INTERLEAVING_2;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
 /**
  * Method compares two passed ports and returns the result of the comparison.
  *
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "AclRule.hpp"
+#include "AccessControlList.hpp"
 
 #ifndef CONFLICT_HPP__6812754861346416844215346816484615848341862843847213845
 #define CONFLICT_HPP__6812754861346416844215346816484615848341862843847213845
@@ -47,6 +48,30 @@ const int RELATION_1_INTERLEAVING_2 = 4;        /** Sets 1 and 2 are interleavin
 const int RELATION_1_BIGGER_2 = 5;
 const int RELATION_1_SMALLER_2 = 6;
 
+/**
+ * Structure representing the result of the classification of the pair of rules.
+ *
+ * The structure can be evaluated on the stack (see Conflict::classifyResult()), object of class
+ * Conflict is created only when a real conflict is found.
+ */
+typedef struct {
+    int conflictType;                                   /** Type of the conflict (constant CONFLICT_XXX). */
+    int dimensionsRelation[DIMENSION_MAX + 1];          /** Relations of dimensions (constant RELATION_XXX). */
+} CONFLICT_RESULT;
+
+/**
+ * Structure controlling the short-circuit classification (see Conflict::classifyBatch()).
+ *
+ * Dimensions are tested in the passed order and testing of a pair of rules stops at the first
+ * dimension in which rules are disjoint. Counters collect the selectivity of dimensions, so the
+ * order can be adapted to the analysed ACL by Conflict::orderBySelectivity().
+ */
+typedef struct {
+    int order[DIMENSION_MAX + 1];                       /** Dimensions in the order in which they are tested. */
+    unsigned long tested[DIMENSION_MAX + 1];            /** Number of pairs of rules tested in the dimension. */
+    unsigned long disjoint[DIMENSION_MAX + 1];          /** Number of pairs of rules found disjoint in the dimension. */
+} DIMENSION_SELECTIVITY;
+
 /**
  * The class representing the result of the conflict analysis between the pair of AclRule rules.
  */
@@ -63,8 +88,13 @@ class Conflict
         void setConflictType(int type);
         void setDimensionRelation(int dimension, int relation);
 
+        static void compareRangesBlock(u_int32_t yStart, u_int32_t yStop, const u_int32_t* xStart, const u_int32_t* xStop, int* relations);
+
     public:
+        static const size_t CLASSIFY_BLOCK = 8;     /** Number of candidates compared at once by classifyBatch(). */
+
         Conflict(const AclRule& ruleX, const AclRule& ruleY);
+        Conflict(const AclRule& ruleX, const AclRule& ruleY, const CONFLICT_RESULT& result);
         virtual ~Conflict();
 
         int conflictType() const;
@@ -75,13 +105,23 @@ class Conflict
         int getDimensionsRelation(int dimension) const throw(Exception);
         
         static std::auto_ptr< Conflict > classifyConflict(const AclRule& ruleX, const AclRule& ruleY);
+        static std::auto_ptr< Conflict > classifyConflict(const AccessControlList& acl, size_t ruleXIndex, size_t ruleYIndex);
+        static CONFLICT_RESULT classifyResult(const AclRule& ruleX, const AclRule& ruleY);
+        static CONFLICT_RESULT classifyResult(const AccessControlList& acl, size_t ruleXIndex, size_t ruleYIndex);
 
         /********* STATIC methods *********/
-        static void classifyByRange(Conflict& newObject, const AclRule& ruleX, const AclRule& ruleY);
+        static void classifyByRange(CONFLICT_RESULT& result, const AclRule& ruleX, const AclRule& ruleY);
+        static void classifyByRange(CONFLICT_RESULT& result, const AclRuleStore& rules, size_t ruleXIndex, size_t ruleYIndex);
+        static void classifyBatch(const AclRuleStore& rules, size_t ruleYIndex, const int32_t* ruleXIndexes, size_t count, CONFLICT_RESULT* results);
+        static void classifyBatch(const AclRuleStore& rules, size_t ruleYIndex, const int32_t* ruleXIndexes, size_t count, CONFLICT_RESULT* results,
+                                  DIMENSION_SELECTIVITY& selectivity);
+        static void initSelectivity(DIMENSION_SELECTIVITY& selectivity);
+        static void orderBySelectivity(DIMENSION_SELECTIVITY& selectivity);
 //        static void classifyByPrefix(Conflict& newObject, const AclRule& ruleX, const AclRule& ruleY);
 
         static int compareTwoIPv4Addr(const IP_ADDRESS& addr1, const IP_ADDRESS& addr2);
         static int compareTwoIpv4Ranges(const IP_ADDRESS& addr1_start, const IP_ADDRESS& addr1_stop, const IP_ADDRESS& addr2_start, const IP_ADDRESS& addr2_stop);
+        static int compareTwoIpv4Ranges(u_int32_t addr1_start, u_int32_t addr1_stop, u_int32_t addr2_start, u_int32_t addr2_stop);
         static int compareTwoPortValues(u_int16_t port1, u_int16_t port2);
         static int compareTwoPortRanges(u_int16_t port1_start, u_int16_t port1_stop, u_int16_t port2_start, u_int16_t port2_stop);
         static int compareTwoPortRanges(u_int16_t port1_start, u_int16_t port1_stop, bool port1_neg, u_int16_t port2_start, u_int16_t port2_stop, bool port2_neg);
@@ -0,0 +1,92 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+
+#include "AclRule.hpp"
+#include "AccessControlList.hpp"
+
+#ifndef DIMENSION_INDEX_HPP__5019283746501928374656473829105647382910564738291056
+#define DIMENSION_INDEX_HPP__5019283746501928374656473829105647382910564738291056
+
+/**
+ * Constants representing the structure used for one dimension of the forest (see PrefixForest).
+ */
+const int INDEX_BINARY_TRIE = 0;        /** Binary prefix tree PrefixTree with one node per bit of the prefix. */
+const int INDEX_PATRICIA_TRIE = 1;      /** Path-compressed prefix tree PatriciaTree. */
+const int INDEX_MULTIBIT_TRIE = 2;      /** Multibit prefix tree MultibitTree with strides 8-8-8-8 for IP addresses, PrefixTree for other dimensions. */
+const int INDEX_MULTIBIT_WIDE_TRIE = 3; /** Multibit prefix tree MultibitTree with strides 16-8-8 for IP addresses, PrefixTree for other dimensions. */
+const int INDEX_DIRECT_TABLES = 4;      /** ProtocolTable for protocols, PortIntervalTable for ports and MultibitTree (8-8-8-8) for IP addresses. */
+
+/**
+ * Class DimensionIndex represents the interface of the structure finding conflicting rules in one dimension.
+ *
+ * Rules are added in the order of the ACL and for every added rule the structure returns the conflict
+ * bit vector of the dimension, i.e. the vector with set bits of already added rules, whose field
+ * of the dimension overlaps with the field of the added rule. The vector can contain more rules
+ * (e.g. prefix trees compare "super-prefixes" of ranges, see PrefixTree), but never less.
+ *
+ * Structure can be also built from all rules of the ACL at once (see bulkLoad()). Afterwards adding
+ * the rule only computes its conflict vector, which contains also rules following the added rule.
+ */
+template < class BitVector >
+class DimensionIndex
+{
+    public:
+        virtual ~DimensionIndex() { };
+
+        /**
+         * Method adds new rule to the structure and stores its conflict bit vector of the dimension.
+         *
+         * @param rule reference to the added rule.
+         * @param conflictVector reference to the bit vector of the ACL size where the conflict
+         *                       bit vector of the dimension is stored.
+         */
+        virtual void addNewRule(const AclRule& rule, BitVector& conflictVector) = 0;
+
+        /**
+         * Method builds the structure from all rules of the ACL at once.
+         *
+         * After the successful load, rules of the ACL are not inserted by addNewRule() any more,
+         * it only computes their conflict vectors. Structures which do not support the bulk load
+         * return false and rules are inserted into them one by one.
+         *
+         * @param acl reference to the ACL whose rules are loaded (its size has to be the size of the structure).
+         * @return true if the structure was built from the ACL, false otherwise.
+         */
+        virtual bool bulkLoad(const AccessControlList& acl) { return false; }
+
+        /**
+         * Method returns the conflict bit vector of the rule of the ACL loaded by bulkLoad().
+         *
+         * Returned vector is owned by the structure and contains also rules following the rule.
+         *
+         * @param rule reference to the rule of the loaded ACL.
+         * @return pointer to the conflict vector, NULL if the structure was not built by bulkLoad().
+         */
+        virtual const BitVector* getLoadedConflictVector(const AclRule& rule) { return NULL; }
+
+        /**
+         * Method returns the number of nodes (or entries) allocated by the structure.
+         *
+         * @return number of nodes of the structure.
+         */
+        virtual size_t numOfNodes() const = 0;
+};
+
+#endif /* DIMENSION_INDEX_HPP__5019283746501928374656473829105647382910564738291056 */
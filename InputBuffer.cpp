@@ -0,0 +1,276 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <string>
+
+#include "InputBuffer.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * Constructs empty buffer, data are set by factory methods.
+ */
+InputBuffer::InputBuffer() : m_data(NULL), m_size(0), m_mappedSize(0) { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ *
+ * Memory mapping is removed, memory of the caller passed to fromMemory() is not freed.
+ */
+InputBuffer::~InputBuffer()
+{
+    if ( m_mappedSize > 0 )
+        munmap(m_data, m_mappedSize);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the pointer to the data.
+ *
+ * @return pointer to the writable data terminated by '\0'.
+ */
+char* InputBuffer::data()
+{
+    return m_data;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the size of the data.
+ *
+ * @return size of the data in bytes without the terminating '\0'.
+ */
+size_t InputBuffer::size() const
+{
+    return m_size;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns if the data are mapped from the file.
+ *
+ * @return true if data are mapped by the private mapping, false otherwise.
+ */
+bool InputBuffer::isMapped() const
+{
+    return m_mappedSize > 0;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method maps the regular file into the memory by the private (copy-on-write) mapping.
+ *
+ * The mapping is one byte longer than the file. If the file ends at the page boundary,
+ * the byte is in the anonymous page mapped behind the file, so it can be always set to '\0'.
+ *
+ * @throw Exception if the file can not be mapped.
+ * @param fd file descriptor of the regular file.
+ * @param size size of the file.
+ */
+void InputBuffer::mapFile(int fd, size_t size) throw(Exception)
+{
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t mappedSize = ((size / pageSize) + 1) * pageSize;
+
+    void* area = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ( area == MAP_FAILED )
+        throw Exception(string("Cannot map input file! ") + strerror(errno));
+
+    if ( (size > 0) && (mmap(area, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) )
+    {
+        int error = errno;
+        munmap(area, mappedSize);
+        throw Exception(string("Cannot map input file! ") + strerror(error));
+    }
+
+    madvise(area, mappedSize, MADV_SEQUENTIAL);
+
+    m_data = (char*) area;
+    m_size = size;
+    m_mappedSize = mappedSize;
+    m_data[m_size] = '\0';
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method reads all data from passed file descriptor into the memory on the heap.
+ *
+ * @throw Exception if reading fails.
+ * @param fd file descriptor.
+ */
+void InputBuffer::readAll(int fd) throw(Exception)
+{
+    size_t size = 0;
+    m_heap.resize(64 * 1024);
+
+    while ( true )
+    {
+        if ( size == m_heap.size() )
+            m_heap.resize(m_heap.size() * 2);
+
+        ssize_t count = read(fd, &m_heap[size], m_heap.size() - size);
+        if ( count == 0 )
+            break;
+
+        if ( count < 0 )
+        {
+            if ( errno == EINTR )
+                continue;
+
+            throw Exception(string("Cannot read input file! ") + strerror(errno));
+        }
+
+        size += count;
+    }
+
+    m_heap.resize(size + 1);
+    m_heap[size] = '\0';
+
+    m_data = &m_heap[0];
+    m_size = size;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method creates the buffer with the content of the file with passed name.
+ *
+ * @throw Exception if the file can not be opened or mapped.
+ * @param fileName pointer to the string containing the name of the file.
+ * @return smart pointer to the new buffer.
+ */
+std::auto_ptr< InputBuffer > InputBuffer::fromFile(const char* fileName) throw(Exception)
+{
+    int fd = open(fileName, O_RDONLY);
+    if ( fd < 0 )
+        throw Exception(strerror(errno));
+
+    try {
+        auto_ptr< InputBuffer > buffer = fromDescriptor(fd);
+        close(fd);
+
+        return buffer;
+    }
+    catch ( ... )
+    {
+        close(fd);
+        throw;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method creates the buffer with the content of passed file descriptor.
+ *
+ * Regular files are mapped into the memory, other descriptors (pipes, sockets)
+ * are read to the end. Descriptor is not closed and can be closed right after the call.
+ *
+ * @throw Exception if reading or mapping fails.
+ * @param fd file descriptor opened for reading.
+ * @return smart pointer to the new buffer.
+ */
+std::auto_ptr< InputBuffer > InputBuffer::fromDescriptor(int fd) throw(Exception)
+{
+    auto_ptr< InputBuffer > buffer(new InputBuffer());
+    struct stat info;
+
+    if ( fstat(fd, &info) < 0 )
+        throw Exception(string("Cannot get the size of input file! ") + strerror(errno));
+
+    if ( S_ISREG(info.st_mode) )
+        buffer->mapFile(fd, info.st_size);
+    else
+        buffer->readAll(fd);
+
+    return buffer;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method creates the buffer with the content of passed stream.
+ *
+ * Stream is read into the memory on the heap (copy of the data).
+ *
+ * @throw Exception if reading of the stream fails.
+ * @param inputStream reference to the input stream.
+ * @return smart pointer to the new buffer.
+ */
+std::auto_ptr< InputBuffer > InputBuffer::fromStream(std::istream& inputStream) throw(Exception)
+{
+    auto_ptr< InputBuffer > buffer(new InputBuffer());
+    size_t size = 0;
+    char chunk[64 * 1024];
+
+    while ( inputStream.read(chunk, sizeof(chunk)) || (inputStream.gcount() > 0) )
+    {
+        buffer->m_heap.insert(buffer->m_heap.end(), chunk, chunk + inputStream.gcount());
+        size += inputStream.gcount();
+    }
+
+    if ( inputStream.bad() )
+        throw Exception("Cannot read input stream!");
+
+    buffer->m_heap.push_back('\0');
+    buffer->m_data = &buffer->m_heap[0];
+    buffer->m_size = size;
+
+    return buffer;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method creates the buffer using passed memory of the caller.
+ *
+ * Data are not copied, so the memory has to exist during the whole life of the buffer
+ * and it will be modified by in-situ parsers.
+ *
+ * @throw Exception if the data are not terminated by '\0'.
+ * @param data pointer to the writable memory with at least size + 1 bytes, data[size] has to be '\0'.
+ * @param size size of the data without the terminating '\0'.
+ * @return smart pointer to the new buffer.
+ */
+std::auto_ptr< InputBuffer > InputBuffer::fromMemory(char* data, size_t size) throw(Exception)
+{
+    if ( (data == NULL) || (data[size] != '\0') )
+        throw Exception("Input data are not terminated by '\\0'!");
+
+    auto_ptr< InputBuffer > buffer(new InputBuffer());
+    buffer->m_data = data;
+    buffer->m_size = size;
+
+    return buffer;
+}
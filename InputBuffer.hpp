@@ -0,0 +1,75 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <memory>
+#include <istream>
+#include <streambuf>
+#include <vector>
+
+#include "Exception.hpp"
+
+#ifndef INPUT_BUFFER_HPP__4710293847561029384756102938475610293847561029384756
+#define INPUT_BUFFER_HPP__4710293847561029384756102938475610293847561029384756
+
+/**
+ * Class InputBuffer holds the whole input configuration in the writable memory terminated by '\0'.
+ *
+ * Parsers working in-situ (e.g. rapidxml) can modify the data directly. Files and file descriptors
+ * of regular files are mapped into the memory by the private (copy-on-write) mapping, so the file
+ * is neither read into another buffer nor modified. Other descriptors and streams are read into
+ * the buffer allocated on the heap. Buffer can also wrap the memory of the caller without copying.
+ */
+class InputBuffer
+{
+    public:
+        /**
+         * Class StreamBuf allows to read the data of the buffer by std::istream without copying.
+         */
+        class StreamBuf : public std::streambuf
+        {
+            public:
+                StreamBuf(InputBuffer& buffer) { setg(buffer.data(), buffer.data(), buffer.data() + buffer.size()); };
+        };
+
+    private:
+        char* m_data;                   /** Pointer to the data terminated by '\0'. */
+        size_t m_size;                  /** Size of the data without the terminating '\0'. */
+        size_t m_mappedSize;            /** Size of the memory mapping, 0 if data are not mapped. */
+        std::vector< char > m_heap;     /** Memory of the data read from the descriptor or the stream. */
+
+        InputBuffer();
+        InputBuffer(const InputBuffer&);
+        InputBuffer& operator=(const InputBuffer&);
+
+        void readAll(int fd) throw(Exception);
+        void mapFile(int fd, size_t size) throw(Exception);
+
+    public:
+        virtual ~InputBuffer();
+
+        char* data();
+        size_t size() const;
+        bool isMapped() const;
+
+        static std::auto_ptr< InputBuffer > fromFile(const char* fileName) throw(Exception);
+        static std::auto_ptr< InputBuffer > fromDescriptor(int fd) throw(Exception);
+        static std::auto_ptr< InputBuffer > fromStream(std::istream& inputStream) throw(Exception);
+        static std::auto_ptr< InputBuffer > fromMemory(char* data, size_t size) throw(Exception);
+};
+
+#endif /* INPUT_BUFFER_HPP__4710293847561029384756102938475610293847561029384756 */
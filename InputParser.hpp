@@ -23,6 +23,7 @@
 #include "ProtocolsDef.hpp"
 #include "PortsDef.hpp"
 #include "AccessControlList.hpp"
+#include "InputBuffer.hpp"
 
 #ifndef INPUT_PARSER_H__56123789526737128938076372894801283804
 #define INPUT_PARSER_H__56123789526737128938076372894801283804
@@ -33,12 +34,24 @@
  * Class declares virtual method "parse()", which must be implemented by any input parser.
  * The return value of the method is pointer to the vector
  * of access lists that contain the rules contained in input stream.
+ *
+ * Parsers can also parse the whole input held by InputBuffer (e.g. the memory mapped file).
+ * By default the buffer is read as the stream without copying, parsers working in-situ
+ * override the method and parse the buffer directly.
  */
 class InputParser
 {
     public:
         virtual ~InputParser() { };
         virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(std::istream& inputStream) = 0;
+
+        virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(InputBuffer& input)
+        {
+            InputBuffer::StreamBuf streamBuf(input);
+            std::istream inputStream(&streamBuf);
+
+            return parse(inputStream);
+        };
 };
 
 #endif /* INPUT_PARSER_H__56123789526737128938076372894801283804 */
\ No newline at end of file
@@ -48,6 +48,7 @@ class JuniperInputParser : public InputParser
         JuniperInputParser() { };
         virtual ~JuniperInputParser() { };
         virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(std::istream& inputStream);
+        virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(InputBuffer& input);
 };
 
 #endif /* JUNIPER_INPUTPARSER_HPP__5738956718923456885728987324657328435421947165873429 */
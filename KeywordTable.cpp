@@ -0,0 +1,175 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cctype>
+#include <cstring>
+
+#include "KeywordTable.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * Constructor builds the collision-free table of passed keywords. Tables with 2 slots for every
+ * keyword (rounded up to the power of two) are tried first with several seeds of the hash function,
+ * if all of them collide, the size of the table is doubled. If the keyword is contained in the array
+ * more than once, only its first occurrence is used.
+ *
+ * @param keywords pointer to the array of keywords.
+ * @param count number of keywords in the array.
+ */
+KeywordTable::KeywordTable(const KEYWORD* keywords, size_t count) : m_seed(0), m_mask(0)
+{
+    size_t size = 1;
+
+    while ( size < 2 * count )
+    {
+        size <<= 1;
+    }
+
+    for ( ; ; size <<= 1 )
+    {
+        for ( u_int32_t seed = 0; seed < MAX_SEEDS; ++seed )
+        {
+            if ( build(keywords, count, size, seed) )
+            {
+                return;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method computes the hash of the token (FNV-1a with the seed).
+ *
+ * @param str pointer to the first character of the token.
+ * @param length length of the token.
+ * @param seed seed of the hash function.
+ * @return hash of the token.
+ */
+u_int32_t KeywordTable::hash(const char* str, unsigned length, u_int32_t seed)
+{
+    u_int32_t h = 2166136261U ^ (seed * 0x9E3779B9U);
+
+    for ( unsigned i = 0; i < length; ++i )
+    {
+        h ^= (unsigned char)str[i];
+        h *= 16777619U;
+    }
+
+    return h ^ (h >> 15);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method tries to build the table of entered size with entered seed of the hash function.
+ *
+ * @param keywords pointer to the array of keywords.
+ * @param count number of keywords in the array.
+ * @param size number of slots of the table (power of two).
+ * @param seed seed of the hash function.
+ * @return true if no two different keywords collide, false otherwise.
+ */
+bool KeywordTable::build(const KEYWORD* keywords, size_t count, size_t size, u_int32_t seed)
+{
+    KEYWORD empty = { NULL, 0 };
+
+    m_slots.assign(size, empty);
+    m_lengths.assign(size, 0);
+    m_seed = seed;
+    m_mask = (u_int32_t)(size - 1);
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+        unsigned length = strlen(keywords[i].name);
+        u_int32_t slot = hash(keywords[i].name, length, seed) & m_mask;
+
+        if ( m_slots[slot].name == NULL )
+        {
+            m_slots[slot] = keywords[i];
+            m_lengths[slot] = length;
+        }
+        else if ( (m_lengths[slot] != length) || (memcmp(m_slots[slot].name, keywords[i].name, length) != 0) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method looks up the token in the table.
+ *
+ * @param str pointer to the first character of the token (need not be terminated).
+ * @param length length of the token.
+ * @param value reference to variable where the value of found keyword will be stored.
+ * @return true if the token is a keyword, false otherwise.
+ */
+bool KeywordTable::find(const char* str, unsigned length, int& value) const
+{
+    u_int32_t slot = hash(str, length, m_seed) & m_mask;
+
+    if ( (m_lengths[slot] != length) || (m_slots[slot].name == NULL) || (memcmp(m_slots[slot].name, str, length) != 0) )
+    {
+        return false;
+    }
+
+    value = m_slots[slot].value;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of slots of the table.
+ *
+ * @return number of slots of the table.
+ */
+size_t KeywordTable::size() const
+{
+    return m_slots.size();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the length of the token at the beginning of passed string.
+ *
+ * Token ends with the first white character or with the end of the string.
+ *
+ * @param str pointer to string beginning with the token.
+ * @return number of characters of the token.
+ */
+unsigned KeywordTable::tokenLength(const char* str)
+{
+    unsigned length = 0;
+
+    while ( (str[length] != '\0') && !isspace((unsigned char)str[length]) )
+    {
+        length++;
+    }
+
+    return length;
+}
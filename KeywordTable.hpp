@@ -0,0 +1,66 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <vector>
+#include <sys/types.h>
+
+#ifndef KEYWORD_TABLE_HPP__2864019375610293847561928374650192837465019283746501
+#define KEYWORD_TABLE_HPP__2864019375610293847561928374650192837465019283746501
+
+/**
+ * Structure representing one keyword of the configuration language and its value.
+ */
+typedef struct keyword
+{
+    const char* name;       /** Keyword, e.g. name of the port or protocol. */
+    int value;              /** Value of the keyword, e.g. port or protocol number. */
+} KEYWORD;
+
+/**
+ * Class KeywordTable recognizes keywords of the configuration by one lookup into the hash table.
+ *
+ * The table is built from the static array of keywords (see PortsDef.hpp and ProtocolsDef.hpp).
+ * The seed of the hash function and the size of the table are chosen when the table is built
+ * so that no two keywords share a slot (perfect hashing). The lookup hashes the token once and
+ * compares it only with the keyword stored in its slot.
+ */
+class KeywordTable
+{
+    private:
+        std::vector< KEYWORD > m_slots;         /** Slots of the table, name is NULL in empty slots. */
+        std::vector< unsigned > m_lengths;      /** Lengths of keywords stored in slots. */
+        u_int32_t m_seed;                       /** Seed of the hash function. */
+        u_int32_t m_mask;                       /** Mask of the slot index (size of the table - 1). */
+
+        static const unsigned MAX_SEEDS = 256;  /** Number of seeds tried before the size of the table is doubled. */
+
+        static u_int32_t hash(const char* str, unsigned length, u_int32_t seed);
+        bool build(const KEYWORD* keywords, size_t count, size_t size, u_int32_t seed);
+
+    public:
+        KeywordTable(const KEYWORD* keywords, size_t count);
+        virtual ~KeywordTable() { };
+
+        bool find(const char* str, unsigned length, int& value) const;
+        size_t size() const;
+
+        static unsigned tokenLength(const char* str);
+};
+
+#endif /* KEYWORD_TABLE_HPP__2864019375610293847561928374650192837465019283746501 */
@@ -0,0 +1,77 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+
+#include "LineScanner.hpp"
+
+/**
+ * Class constructor.
+ *
+ * @param input reference to the buffer containing the input, its new-line characters are overwritten by '\0'.
+ */
+LineScanner::LineScanner(InputBuffer& input) : m_position(input.data()), m_end(input.data() + input.size()), m_line(NULL), m_unread(false) { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the next line of the input.
+ *
+ * @return pointer to the line terminated by '\0' (without '\n'), NULL at the end of the input.
+ */
+const char* LineScanner::nextLine()
+{
+    if ( m_unread )
+    {
+        m_unread = false;
+        return m_line;
+    }
+
+    if ( m_position >= m_end )
+    {
+        return NULL;
+    }
+
+    m_line = m_position;
+
+    char* newLine = (char*) memchr(m_position, '\n', m_end - m_position);
+    if ( newLine != NULL )
+    {
+        *newLine = '\0';
+        m_position = newLine + 1;
+    }
+    else
+    {
+        m_position = m_end;
+    }
+
+    return m_line;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the last read line back, so it is returned again by the next call of nextLine().
+ */
+void LineScanner::unreadLine()
+{
+    if ( m_line != NULL )
+    {
+        m_unread = true;
+    }
+}
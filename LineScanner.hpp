@@ -0,0 +1,47 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "InputBuffer.hpp"
+
+#ifndef LINE_SCANNER_HPP__9182736450192837465019283746501928374650192837465019
+#define LINE_SCANNER_HPP__9182736450192837465019283746501928374650192837465019
+
+/**
+ * Class LineScanner splits the input held by InputBuffer into lines without copying.
+ *
+ * Every returned line is terminated in place by replacing its '\n' with '\0', so lines have
+ * no length limit and the data are read only once. The last read line can be returned back
+ * by unreadLine() and it is returned again by the next call of nextLine().
+ */
+class LineScanner
+{
+    private:
+        char* m_position;       /** Pointer to the beginning of the next unread line. */
+        char* m_end;            /** Pointer to the terminating '\0' of the buffer. */
+        char* m_line;           /** Pointer to the last read line. */
+        bool m_unread;          /** Flag, that the last read line was returned back. */
+
+    public:
+        LineScanner(InputBuffer& input);
+        virtual ~LineScanner() { };
+
+        const char* nextLine();
+        void unreadLine();
+};
+
+#endif /* LINE_SCANNER_HPP__9182736450192837465019283746501928374650192837465019 */
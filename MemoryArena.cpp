@@ -0,0 +1,175 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "MemoryArena.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * No memory is allocated until the first request.
+ */
+MemoryArena::MemoryArena() : m_blockPos(NULL), m_blockFree(0), m_nextBlockBytes(FIRST_BLOCK_BYTES)
+{
+    for ( size_t i = 0; i < NUM_OF_CLASSES; ++i )
+        m_freeChunks[i] = NULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor, all blocks and large chunks are freed.
+ */
+MemoryArena::~MemoryArena()
+{
+    for ( size_t i = 0; i < m_blocks.size(); ++i )
+        ::operator delete(m_blocks[i]);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the size class of passed number of bytes.
+ *
+ * Classes 0-15 are multiples of 16 bytes up to 256 bytes, every following power of two
+ * is split into four classes.
+ *
+ * @param bytes number of requested bytes (at least 1).
+ * @return index of the smallest size class which fits the request.
+ */
+size_t MemoryArena::sizeClass(size_t bytes)
+{
+    if ( bytes <= 256 )
+        return (bytes + 15) / 16 - 1;
+
+    size_t value = bytes - 1;
+    size_t power = 8;
+
+    while ( (value >> (power + 1)) != 0 )
+        ++power;
+
+    return 16 + (power - 8) * 4 + ((value >> (power - 2)) & 3);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of bytes of chunks of passed size class.
+ *
+ * @param sizeClass index of the size class.
+ * @return size of chunks of the class in bytes.
+ */
+size_t MemoryArena::classBytes(size_t sizeClass)
+{
+    if ( sizeClass < 16 )
+        return (sizeClass + 1) * 16;
+
+    size_t power = 8 + (sizeClass - 16) / 4;
+
+    return (5 + (sizeClass - 16) % 4) << (power - 2);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method allocates new block (or large chunk) which is freed with the arena.
+ *
+ * @param bytes size of the block.
+ * @return pointer to the block.
+ */
+void* MemoryArena::allocateBlock(size_t bytes)
+{
+    m_blocks.reserve(m_blocks.size() + 1);
+    m_blocks.push_back(::operator new(bytes));
+
+    return m_blocks.back();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method allocates memory of passed size.
+ *
+ * Free chunk of the size class of the request is reused if there is one. Otherwise the chunk
+ * is cut from the last block, the rest of the last block is kept as a free chunk if it is too
+ * small and new block is allocated.
+ *
+ * @param bytes number of requested bytes.
+ * @return pointer to the memory aligned to 16 bytes.
+ */
+void* MemoryArena::allocate(size_t bytes)
+{
+    size_t chunkClass = sizeClass((bytes != 0) ? bytes : 1);
+
+    if ( m_freeChunks[chunkClass] != NULL )
+    {
+        FreeChunk* chunk = m_freeChunks[chunkClass];
+        m_freeChunks[chunkClass] = chunk->m_next;
+        return chunk;
+    }
+
+    size_t chunkBytes = classBytes(chunkClass);
+
+    if ( chunkBytes >= LARGE_CHUNK_BYTES )
+        return allocateBlock(chunkBytes);
+
+    if ( chunkBytes > m_blockFree )
+    {
+        /* the rest of the last block is kept in the largest class which fits into it */
+        if ( m_blockFree >= 16 )
+        {
+            size_t restClass = sizeClass(m_blockFree);
+
+            if ( classBytes(restClass) > m_blockFree )
+                --restClass;
+
+            deallocate(m_blockPos, classBytes(restClass));
+        }
+
+        m_blockFree = (chunkBytes < m_nextBlockBytes) ? m_nextBlockBytes : chunkBytes;
+        m_blockPos = static_cast< char* >(allocateBlock(m_blockFree));
+        m_nextBlockBytes = ((2 * m_nextBlockBytes) < MAX_BLOCK_BYTES) ? (2 * m_nextBlockBytes) : MAX_BLOCK_BYTES;
+    }
+
+    void* chunk = m_blockPos;
+    m_blockPos += chunkBytes;
+    m_blockFree -= chunkBytes;
+
+    return chunk;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method frees memory allocated by allocate(), the memory is kept for the next request of its size class.
+ *
+ * @param pointer pointer to the memory, NULL is ignored.
+ * @param bytes number of bytes passed to allocate().
+ */
+void MemoryArena::deallocate(void* pointer, size_t bytes)
+{
+    if ( pointer == NULL )
+        return;
+
+    size_t chunkClass = sizeClass((bytes != 0) ? bytes : 1);
+    FreeChunk* chunk = static_cast< FreeChunk* >(pointer);
+
+    chunk->m_next = m_freeChunks[chunkClass];
+    m_freeChunks[chunkClass] = chunk;
+}
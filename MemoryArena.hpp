@@ -0,0 +1,144 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <new>
+#include <vector>
+#include <cstddef>
+
+#ifndef MEMORY_ARENA_H__4710293847561029384756102938475610293847561029384756
+#define MEMORY_ARENA_H__4710293847561029384756102938475610293847561029384756
+
+/**
+ * Class MemoryArena allocates memory of any size from large blocks.
+ *
+ * Requests are rounded up to size classes (multiples of 16 bytes up to 256 bytes, then four
+ * classes per power of two), so freed chunks are kept in the list of their class and reused
+ * by the next request of the same class. Blocks grow from FIRST_BLOCK_BYTES up to MAX_BLOCK_BYTES,
+ * larger requests get their own chunks. Memory is returned to the system only when the arena
+ * is destroyed, so everything allocated from the arena has to be freed (destructed) before.
+ *
+ * The arena is not thread-safe, every arena has to be used by one thread at a time.
+ */
+class MemoryArena
+{
+    private:
+        static const size_t FIRST_BLOCK_BYTES = 64 * 1024;      /** Size of the first block. */
+        static const size_t MAX_BLOCK_BYTES = 1024 * 1024;      /** Maximum size of one block. */
+        static const size_t LARGE_CHUNK_BYTES = 256 * 1024;     /** Minimum size of chunks allocated apart from blocks. */
+        static const size_t NUM_OF_CLASSES = 240;               /** Number of size classes. */
+
+        /**
+         * Structure representing free chunk in the list of its size class.
+         */
+        struct FreeChunk
+        {
+            FreeChunk* m_next;          /** Next free chunk of the same size class. */
+        };
+
+        std::vector< void* > m_blocks;                  /** Allocated blocks and large chunks. */
+        char* m_blockPos;                               /** Not yet used memory of the last block. */
+        size_t m_blockFree;                             /** Number of not yet used bytes of the last block. */
+        size_t m_nextBlockBytes;                        /** Size of the next block. */
+        FreeChunk* m_freeChunks[NUM_OF_CLASSES];        /** Lists of free chunks of all size classes. */
+
+        MemoryArena(const MemoryArena& arena);                  /** Arena can not be copied. */
+        MemoryArena& operator = (const MemoryArena& arena);     /** Arena can not be assigned. */
+
+        void* allocateBlock(size_t bytes);
+
+        static size_t sizeClass(size_t bytes);
+        static size_t classBytes(size_t sizeClass);
+
+    public:
+        MemoryArena();
+        ~MemoryArena();
+
+        void* allocate(size_t bytes);
+        void deallocate(void* pointer, size_t bytes);
+};
+
+/**
+ * Class ArenaAllocator is the allocator of STL containers taking memory from MemoryArena.
+ *
+ * Allocator without an arena (constructed by the default constructor) takes memory from the heap,
+ * so containers using it are interchangeable with containers stored in the arena. Containers copy
+ * the allocator of the copied container and exchange allocators together with their memory by swap().
+ */
+template < class T >
+class ArenaAllocator
+{
+    private:
+        MemoryArena* m_arena;       /** Arena providing memory, NULL if the memory is taken from the heap. */
+
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template < class U >
+        struct rebind
+        {
+            typedef ArenaAllocator< U > other;
+        };
+
+        ArenaAllocator(MemoryArena* arena = NULL) : m_arena(arena) { }
+
+        template < class U >
+        ArenaAllocator(const ArenaAllocator< U >& allocator) : m_arena(allocator.arena()) { }
+
+        MemoryArena* arena() const { return m_arena; }
+
+        pointer allocate(size_type count, const void* hint = 0)
+        {
+            (void) hint;
+            size_t bytes = count * sizeof(T);
+            return static_cast< pointer >((m_arena != NULL) ? m_arena->allocate(bytes) : ::operator new(bytes));
+        }
+
+        void deallocate(pointer ptr, size_type count)
+        {
+            if ( m_arena != NULL )
+                m_arena->deallocate(ptr, count * sizeof(T));
+            else
+                ::operator delete(ptr);
+        }
+
+        void construct(pointer ptr, const T& value) { new (ptr) T(value); }
+        void destroy(pointer ptr) { ptr->~T(); }
+        pointer address(reference value) const { return &value; }
+        const_pointer address(const_reference value) const { return &value; }
+        size_type max_size() const { return static_cast< size_type >(-1) / sizeof(T); }
+};
+
+template < class T, class U >
+inline bool operator == (const ArenaAllocator< T >& allocator1, const ArenaAllocator< U >& allocator2)
+{
+    return allocator1.arena() == allocator2.arena();
+}
+
+template < class T, class U >
+inline bool operator != (const ArenaAllocator< T >& allocator1, const ArenaAllocator< U >& allocator2)
+{
+    return allocator1.arena() != allocator2.arena();
+}
+
+#endif /* MEMORY_ARENA_H__4710293847561029384756102938475610293847561029384756 */
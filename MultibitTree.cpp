@@ -0,0 +1,364 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+
+#include "MultibitTree.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * @param length number of bits of the prefix.
+ */
+template < class BitVector >
+MultibitTree< BitVector >::PrefixEntry::PrefixEntry(u_int8_t length) : m_bitVector1(NULL), m_bitVector2(NULL), m_parent(NULL), m_length(length)
+{
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+template < class BitVector >
+MultibitTree< BitVector >::PrefixEntry::~PrefixEntry() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class constructor.
+ *
+ * Constructs the node with empty slots.
+ *
+ * @param stride number of bits consumed by the node.
+ */
+template < class BitVector >
+MultibitTree< BitVector >::TreeNode::TreeNode(unsigned stride) : m_slots(new NodeSlot[1U << stride])
+{
+    for ( u_int32_t i = 0; i < (1U << stride); ++i )
+    {
+        m_slots[i].m_child = NULL;
+        m_slots[i].m_entry = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+template < class BitVector >
+MultibitTree< BitVector >::TreeNode::~TreeNode()
+{
+    delete [] m_slots;
+}
+
+
+/*************************************************************/
+/*********************** MULTIBIT TREE ***********************/
+
+/**
+ * Class constructor.
+ *
+ * @param aclSize number of rules in ACL for which is this prefix tree used.
+ * @param dimension dimension of rules added by addNewRule() (constant DIMENSION_XXX).
+ * @param strides array of strides of levels terminated by 0 (e.g. STRIDES_8_8_8_8). Every stride
+ *                has to be at most 24 bits and their sum at least the maximal length of prefixes.
+ * @param arena pointer to the arena providing blocks of pools of nodes, prefixes and bit vectors, NULL if they are
+ *              taken from the heap. The arena has to exist until the tree is destroyed.
+ */
+template < class BitVector >
+MultibitTree< BitVector >::MultibitTree(u_int32_t aclSize, int dimension, const u_int8_t* strides, MemoryArena* arena) : m_nodePool(arena),
+                                                                                                     m_entryPool(arena), m_vectorPool(arena),
+                                                                                                     m_strides(strides, strides + strlen(reinterpret_cast< const char* >(strides))),
+                                                                                                     m_rootNode(m_nodePool.construct(m_strides[0])),
+                                                                                                     m_numOfAclRules(aclSize), m_dimension(dimension),
+                                                                                                     m_numOfNodes(1)
+{
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ *
+ * Nodes, prefixes and bit vectors are destructed by their pools.
+ */
+template < class BitVector >
+MultibitTree< BitVector >::~MultibitTree() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method allocates new tree node for passed level.
+ *
+ * @param level level of the node (0 is the level of the root).
+ * @return pointer to newly created node.
+ */
+template < class BitVector >
+typename MultibitTree< BitVector >::TreeNode* MultibitTree< BitVector >::allocateNewNode(unsigned level)
+{
+    ++m_numOfNodes;
+    return m_nodePool.construct(m_strides[level]);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method allocates new valid prefix containing passed rule.
+ *
+ * @param length number of bits of the prefix.
+ * @param rulePositionNum position of the rule in ACL.
+ * @return pointer to newly created prefix.
+ */
+template < class BitVector >
+typename MultibitTree< BitVector >::PrefixEntry* MultibitTree< BitVector >::allocateNewEntry(u_int8_t length, int rulePositionNum)
+{
+    PrefixEntry* entry = m_entryPool.construct(length);
+
+    entry->m_bitVector1 = m_vectorPool.construct(m_numOfAclRules);
+    entry->m_bitVector2 = m_vectorPool.construct(m_numOfAclRules);
+
+    entry->m_bitVector1->set(rulePositionNum);
+    entry->m_bitVector2->set(rulePositionNum);
+
+    return entry;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method recursively computes BitVector2 for subtree with passed root node.
+ *
+ * BitVector2 of the shortest valid prefixes of the node is used, slots not covered by any of them
+ * continue to the next level. Slots covered by one prefix are consecutive, so every prefix
+ * is used only once.
+ *
+ * @param node pointer to tree node used as root for the subtree for which the BitVector2 is computed.
+ * @param level level of the node.
+ * @param vector reference to the bit vector where computed BitVector2 will be stored.
+ */
+template < class BitVector >
+void MultibitTree< BitVector >::getBitVector2forSubTree(typename MultibitTree< BitVector >::TreeNode* const node, unsigned level, BitVector& vector)
+{
+    u_int32_t numOfSlots = 1U << m_strides[level];
+    PrefixEntry* lastEntry = NULL;
+
+    for ( u_int32_t i = 0; i < numOfSlots; ++i )
+    {
+        PrefixEntry* entry = node->m_slots[i].m_entry;
+
+        if ( entry != NULL )
+        {
+            while ( entry->m_parent != NULL )
+                entry = entry->m_parent;
+
+            if ( entry != lastEntry )
+            {
+                vector |= *(entry->m_bitVector2);
+                lastEntry = entry;
+            }
+        }
+        else if ( node->m_slots[i].m_child != NULL )
+        {
+            getBitVector2forSubTree(node->m_slots[i].m_child, level + 1, vector);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the index of the slot for bits of the prefix consumed by the node.
+ *
+ * @param bits bits of the prefix aligned to the most significant bit.
+ * @param depth number of bits consumed by levels above the node.
+ * @param stride number of bits consumed by the node.
+ * @return index of the slot.
+ */
+template < class BitVector >
+u_int32_t MultibitTree< BitVector >::slotIndex(u_int32_t bits, unsigned depth, unsigned stride)
+{
+    return (bits << depth) >> (32 - stride);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to its prefix.
+ *
+ * @param prefix reference to structure containing prefix which will be added.
+ * @param rulePositionNum position of the rule in ACL.
+ * @return smart pointer with pointer to the bit vector containing conflict bit vector for new rule.
+ */
+template < class BitVector >
+std::auto_ptr< BitVector > MultibitTree< BitVector >::addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum)
+{
+    auto_ptr< BitVector > conflictVector(new BitVector(m_numOfAclRules));
+
+    addNewRulePrefix(prefix, rulePositionNum, *conflictVector);
+
+    return conflictVector;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to its prefix.
+ *
+ * Levels whose bits are all covered by the prefix are passed through one slot, valid prefixes
+ * linked from the slot are ancestors of the added prefix. In the node where the prefix ends, new
+ * prefix is expanded to its slots which are not covered by a longer prefix. Prefixes longer than
+ * the new one, which were not covered by any other longer prefix, are linked to it and their
+ * BitVector2 (or BitVector2 of subtrees below uncovered slots) is added to its BitVector2.
+ * Conflict bit vector is stored to the passed vector (see PrefixTree::addNewRulePrefix()).
+ *
+ * @param prefix reference to structure containing prefix which will be added.
+ * @param rulePositionNum position of the rule in ACL.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void MultibitTree< BitVector >::addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum, BitVector& conflictVector)
+{
+    /* conflict vector for newly added rule */
+    conflictVector.reset(false);
+
+    TreeNode* curentNode = m_rootNode;
+    unsigned level = 0;
+    unsigned depth = 0;
+    unsigned prefixSize = prefix.length;
+
+    /* passing levels whose bits are all covered by the prefix */
+    while ( prefixSize > depth + m_strides[level] )
+    {
+        NodeSlot& slot = curentNode->m_slots[slotIndex(prefix.bits, depth, m_strides[level])];
+
+        /* valid prefixes covering the slot -> set bitVector2 and do OR with conflictVector */
+        for ( PrefixEntry* entry = slot.m_entry; entry != NULL; entry = entry->m_parent )
+        {
+            entry->m_bitVector2->set(rulePositionNum);
+            conflictVector |= *(entry->m_bitVector1);
+        }
+
+        if ( slot.m_child == NULL )
+            slot.m_child = allocateNewNode(level + 1);
+
+        curentNode = slot.m_child;
+        depth += m_strides[level];
+        ++level;
+    }
+
+    /* the prefix ends in the current node and covers consecutive slots */
+    u_int32_t firstSlot = slotIndex(prefix.bits, depth, m_strides[level]);
+    u_int32_t numOfSlots = 1U << (depth + m_strides[level] - prefixSize);
+
+    /* skip longer prefixes covering the first slot */
+    PrefixEntry* entry = curentNode->m_slots[firstSlot].m_entry;
+    while ( entry != NULL && entry->m_length > prefixSize )
+        entry = entry->m_parent;
+
+    PrefixEntry* ancestor;
+
+    /* if the prefix is already valid */
+    if ( entry != NULL && entry->m_length == prefixSize )
+    {
+        entry->m_bitVector1->set(rulePositionNum);
+        entry->m_bitVector2->set(rulePositionNum);
+        ancestor = entry->m_parent;
+    }
+    else
+    {
+        ancestor = entry;
+        entry = allocateNewEntry(prefixSize, rulePositionNum);
+        entry->m_parent = ancestor;
+
+        for ( u_int32_t i = firstSlot; i < firstSlot + numOfSlots; ++i )
+        {
+            NodeSlot& slot = curentNode->m_slots[i];
+            PrefixEntry* longer = slot.m_entry;
+
+            /* slot is not covered by longer prefix -> expand the new prefix to it */
+            if ( longer == NULL || longer->m_length < prefixSize )
+            {
+                slot.m_entry = entry;
+
+                if ( slot.m_child != NULL )
+                    getBitVector2forSubTree(slot.m_child, level + 1, *(entry->m_bitVector2));
+
+                continue;
+            }
+
+            /* find the shortest longer prefix covering the slot and link it to the new prefix (once) */
+            while ( longer->m_parent != ancestor && longer->m_parent != entry )
+                longer = longer->m_parent;
+
+            if ( longer->m_parent == ancestor )
+            {
+                *(entry->m_bitVector2) |= *(longer->m_bitVector2);
+                longer->m_parent = entry;
+            }
+        }
+    }
+
+    /* valid prefixes of the node covering the added prefix -> set bitVector2 and do OR with conflictVector */
+    for ( ; ancestor != NULL; ancestor = ancestor->m_parent )
+    {
+        ancestor->m_bitVector2->set(rulePositionNum);
+        conflictVector |= *(ancestor->m_bitVector1);
+    }
+
+    conflictVector |= *(entry->m_bitVector2);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to the prefix of its dimension.
+ *
+ * @param rule reference to the added rule.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void MultibitTree< BitVector >::addNewRule(const AclRule& rule, BitVector& conflictVector)
+{
+    addNewRulePrefix(rule.getFieldPrefix(m_dimension), rule.getPosition(), conflictVector);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of nodes of the tree.
+ *
+ * @return number of allocated nodes including the root.
+ */
+template < class BitVector >
+size_t MultibitTree< BitVector >::numOfNodes() const
+{
+    return m_numOfNodes;
+}
+
+//-----------------------------------------------------------------------------------
+
+/* multibit prefix trees with all supported bit vectors */
+template class MultibitTree< WAHBitVector >;
+template class MultibitTree< PlainBitVector >;
+template class MultibitTree< RoaringBitVector >;
@@ -0,0 +1,127 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <memory>
+#include <vector>
+
+#include "AclRule.hpp"
+#include "DimensionIndex.hpp"
+#include "MemoryArena.hpp"
+#include "ObjectPool.hpp"
+#include "WAHBitVector.hpp"
+#include "PlainBitVector.hpp"
+#include "RoaringBitVector.hpp"
+
+#ifndef MULTIBIT_TREE_H__3918274650192837465091827364501928374650918273645091
+#define MULTIBIT_TREE_H__3918274650192837465091827364501928374650918273645091
+
+/**
+ * Strides of multibit prefix trees (numbers of bits consumed by the levels of the tree, terminated by 0).
+ */
+const u_int8_t STRIDES_8_8_8_8[] = { 8, 8, 8, 8, 0 };     /** Four levels with 256 slots per node. */
+const u_int8_t STRIDES_16_8_8[] = { 16, 8, 8, 0 };        /** Root with 65536 slots and two levels with 256 slots per node. */
+
+/**
+ * Class MultibitTree represents the multibit prefix tree for one dimension of ACL rule.
+ *
+ * Every node of the tree consumes several bits of the prefix (stride of its level) and has one slot
+ * for every value of them. The prefix is stored in the node of the level, in which it ends, and it is
+ * expanded to all slots it covers (controlled prefix expansion): the slot points to the longest valid
+ * prefix of the node covering it and prefixes of the node covering each other are linked from longer
+ * to shorter ones. Prefixes keep the semantics of PrefixTree (BitVector1 contains rules with exactly
+ * the prefix, BitVector2 rules with the prefix or any longer prefix beginning with it), but a host
+ * address takes one array lookup per level (e.g. 4 for strides 8-8-8-8) instead of 32 node hops.
+ *
+ * The tree is parametrized by the class of bit vectors used in its prefixes (WAHBitVector,
+ * PlainBitVector or RoaringBitVector). Instances for all classes are compiled in MultibitTree.cpp.
+ */
+template < class BitVector >
+class MultibitTree : public DimensionIndex< BitVector >
+{
+    protected:
+        /**
+         * Class PrefixEntry represents the valid prefix stored in the node of the tree.
+         */
+        class PrefixEntry
+        {
+            public:
+                BitVector* m_bitVector1;        /** Pointer to BitVector1 (owned by the pool of vectors of the tree). */
+                BitVector* m_bitVector2;        /** Pointer to BitVector2 (owned by the pool of vectors of the tree). */
+                PrefixEntry* m_parent;          /** Pointer to the longest shorter prefix of the same node covering this one. */
+                u_int8_t m_length;              /** Number of bits of the prefix. */
+
+                PrefixEntry(u_int8_t length);
+                virtual ~PrefixEntry();
+        };
+
+        class TreeNode;
+
+        /**
+         * Structure representing one slot of the node.
+         */
+        struct NodeSlot
+        {
+            TreeNode* m_child;                  /** Pointer to the node of the next level, NULL if it does not exist. */
+            PrefixEntry* m_entry;               /** Pointer to the longest valid prefix of the node covering the slot. */
+        };
+
+        /**
+         * Class TreeNode represents the node of a multibit prefix tree.
+         */
+        class TreeNode
+        {
+            private:
+                TreeNode(const TreeNode& node);                 /** Node can not be copied. */
+                TreeNode& operator = (const TreeNode& node);    /** Node can not be assigned. */
+
+            public:
+                NodeSlot* m_slots;              /** Array of slots, one for every value of the bits of the stride. */
+
+                TreeNode(unsigned stride);
+                virtual ~TreeNode();
+        };
+
+    private:
+        ObjectPool< TreeNode > m_nodePool;              /** Pool of all nodes of the tree (the memory will be freed in destruction). */
+        ObjectPool< PrefixEntry > m_entryPool;          /** Pool of all valid prefixes of the tree. */
+        ObjectPool< BitVector > m_vectorPool;           /** Pool of bit vectors of all valid prefixes of the tree. */
+        std::vector< unsigned > m_strides;              /** Strides of levels of the tree. */
+        TreeNode* const m_rootNode;                     /** Constant pointer to the root of the tree. */
+        const u_int32_t m_numOfAclRules;                /** Number of the rules in ACL for which the tree is created. */
+        const int m_dimension;                          /** Dimension of rules stored in the tree. */
+        size_t m_numOfNodes;                            /** Number of allocated nodes. */
+
+    protected:
+        TreeNode* allocateNewNode(unsigned level);
+        PrefixEntry* allocateNewEntry(u_int8_t length, int rulePositionNum);
+        void getBitVector2forSubTree(TreeNode* const node, unsigned level, BitVector& vector);
+
+        static u_int32_t slotIndex(u_int32_t bits, unsigned depth, unsigned stride);
+
+    public:
+        MultibitTree(u_int32_t aclSize, int dimension = DIMENSION_MIN, const u_int8_t* strides = STRIDES_8_8_8_8, MemoryArena* arena = NULL);
+        virtual ~MultibitTree();
+
+        std::auto_ptr< BitVector > addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum);
+        void addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum, BitVector& conflictVector);
+
+        virtual void addNewRule(const AclRule& rule, BitVector& conflictVector);
+        virtual size_t numOfNodes() const;
+};
+
+#endif /* MULTIBIT_TREE_H__3918274650192837465091827364501928374650918273645091 */
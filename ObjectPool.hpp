@@ -0,0 +1,152 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <new>
+#include <vector>
+#include <cstddef>
+
+#include "MemoryArena.hpp"
+
+#ifndef OBJECT_POOL_H__8203746159283746501928374650192837465019283746
+#define OBJECT_POOL_H__8203746159283746501928374650192837465019283746
+
+/**
+ * Class ObjectPool allocates objects of one class from large blocks of memory.
+ *
+ * Objects are constructed one after another in blocks, whose size is doubled up to
+ * MAX_BLOCK_OBJECTS objects, so many small objects (e.g. nodes of prefix trees)
+ * take only a few allocations. Objects can not be freed one by one, all of them
+ * are destructed and their memory is freed when the pool is destroyed. Blocks are taken
+ * from MemoryArena passed in constructor, or from the heap if there is none.
+ */
+template < class T >
+class ObjectPool
+{
+    private:
+        static const size_t FIRST_BLOCK_OBJECTS = 32;       /** Number of objects in the first block. */
+        static const size_t MAX_BLOCK_OBJECTS = 4096;       /** Maximum number of objects in one block. */
+
+        MemoryArena* const m_arena;     /** Arena providing blocks, NULL if they are taken from the heap. */
+        std::vector< T* > m_blocks;     /** Allocated blocks of memory. */
+        size_t m_blockCapacity;         /** Number of objects which fit into the last block. */
+        size_t m_blockUsed;             /** Number of constructed objects in the last block. */
+
+        ObjectPool(const ObjectPool& pool);                 /** Pool can not be copied. */
+        ObjectPool& operator = (const ObjectPool& pool);    /** Pool can not be assigned. */
+
+        /**
+         * Method returns the allocator of blocks.
+         *
+         * @return allocator taking memory from the arena of the pool.
+         */
+        ArenaAllocator< T > blockAllocator() const
+        {
+            return ArenaAllocator< T >(m_arena);
+        }
+
+        /**
+         * Method returns memory for the next object, new block is allocated if the last one is full.
+         *
+         * @return pointer to not constructed object.
+         */
+        T* allocate()
+        {
+            if ( m_blockUsed == m_blockCapacity )
+            {
+                size_t capacity = (m_blockCapacity == 0) ? FIRST_BLOCK_OBJECTS : (2 * m_blockCapacity);
+                capacity = (capacity < MAX_BLOCK_OBJECTS) ? capacity : MAX_BLOCK_OBJECTS;
+
+                m_blocks.reserve(m_blocks.size() + 1);
+                m_blocks.push_back(blockAllocator().allocate(capacity));
+                m_blockCapacity = capacity;
+                m_blockUsed = 0;
+            }
+
+            return m_blocks.back() + m_blockUsed;
+        }
+
+    public:
+        /**
+         * Class constructor.
+         *
+         * @param arena pointer to the arena providing blocks, NULL if blocks are taken from the heap.
+         */
+        explicit ObjectPool(MemoryArena* arena = NULL) : m_arena(arena), m_blockCapacity(0), m_blockUsed(0) { }
+
+        /**
+         * Class destructor, all constructed objects are destructed.
+         */
+        ~ObjectPool()
+        {
+            size_t capacity = FIRST_BLOCK_OBJECTS;
+
+            for ( size_t i = 0; i < m_blocks.size(); ++i )
+            {
+                size_t used = ((i + 1) == m_blocks.size()) ? m_blockUsed : capacity;
+
+                for ( size_t j = 0; j < used; ++j )
+                    m_blocks[i][j].~T();
+
+                blockAllocator().deallocate(m_blocks[i], capacity);
+                capacity = ((2 * capacity) < MAX_BLOCK_OBJECTS) ? (2 * capacity) : MAX_BLOCK_OBJECTS;
+            }
+        }
+
+        /**
+         * Method constructs new object using its default constructor.
+         *
+         * @return pointer to the new object owned by the pool.
+         */
+        T* construct()
+        {
+            T* object = new (allocate()) T();
+            ++m_blockUsed;
+            return object;
+        }
+
+        /**
+         * Method constructs new object using its constructor with one parameter.
+         *
+         * @param arg parameter passed to the constructor.
+         * @return pointer to the new object owned by the pool.
+         */
+        template < class A >
+        T* construct(const A& arg)
+        {
+            T* object = new (allocate()) T(arg);
+            ++m_blockUsed;
+            return object;
+        }
+
+        /**
+         * Method constructs new object using its constructor with two parameters.
+         *
+         * @param arg1 first parameter passed to the constructor.
+         * @param arg2 second parameter passed to the constructor.
+         * @return pointer to the new object owned by the pool.
+         */
+        template < class A, class B >
+        T* construct(const A& arg1, const B& arg2)
+        {
+            T* object = new (allocate()) T(arg1, arg2);
+            ++m_blockUsed;
+            return object;
+        }
+};
+
+#endif /* OBJECT_POOL_H__8203746159283746501928374650192837465019283746 */
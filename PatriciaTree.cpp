@@ -0,0 +1,319 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "PatriciaTree.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * Constructs the node with the empty prefix.
+ */
+template < class BitVector >
+PatriciaTree< BitVector >::TreeNode::TreeNode() : m_bitVector1(NULL), m_bitVector2(NULL), m_prefixBits(0), m_prefixLength(0), m_isValidPrefixNode(false)
+{
+    m_children[0] = m_children[1] = NULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class constructor.
+ *
+ * @param prefix reference to the prefix of the node.
+ */
+template < class BitVector >
+PatriciaTree< BitVector >::TreeNode::TreeNode(const FIELD_PREFIX& prefix) : m_bitVector1(NULL), m_bitVector2(NULL), m_prefixBits(prefix.bits),
+                                                                             m_prefixLength(prefix.length), m_isValidPrefixNode(false)
+{
+    m_children[0] = m_children[1] = NULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+template < class BitVector >
+PatriciaTree< BitVector >::TreeNode::~TreeNode() { }
+
+
+/*************************************************************/
+/*********************** PATRICIA TREE ***********************/
+
+/**
+ * Class constructor.
+ *
+ * @param aclSize number of rules in ACL for which is this prefix tree used.
+ * @param dimension dimension of rules added by addNewRule() (constant DIMENSION_XXX).
+ * @param arena pointer to the arena providing blocks of pools of nodes and bit vectors, NULL if they are taken
+ *              from the heap. The arena has to exist until the tree is destroyed.
+ */
+template < class BitVector >
+PatriciaTree< BitVector >::PatriciaTree(u_int32_t aclSize, int dimension, MemoryArena* arena) : m_nodePool(arena), m_vectorPool(arena),
+                                                                            m_rootNode(m_nodePool.construct()), m_numOfAclRules(aclSize),
+                                                                            m_dimension(dimension), m_numOfNodes(1)
+{
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ *
+ * Nodes and bit vectors are destructed by their pools.
+ */
+template < class BitVector >
+PatriciaTree< BitVector >::~PatriciaTree() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method allocates new tree node with passed prefix.
+ *
+ * @param bits bits of the prefix aligned to the most significant bit (bits behind the prefix are cleared).
+ * @param length number of bits of the prefix.
+ * @return pointer to newly created node.
+ */
+template < class BitVector >
+typename PatriciaTree< BitVector >::TreeNode* PatriciaTree< BitVector >::allocateNewNode(u_int32_t bits, u_int8_t length)
+{
+    FIELD_PREFIX prefix;
+
+    prefix.bits = (length == 0) ? 0 : (bits & (0xFFFFFFFF << (32 - length)));
+    prefix.length = length;
+
+    ++m_numOfNodes;
+    return m_nodePool.construct(prefix);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method recursively computes BitVector2 for subtree with passed root node.
+ *
+ * @param node pointer to tree node used as root for the subtree for which the BitVector2 is computed.
+ * @param vector reference to the bit vector where computed BitVector2 will be stored.
+ */
+template < class BitVector >
+void PatriciaTree< BitVector >::getBitVector2forSubTree(typename PatriciaTree< BitVector >::TreeNode* const node, BitVector& vector)
+{
+    if ( node == NULL )
+        return;
+
+    /* if the current node is valid, we do OR and return */
+    if ( node->m_isValidPrefixNode )
+    {
+        vector |= *(node->m_bitVector2);
+
+        return;
+    }
+
+    getBitVector2forSubTree(node->m_children[0], vector);
+    getBitVector2forSubTree(node->m_children[1], vector);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the length of the common beginning of two prefixes.
+ *
+ * @param bits1 bits of the first prefix.
+ * @param length1 length of the first prefix.
+ * @param bits2 bits of the second prefix.
+ * @param length2 length of the second prefix.
+ * @return number of equal leading bits, at most the length of the shorter prefix.
+ */
+template < class BitVector >
+unsigned PatriciaTree< BitVector >::commonPrefixLength(u_int32_t bits1, u_int8_t length1, u_int32_t bits2, u_int8_t length2)
+{
+    u_int32_t difference = bits1 ^ bits2;
+    unsigned common = (difference == 0) ? 32 : __builtin_clz(difference);
+    unsigned shorter = (length1 < length2) ? length1 : length2;
+
+    return (common < shorter) ? common : shorter;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the bit of the prefix at passed position.
+ *
+ * @param bits bits of the prefix aligned to the most significant bit.
+ * @param position position of the bit (0 is the most significant bit), less than 32.
+ * @return value 0 or 1.
+ */
+template < class BitVector >
+unsigned PatriciaTree< BitVector >::bitAt(u_int32_t bits, unsigned position)
+{
+    return (bits >> (31 - position)) & 1;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to its prefix.
+ *
+ * @param prefix reference to structure containing prefix which will be added.
+ * @param rulePositionNum position of the rule in ACL.
+ * @return smart pointer with pointer to the bit vector containing conflict bit vector for new rule.
+ */
+template < class BitVector >
+std::auto_ptr< BitVector > PatriciaTree< BitVector >::addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum)
+{
+    auto_ptr< BitVector > conflictVector(new BitVector(m_numOfAclRules));
+
+    addNewRulePrefix(prefix, rulePositionNum, *conflictVector);
+
+    return conflictVector;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to its prefix.
+ *
+ * The tree is traversed through nodes whose prefixes begin the added prefix. If the added prefix
+ * ends inside the skipped part of an edge, new node is inserted there. If it diverges from the
+ * edge, a branch node is inserted at the first different bit with the new leaf as its second child.
+ * Conflict bit vector is stored to the passed vector (see PrefixTree::addNewRulePrefix()).
+ *
+ * @param prefix reference to structure containing prefix which will be added.
+ * @param rulePositionNum position of the rule in ACL.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void PatriciaTree< BitVector >::addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum, BitVector& conflictVector)
+{
+    /* conflict vector for newly added rule */
+    conflictVector.reset(false);
+
+    TreeNode* curentNode = m_rootNode;
+    unsigned prefixSize = prefix.length;
+    u_int32_t prefixBits = prefix.bits;
+
+    /* traversing the tree according to the prefix, the prefix of the current node always begins the added prefix */
+    while ( curentNode->m_prefixLength < prefixSize )
+    {
+        /* if the current node represents valid prefix -> set bitVector2 and do OR with conflictVector */
+        if ( curentNode->m_isValidPrefixNode )
+        {
+            curentNode->m_bitVector2->set(rulePositionNum);
+            conflictVector |= *(curentNode->m_bitVector1);
+        }
+
+        unsigned branch = bitAt(prefixBits, curentNode->m_prefixLength);
+        TreeNode* child = curentNode->m_children[branch];
+
+        /* no child in the direction -> the prefix becomes the new leaf */
+        if ( child == NULL )
+        {
+            curentNode->m_children[branch] = allocateNewNode(prefixBits, prefixSize);
+            curentNode = curentNode->m_children[branch];
+            break;
+        }
+
+        unsigned common = commonPrefixLength(prefixBits, prefixSize, child->m_prefixBits, child->m_prefixLength);
+
+        /* prefix of the child begins the added prefix -> continue with the child */
+        if ( common == child->m_prefixLength )
+        {
+            curentNode = child;
+            continue;
+        }
+
+        /* added prefix ends inside the edge -> insert its node above the child */
+        if ( common == prefixSize )
+        {
+            TreeNode* newNode = allocateNewNode(prefixBits, prefixSize);
+            newNode->m_children[bitAt(child->m_prefixBits, prefixSize)] = child;
+            curentNode->m_children[branch] = newNode;
+            curentNode = newNode;
+            break;
+        }
+
+        /* added prefix diverges from the edge -> insert branch node with the new leaf */
+        TreeNode* branchNode = allocateNewNode(prefixBits, common);
+        TreeNode* newNode = allocateNewNode(prefixBits, prefixSize);
+        branchNode->m_children[bitAt(child->m_prefixBits, common)] = child;
+        branchNode->m_children[bitAt(prefixBits, common)] = newNode;
+        curentNode->m_children[branch] = branchNode;
+        curentNode = newNode;
+        break;
+    }
+
+    /* if the current node represents valid prefix */
+    if ( curentNode->m_isValidPrefixNode )
+    {
+        curentNode->m_bitVector1->set(rulePositionNum);
+        curentNode->m_bitVector2->set(rulePositionNum);
+    }
+    else
+    {
+        /* create bit vectors */
+        curentNode->m_bitVector1 = m_vectorPool.construct(m_numOfAclRules);
+        curentNode->m_bitVector2 = m_vectorPool.construct(m_numOfAclRules);
+
+        curentNode->m_bitVector1->set(rulePositionNum);
+        curentNode->m_bitVector2->set(rulePositionNum);
+
+        getBitVector2forSubTree(curentNode->m_children[0], *(curentNode->m_bitVector2));
+        getBitVector2forSubTree(curentNode->m_children[1], *(curentNode->m_bitVector2));
+
+        curentNode->m_isValidPrefixNode = true;
+    }
+
+    conflictVector |= *(curentNode->m_bitVector2);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to the prefix of its dimension.
+ *
+ * @param rule reference to the added rule.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void PatriciaTree< BitVector >::addNewRule(const AclRule& rule, BitVector& conflictVector)
+{
+    addNewRulePrefix(rule.getFieldPrefix(m_dimension), rule.getPosition(), conflictVector);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of nodes of the tree.
+ *
+ * @return number of allocated nodes including the root.
+ */
+template < class BitVector >
+size_t PatriciaTree< BitVector >::numOfNodes() const
+{
+    return m_numOfNodes;
+}
+
+//-----------------------------------------------------------------------------------
+
+/* path-compressed prefix trees with all supported bit vectors */
+template class PatriciaTree< WAHBitVector >;
+template class PatriciaTree< PlainBitVector >;
+template class PatriciaTree< RoaringBitVector >;
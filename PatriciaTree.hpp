@@ -0,0 +1,94 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <memory>
+
+#include "AclRule.hpp"
+#include "DimensionIndex.hpp"
+#include "MemoryArena.hpp"
+#include "ObjectPool.hpp"
+#include "WAHBitVector.hpp"
+#include "PlainBitVector.hpp"
+#include "RoaringBitVector.hpp"
+
+#ifndef PATRICIA_TREE_H__7461928374650192837465019283746501928374650192837465
+#define PATRICIA_TREE_H__7461928374650192837465019283746501928374650192837465
+
+/**
+ * Class PatriciaTree represents the path-compressed prefix tree for one dimension of ACL rule.
+ *
+ * The tree has the same semantics as PrefixTree (BitVector1 of the valid node contains rules with
+ * exactly its prefix, BitVector2 rules with its prefix or any longer prefix beginning with it), but
+ * chains of nodes with one child and no valid prefix are skipped. Every node stores its whole
+ * prefix and nodes exist only for valid prefixes and for branch points, so the tree has less than
+ * two nodes per distinct prefix and a host address takes a few node hops instead of 32.
+ *
+ * The tree is parametrized by the class of bit vectors used in its nodes (WAHBitVector,
+ * PlainBitVector or RoaringBitVector). Instances for all classes are compiled in PatriciaTree.cpp.
+ */
+template < class BitVector >
+class PatriciaTree : public DimensionIndex< BitVector >
+{
+    protected:
+        /**
+         * Class TreeNode represents the node of a path-compressed prefix tree.
+         */
+        class TreeNode
+        {
+            public:
+                TreeNode* m_children[2];        /** Pointers to children for the next bit "0" and "1" after the prefix. */
+
+                BitVector* m_bitVector1;        /** Pointer to BitVector1 (owned by the pool of vectors of the tree). */
+                BitVector* m_bitVector2;        /** Pointer to BitVector2 (owned by the pool of vectors of the tree). */
+
+                u_int32_t m_prefixBits;         /** Bits of the prefix of the node aligned to the most significant bit. */
+                u_int8_t m_prefixLength;        /** Number of bits of the prefix of the node. */
+                bool m_isValidPrefixNode;       /** Flag set if the node represents valid prefix. */
+
+                TreeNode();
+                TreeNode(const FIELD_PREFIX& prefix);
+                virtual ~TreeNode();
+        };
+
+    private:
+        ObjectPool< TreeNode > m_nodePool;              /** Pool of all nodes of the tree (the memory will be freed in destruction). */
+        ObjectPool< BitVector > m_vectorPool;           /** Pool of bit vectors of all nodes of the tree. */
+        TreeNode* const m_rootNode;                     /** Constant pointer to the root of the tree (empty prefix). */
+        const u_int32_t m_numOfAclRules;                /** Number of the rules in ACL for which the tree is created. */
+        const int m_dimension;                          /** Dimension of rules stored in the tree. */
+        size_t m_numOfNodes;                            /** Number of allocated nodes. */
+
+    protected:
+        TreeNode* allocateNewNode(u_int32_t bits, u_int8_t length);
+        void getBitVector2forSubTree(TreeNode* const node, BitVector& vector);
+
+        static unsigned commonPrefixLength(u_int32_t bits1, u_int8_t length1, u_int32_t bits2, u_int8_t length2);
+        static unsigned bitAt(u_int32_t bits, unsigned position);
+
+    public:
+        PatriciaTree(u_int32_t aclSize, int dimension = DIMENSION_MIN, MemoryArena* arena = NULL);
+        virtual ~PatriciaTree();
+
+        std::auto_ptr< BitVector > addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum);
+        void addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum, BitVector& conflictVector);
+
+        virtual void addNewRule(const AclRule& rule, BitVector& conflictVector);
+        virtual size_t numOfNodes() const;
+};
+
+#endif /* PATRICIA_TREE_H__7461928374650192837465019283746501928374650192837465 */
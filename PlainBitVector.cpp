@@ -0,0 +1,640 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <sstream>
+#include <iomanip>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "PlainBitVector.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * New vector with passed size is created. The size is fixed after construction.
+ *
+ * @param size size of created vector in bits.
+ * @param fillBit initial value for all bits of newly created vector.
+ */
+PlainBitVector::PlainBitVector(const u_int32_t size, bool fillBit) : m_vec((size + 63) / 64),
+                                                                     m_sizeInBits(size)
+{
+    reset(fillBit);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method sets all bits of the vector to passed value.
+ *
+ * @param fillBit new value for all bits of the vector.
+ */
+void PlainBitVector::reset(bool fillBit)
+{
+    m_vec.assign(m_vec.size(), fillBit ? ~((u_int64_t) 0) : 0);
+
+    /* bits after the end of the vector have to be zeroes */
+    if ( fillBit && ((m_sizeInBits % 64) != 0) )
+        m_vec.back() = (((u_int64_t) 1) << (m_sizeInBits % 64)) - 1;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method sets the bit at passed index to value "1".
+ *
+ * @throw Exception if the index is out of the vector.
+ * @param index position of the bit to be set to value 1. Position has to be
+ * less than size of the vector.
+ */
+void PlainBitVector::set(const u_int32_t index) throw(Exception)
+{
+    if ( index >= m_sizeInBits )
+        throw Exception("Index out of borders!");
+
+    m_vec[index / 64] |= ((u_int64_t) 1) << (index % 64);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method for getting value of bit on passed index.
+ *
+ * @throw Exception if the index is out of the vector.
+ * @param index position of the bit we want to get its value. Position has to be
+ * less than size of the vector.
+ * @return value of the bit at passed index.
+ */
+bool PlainBitVector::get(const u_int32_t index) throw(Exception)
+{
+    if ( index >= m_sizeInBits )
+        throw Exception("Index out of borders!");
+
+    return ( (m_vec[index / 64] >> (index % 64)) & 1 ) != 0;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method to get size of bit vector.
+ *
+ * @return number of bits in bit vector.
+ */
+u_int32_t PlainBitVector::size()
+{
+    return m_sizeInBits;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method counts set bits of the vector.
+ *
+ * @return number of bits set to value "1".
+ */
+u_int32_t PlainBitVector::count() const
+{
+    u_int32_t result = 0;
+    size_t numOfWords = m_vec.size();
+
+    for ( size_t i = 0; i < numOfWords; ++i )
+        result += __builtin_popcountll(m_vec[i]);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns string representing the vector for debug purposes.
+ *
+ * @return string containing 64bit words of the vector.
+ */
+std::string PlainBitVector::toStringHex()
+{
+    std::stringstream output;
+    std::vector<u_int64_t>::iterator it;
+
+    for ( it = m_vec.begin(); it < m_vec.end(); ++it )
+    {
+        output << "0x";
+        output << std::setw(16) << std::setfill('0') << std::right << std::hex << std::uppercase << *it << " ";
+    }
+
+    output << std::endl << "Size= " << std::dec << m_sizeInBits << std::endl;
+
+    return output.str();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the object of iterator through indeces of ones in current bit vector.
+ *
+ * @param stopIndex value of end index to which we want not iterate the positions of ones (not included).
+ * @param startIndex value of start index from which we want to iterate the positions of one (included).
+ * @return iterator through the indices of ones in current bit vector.
+ */
+PlainBitVector::OnesIterator PlainBitVector::getOnesIterator(const u_int32_t stopIndex, const u_int32_t startIndex) throw(Exception)
+{
+    if (stopIndex < startIndex)
+        throw Exception("Stop index smaller than Start index!");
+
+    u_int32_t stop = (stopIndex < size()) ? stopIndex : size();
+
+    return PlainBitVector::OnesIterator(m_vec.empty() ? NULL : &m_vec[0], stop, startIndex);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns bit vector as object boost::dynamic_bitset< >.
+ *
+ * @return non-compressed bit vector.
+ */
+boost::dynamic_bitset<> PlainBitVector::getUncompressedVector()
+{
+    boost::dynamic_bitset<> vector(m_sizeInBits, 0);
+
+    for ( u_int32_t i = 0; i < m_sizeInBits; ++i )
+        vector[i] = ( (m_vec[i / 64] >> (i % 64)) & 1 ) != 0;
+
+    return vector;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical AND.
+ *
+ * @param vector2 reference to the second bit vector.
+ * @return new bit vector which is the AND of two vectors.
+ */
+PlainBitVector PlainBitVector::operator&(const PlainBitVector& vector2) const
+{
+    PlainBitVector result = *this;
+    result &= vector2;
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical OR.
+ *
+ * @param vector2 reference to he second bit vector.
+ * @return new bit vector which is the OR of two vectors.
+ */
+PlainBitVector PlainBitVector::operator|(const PlainBitVector& vector2) const
+{
+    PlainBitVector result = *this;
+    result |= vector2;
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical AND with assignment.
+ *
+ * @param vector2 reference to the second bit vector.
+ * @return reference to the original bit vector which is AND of original and the second vector.
+ */
+PlainBitVector& PlainBitVector::operator&=(const PlainBitVector& vector2)
+{
+    andInto(*this, *this, vector2);
+
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical OR with assignment.
+ *
+ * @param vector2 reference to the second bit vector.
+ * @return reference to the original bit vector which is logical OR of original and the second vector.
+ */
+PlainBitVector& PlainBitVector::operator|=(const PlainBitVector& vector2)
+{
+    orInto(*this, *this, vector2);
+
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical AND of two arrays of words into the output array.
+ *
+ * Words are processed by 256bit (AVX2) or 128bit (SSE2) blocks, if the instructions
+ * are enabled by the compiler. Output array can be the same as one of the source arrays.
+ *
+ * @param out pointer to the array where the result is stored.
+ * @param src1 pointer to the first array of words.
+ * @param src2 pointer to the second array of words.
+ * @param numOfWords number of words of the arrays.
+ * @return TRUE - if some bit of the result is set.
+ *         FALSE - if the result contains only zeroes.
+ */
+bool PlainBitVector::andWords(u_int64_t* out, const u_int64_t* src1, const u_int64_t* src2, size_t numOfWords)
+{
+    u_int64_t nonZero = 0;
+    size_t i = 0;
+
+    #if defined(__AVX2__)
+    __m256i nonZero256 = _mm256_setzero_si256();
+    for ( ; (i + 4) <= numOfWords; i += 4 )
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src1 + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src2 + i));
+        __m256i r = _mm256_and_si256(a, b);
+        _mm256_storeu_si256((__m256i*)(out + i), r);
+        nonZero256 = _mm256_or_si256(nonZero256, r);
+    }
+    nonZero |= !_mm256_testz_si256(nonZero256, nonZero256);
+    #endif
+
+    #if defined(__SSE2__)
+    __m128i nonZero128 = _mm_setzero_si128();
+    for ( ; (i + 2) <= numOfWords; i += 2 )
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src2 + i));
+        __m128i r = _mm_and_si128(a, b);
+        _mm_storeu_si128((__m128i*)(out + i), r);
+        nonZero128 = _mm_or_si128(nonZero128, r);
+    }
+    nonZero |= _mm_movemask_epi8(_mm_cmpeq_epi8(nonZero128, _mm_setzero_si128())) != 0xFFFF;
+    #endif
+
+    for ( ; i < numOfWords; ++i )
+    {
+        out[i] = src1[i] & src2[i];
+        nonZero |= out[i];
+    }
+
+    return nonZero != 0;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical AND of two vectors into the destination vector.
+ *
+ * Destination vector can be the same object as one of the operands.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vector1 reference to the first bit vector.
+ * @param vector2 reference to the second bit vector.
+ */
+void PlainBitVector::andInto(PlainBitVector& dst, const PlainBitVector& vector1, const PlainBitVector& vector2)
+{
+    size_t numOfWords = (vector1.m_vec.size() < vector2.m_vec.size()) ? vector1.m_vec.size() : vector2.m_vec.size();
+    numOfWords = (numOfWords < dst.m_vec.size()) ? numOfWords : dst.m_vec.size();
+
+    if ( numOfWords > 0 )
+        andWords(&dst.m_vec[0], &vector1.m_vec[0], &vector2.m_vec[0], numOfWords);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical AND of passed vectors into the destination vector.
+ *
+ * Vectors are processed by blocks of AND_BLOCK_WORDS words, the block of the result stays
+ * in the cache while it is combined with all vectors. If the block of the result contains
+ * only zeroes, remaining vectors are skipped for this block. Destination vector can not be
+ * one of the vectors.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array. If zero is passed, all bits of the result are set.
+ */
+void PlainBitVector::andMany(PlainBitVector& dst, const PlainBitVector* const* vectors, size_t numOfVectors)
+{
+    if ( numOfVectors < 2 )
+    {
+        if ( numOfVectors == 0 )
+            dst.reset(true);
+        else
+            andInto(dst, *vectors[0], *vectors[0]);
+
+        return;
+    }
+
+    size_t numOfWords = dst.m_vec.size();
+    for ( size_t i = 0; i < numOfVectors; ++i )
+        numOfWords = (vectors[i]->m_vec.size() < numOfWords) ? vectors[i]->m_vec.size() : numOfWords;
+
+    for ( size_t block = 0; block < numOfWords; block += AND_BLOCK_WORDS )
+    {
+        size_t blockWords = ((numOfWords - block) < AND_BLOCK_WORDS) ? (numOfWords - block) : AND_BLOCK_WORDS;
+        u_int64_t* out = &dst.m_vec[block];
+
+        bool nonZero = andWords(out, &vectors[0]->m_vec[block], &vectors[1]->m_vec[block], blockWords);
+
+        for ( size_t i = 2; (i < numOfVectors) && nonZero; ++i )
+            nonZero = andWords(out, out, &vectors[i]->m_vec[block], blockWords);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical OR of two vectors into the destination vector.
+ *
+ * Words are processed by 256bit (AVX2) or 128bit (SSE2) blocks, if the instructions
+ * are enabled by the compiler. Destination vector can be the same object as one of the operands.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vector1 reference to the first bit vector.
+ * @param vector2 reference to the second bit vector.
+ */
+void PlainBitVector::orInto(PlainBitVector& dst, const PlainBitVector& vector1, const PlainBitVector& vector2)
+{
+    size_t numOfWords = (vector1.m_vec.size() < vector2.m_vec.size()) ? vector1.m_vec.size() : vector2.m_vec.size();
+    numOfWords = (numOfWords < dst.m_vec.size()) ? numOfWords : dst.m_vec.size();
+
+    u_int64_t* out = dst.m_vec.empty() ? NULL : &dst.m_vec[0];
+    const u_int64_t* src1 = vector1.m_vec.empty() ? NULL : &vector1.m_vec[0];
+    const u_int64_t* src2 = vector2.m_vec.empty() ? NULL : &vector2.m_vec[0];
+    size_t i = 0;
+
+    #if defined(__AVX2__)
+    for ( ; (i + 4) <= numOfWords; i += 4 )
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src1 + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src2 + i));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_or_si256(a, b));
+    }
+    #endif
+
+    #if defined(__SSE2__)
+    for ( ; (i + 2) <= numOfWords; i += 2 )
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src2 + i));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(a, b));
+    }
+    #endif
+
+    for ( ; i < numOfWords; ++i )
+        out[i] = src1[i] | src2[i];
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the object of iterator through indices of ones in logical AND of passed vectors.
+ *
+ * @throw Exception if no vector is passed.
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array.
+ * @param stopIndex value of end index to which we want to iterate the positions of ones (not included).
+ * @return iterator through the indices of ones in logical AND of passed vectors.
+ */
+PlainBitVector::AndIterator PlainBitVector::getAndIterator(const PlainBitVector* const* vectors, size_t numOfVectors, const u_int32_t stopIndex) throw(Exception)
+{
+    if ( numOfVectors == 0 )
+        throw Exception("No bit vectors to iterate!");
+
+    u_int32_t stop = (stopIndex < vectors[0]->m_sizeInBits) ? stopIndex : vectors[0]->m_sizeInBits;
+
+    return PlainBitVector::AndIterator(vectors, numOfVectors, stop);
+}
+
+/********************************************************/
+/************ IMPLEMENTATION OF OnesIterator ************/
+/********************************************************/
+
+/**
+ * Class constructor.
+ *
+ * The only meaningful way how to acquire the obect of class OnesIterator is by the method of class
+ * PlainBitVector getOnesIterator().
+ *
+ * @param words pointer to the first 64bit word of the vector.
+ * @param stopIndex end index to which we want to search ones in the vector (not included).
+ *                  It has to be less or equal to the size of the vector.
+ * @param startIndex start index from which we want to search ones in the vector (included).
+ */
+PlainBitVector::OnesIterator::OnesIterator(const u_int64_t* words, u_int32_t stopIndex, u_int32_t startIndex) : m_words(words),
+              m_stopIndex(stopIndex),
+              m_numOfWords((stopIndex + 63) / 64),
+              m_wordIndex(startIndex / 64),
+              m_word(0)
+{
+    if ( startIndex < stopIndex )
+        m_word = m_words[m_wordIndex] & (~((u_int64_t) 0) << (startIndex % 64));
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the position of next one in the vector.
+ *
+ * @return index of the next one. If there is no next one found, returns -1.
+ */
+int32_t PlainBitVector::OnesIterator::next()
+{
+    while ( m_word == 0 )
+    {
+        if ( (m_wordIndex + 1) >= m_numOfWords )
+            return -1;
+
+        m_word = m_words[++m_wordIndex];
+    }
+
+    u_int32_t index = (m_wordIndex * 64) + __builtin_ctzll(m_word);
+
+    if ( index >= m_stopIndex )
+    {
+        m_word = 0;
+        m_wordIndex = m_numOfWords;
+        return -1;
+    }
+
+    m_word &= m_word - 1;   /* clear the lowest set bit */
+
+    return index;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores positions of following ones in the vector to passed array.
+ *
+ * @param out pointer to the array where positions are stored.
+ * @param maxCount maximum number of stored positions (size of the array).
+ * @return number of stored positions. If it is zero, there is no next one.
+ */
+size_t PlainBitVector::OnesIterator::nextBatch(int32_t* out, size_t maxCount)
+{
+    size_t count = 0;
+
+    while ( count < maxCount )
+    {
+        while ( m_word == 0 )
+        {
+            if ( (m_wordIndex + 1) >= m_numOfWords )
+                return count;
+
+            m_word = m_words[++m_wordIndex];
+        }
+
+        u_int32_t wordStartIndex = m_wordIndex * 64;
+
+        /* store all ones of the current word */
+        while ( (m_word != 0) && (count < maxCount) )
+        {
+            u_int32_t index = wordStartIndex + __builtin_ctzll(m_word);
+
+            if ( index >= m_stopIndex )
+            {
+                m_word = 0;
+                m_wordIndex = m_numOfWords;
+                return count;
+            }
+
+            out[count++] = index;
+            m_word &= m_word - 1;   /* clear the lowest set bit */
+        }
+    }
+
+    return count;
+}
+
+/********************************************************/
+/************ IMPLEMENTATION OF AndIterator *************/
+/********************************************************/
+
+/**
+ * Class constructor.
+ *
+ * The only meaningful way how to acquire the object of class AndIterator is by the method
+ * PlainBitVector::getAndIterator().
+ *
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array (at least one).
+ * @param stopIndex end index to which we want to search ones (not included), at most the size of vectors.
+ */
+PlainBitVector::AndIterator::AndIterator(const PlainBitVector* const* vectors, size_t numOfVectors, u_int32_t stopIndex) : m_words(numOfVectors),
+              m_stopIndex(stopIndex),
+              m_numOfWords((stopIndex + 63) / 64),
+              m_wordIndex(0),
+              m_word(0)
+{
+    for ( size_t i = 0; i < numOfVectors; ++i )
+        m_words[i] = vectors[i]->m_vec.empty() ? NULL : &vectors[i]->m_vec[0];
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the position of next one in the AND of vectors.
+ *
+ * @return index of the next one. If there is no next one found, returns -1.
+ */
+int32_t PlainBitVector::AndIterator::next()
+{
+    size_t numOfVectors = m_words.size();
+
+    while ( m_word == 0 )
+    {
+        if ( m_wordIndex >= m_numOfWords )
+            return -1;
+
+        u_int64_t word = m_words[0][m_wordIndex];
+        for ( size_t i = 1; (i < numOfVectors) && (word != 0); ++i )
+            word &= m_words[i][m_wordIndex];
+
+        m_word = word;
+        ++m_wordIndex;
+    }
+
+    u_int32_t index = ((m_wordIndex - 1) * 64) + __builtin_ctzll(m_word);
+
+    if ( index >= m_stopIndex )
+    {
+        m_word = 0;
+        m_wordIndex = m_numOfWords;
+        return -1;
+    }
+
+    m_word &= m_word - 1;   /* clear the lowest set bit */
+
+    return index;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores positions of following ones in the AND of vectors to passed array.
+ *
+ * @param out pointer to the array where positions are stored.
+ * @param maxCount maximum number of stored positions (size of the array).
+ * @return number of stored positions. If it is zero, there is no next one.
+ */
+size_t PlainBitVector::AndIterator::nextBatch(int32_t* out, size_t maxCount)
+{
+    size_t numOfVectors = m_words.size();
+    size_t count = 0;
+
+    while ( count < maxCount )
+    {
+        while ( m_word == 0 )
+        {
+            if ( m_wordIndex >= m_numOfWords )
+                return count;
+
+            u_int64_t word = m_words[0][m_wordIndex];
+            for ( size_t i = 1; (i < numOfVectors) && (word != 0); ++i )
+                word &= m_words[i][m_wordIndex];
+
+            m_word = word;
+            ++m_wordIndex;
+        }
+
+        u_int32_t wordStartIndex = (m_wordIndex - 1) * 64;
+
+        /* store all ones of the current word */
+        while ( (m_word != 0) && (count < maxCount) )
+        {
+            u_int32_t index = wordStartIndex + __builtin_ctzll(m_word);
+
+            if ( index >= m_stopIndex )
+            {
+                m_word = 0;
+                m_wordIndex = m_numOfWords;
+                return count;
+            }
+
+            out[count++] = index;
+            m_word &= m_word - 1;   /* clear the lowest set bit */
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,124 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <vector>
+#include <string>
+#include <sys/types.h>
+#include <boost/dynamic_bitset.hpp>
+
+#include "Exception.hpp"
+
+#ifndef PLAIN_BIT_VECTOR_H_517394620184736251907364518273645091827364519
+#define PLAIN_BIT_VECTOR_H_517394620184736251907364518273645091827364519
+
+/**
+ * Class PlainBitVector represents non-compressed bit vector.
+ *
+ * PlainBitVector stores bits in 64bit words without any compression, so logical operations
+ * (AND, OR) and counting of set bits are simple loops over words, which are vectorized
+ * using SSE2 or AVX2 instructions if the compiler enables them. The vector is faster than
+ * WAHBitVector for dense vectors (e.g. ACLs with many "any" addresses, wide ports ranges
+ * and protocol "ip"), but it always occupies size/8 bytes of memory.
+ * The interface is the same as the interface of WAHBitVector, so both classes can be used
+ * as the bit vector of prefix trees.
+ */
+class PlainBitVector
+{
+    private:
+        std::vector<u_int64_t> m_vec;       /** Vector containing 64bit words, bit i is stored in word i/64 at position i%64. */
+        u_int32_t m_sizeInBits;             /** Length of vector in bits */
+
+        static const size_t AND_BLOCK_WORDS = 512;     /** Number of 64bit words processed by andMany() for all vectors at once */
+
+    protected:
+        static bool andWords(u_int64_t* out, const u_int64_t* src1, const u_int64_t* src2, size_t numOfWords);
+
+    public:
+        class OnesIterator;         /** forward declaration of class OnesIterator */
+        class AndIterator;          /** forward declaration of class AndIterator */
+
+        PlainBitVector(const u_int32_t size, bool setBit = false);
+        virtual ~PlainBitVector() { };
+
+        void reset(bool fillBit = false);
+
+        void set(const u_int32_t index) throw(Exception);
+        bool get(const u_int32_t index) throw(Exception);
+        u_int32_t size();
+        u_int32_t count() const;
+        std::string toStringHex();
+        OnesIterator getOnesIterator(const u_int32_t stopIndex, const u_int32_t startIndex = 0) throw(Exception);
+
+        boost::dynamic_bitset<> getUncompressedVector();
+
+        PlainBitVector operator | (const PlainBitVector& vector2) const;
+        PlainBitVector operator & (const PlainBitVector& vector2) const;
+        PlainBitVector& operator |= (const PlainBitVector& vector2);
+        PlainBitVector& operator &= (const PlainBitVector& vector2);
+
+        static void andInto(PlainBitVector& dst, const PlainBitVector& vector1, const PlainBitVector& vector2);
+        static void orInto(PlainBitVector& dst, const PlainBitVector& vector1, const PlainBitVector& vector2);
+        static void andMany(PlainBitVector& dst, const PlainBitVector* const* vectors, size_t numOfVectors);
+        static AndIterator getAndIterator(const PlainBitVector* const* vectors, size_t numOfVectors, const u_int32_t stopIndex) throw(Exception);
+
+        /**
+         * Class OnesIterator represents the iterator of bit vector PlainBitVector which iterates through set bits.
+         *
+         * Iterator finds set bits of the current 64bit word by counting trailing zeroes, so
+         * words without set bits are skipped at once.
+         */
+        class OnesIterator
+        {
+            private:
+                const u_int64_t* const m_words;     /** Pointer to the first 64bit word of the vector */
+                const u_int32_t m_stopIndex;        /** Variable containing the value of end index to which we search set bits (not included) */
+                const u_int32_t m_numOfWords;       /** Number of words which contain bits before the stop index */
+                u_int32_t m_wordIndex;              /** Index of the current word */
+                u_int64_t m_word;                   /** Not yet returned set bits of the current word */
+
+            public:
+                OnesIterator(const u_int64_t* words, u_int32_t stopIndex, u_int32_t startIndex = 0);
+                ~OnesIterator() { };
+                int32_t next();
+                size_t nextBatch(int32_t* out, size_t maxCount);
+        };
+
+        /**
+         * Class AndIterator represents the iterator through set bits of logical AND of several PlainBitVector-s.
+         *
+         * Words of the result are computed one by one when they are needed, so the result
+         * is never stored and words after the stop index are not read.
+         */
+        class AndIterator
+        {
+            private:
+                std::vector<const u_int64_t*> m_words;  /** Pointers to the first 64bit words of all vectors */
+                const u_int32_t m_stopIndex;            /** Variable containing the value of end index to which we search set bits (not included) */
+                const u_int32_t m_numOfWords;           /** Number of words which contain bits before the stop index */
+                u_int32_t m_wordIndex;                  /** Index of the word following the current word */
+                u_int64_t m_word;                       /** Not yet returned set bits of the current word */
+
+            public:
+                AndIterator(const PlainBitVector* const* vectors, size_t numOfVectors, u_int32_t stopIndex);
+                ~AndIterator() { };
+                int32_t next();
+                size_t nextBatch(int32_t* out, size_t maxCount);
+        };
+};
+
+#endif /* PLAIN_BIT_VECTOR_H_517394620184736251907364518273645091827364519 */
@@ -0,0 +1,211 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "PortIntervalTable.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * Constructor splits ports into elementary intervals by ranges of all rules of the ACL.
+ *
+ * @param acl reference to the ACL whose rules will be added to the table.
+ * @param dimension port dimension of rules (DIMENSION_SRC_PRT or DIMENSION_DST_PRT).
+ * @param arena pointer to the arena providing blocks of the pool of bit vectors, NULL if they are taken from the heap.
+ *              The arena has to exist until the table is destroyed.
+ */
+template < class BitVector >
+PortIntervalTable< BitVector >::PortIntervalTable(const AccessControlList& acl, int dimension, MemoryArena* arena) : m_dimension(dimension),
+                                                                                                 m_numOfAclRules(acl.size()),
+                                                                                                 m_intervalOfPort(NUM_OF_PORTS, 0),
+                                                                                                 m_numOfIntervals(1),
+                                                                                                 m_numOfLeaves(1),
+                                                                                                 m_vectorPool(arena)
+{
+    vector< bool > intervalStarts(NUM_OF_PORTS, false);
+    u_int16_t start, stop;
+
+    /* mark first ports of intervals (starts of ranges and ports following their ends) */
+    for ( size_t i = 0; i < acl.size(); ++i )
+    {
+        getPortRange(acl[i], start, stop);
+
+        intervalStarts[start] = true;
+        if ( stop < (NUM_OF_PORTS - 1) )
+            intervalStarts[stop + 1] = true;
+    }
+
+    for ( u_int32_t port = 1; port < NUM_OF_PORTS; ++port )
+    {
+        if ( intervalStarts[port] )
+            ++m_numOfIntervals;
+
+        m_intervalOfPort[port] = m_numOfIntervals - 1;
+    }
+
+    while ( m_numOfLeaves < m_numOfIntervals )
+        m_numOfLeaves <<= 1;
+
+    m_bitVectors1.resize(2 * m_numOfLeaves, NULL);
+    m_bitVectors2.resize(2 * m_numOfLeaves, NULL);
+    m_visitedBy.resize(2 * m_numOfLeaves, 0);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ *
+ * Bit vectors of nodes are destructed by their pool.
+ */
+template < class BitVector >
+PortIntervalTable< BitVector >::~PortIntervalTable() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the port range of the rule in the dimension of the table.
+ *
+ * Negated range is returned as the whole range of ports.
+ *
+ * @param rule reference to the rule.
+ * @param start reference to the variable where the first port of the range is stored.
+ * @param stop reference to the variable where the last port of the range is stored.
+ */
+template < class BitVector >
+void PortIntervalTable< BitVector >::getPortRange(const AclRule& rule, u_int16_t& start, u_int16_t& stop) const
+{
+    bool negated;
+
+    if ( m_dimension == DIMENSION_SRC_PRT )
+    {
+        start = rule.getSrcPortStart();
+        stop = rule.getSrcPortStop();
+        negated = rule.getSrcPortNeg();
+    }
+    else
+    {
+        start = rule.getDstPortStart();
+        stop = rule.getDstPortStop();
+        negated = rule.getDstPortNeg();
+    }
+
+    if ( negated )
+    {
+        start = 0;
+        stop = NUM_OF_PORTS - 1;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the bit vector of the node, the empty vector is created if it does not exist.
+ *
+ * @param vectors reference to the vector of BitVector1-s or BitVector2-s of nodes.
+ * @param node index of the node.
+ * @return reference to the bit vector of the node.
+ */
+template < class BitVector >
+BitVector& PortIntervalTable< BitVector >::nodeVector(std::vector< BitVector* >& vectors, u_int32_t node)
+{
+    if ( vectors[node] == NULL )
+        vectors[node] = m_vectorPool.construct(m_numOfAclRules);
+
+    return *(vectors[node]);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the table according to its port range.
+ *
+ * The rule is stored to the nodes covering its intervals, conflict bit vector is OR of their
+ * BitVector2-s and BitVector1-s of their ancestors. Ancestors shared by more nodes are visited once.
+ *
+ * @param rule reference to the added rule.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void PortIntervalTable< BitVector >::addNewRule(const AclRule& rule, BitVector& conflictVector)
+{
+    unsigned rulePositionNum = rule.getPosition();
+    u_int16_t start, stop;
+
+    getPortRange(rule, start, stop);
+
+    /* the last interval covers also padding leaves, so the whole range is stored in the root */
+    u_int32_t firstLeaf = m_numOfLeaves + m_intervalOfPort[start];
+    u_int32_t lastLeaf = (stop == (NUM_OF_PORTS - 1)) ? (2 * m_numOfLeaves - 1) : (m_numOfLeaves + m_intervalOfPort[stop]);
+
+    /* nodes covering exactly the intervals of the range */
+    m_rangeNodes.clear();
+    for ( u_int32_t left = firstLeaf, right = lastLeaf + 1; left < right; left >>= 1, right >>= 1 )
+    {
+        if ( left & 1 )
+            m_rangeNodes.push_back(left++);
+
+        if ( right & 1 )
+            m_rangeNodes.push_back(--right);
+    }
+
+    conflictVector.reset(false);
+
+    for ( size_t i = 0; i < m_rangeNodes.size(); ++i )
+    {
+        u_int32_t node = m_rangeNodes[i];
+
+        nodeVector(m_bitVectors1, node).set(rulePositionNum);
+
+        BitVector& bitVector2 = nodeVector(m_bitVectors2, node);
+        bitVector2.set(rulePositionNum);
+        conflictVector |= bitVector2;
+
+        /* ancestors -> set bitVector2 and do OR of bitVector1 with conflictVector */
+        for ( u_int32_t parent = node >> 1; (parent > 0) && (m_visitedBy[parent] != rulePositionNum + 1); parent >>= 1 )
+        {
+            m_visitedBy[parent] = rulePositionNum + 1;
+            nodeVector(m_bitVectors2, parent).set(rulePositionNum);
+
+            if ( m_bitVectors1[parent] != NULL )
+                conflictVector |= *(m_bitVectors1[parent]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of nodes of the tree of intervals.
+ *
+ * @return number of nodes including padding leaves.
+ */
+template < class BitVector >
+size_t PortIntervalTable< BitVector >::numOfNodes() const
+{
+    return 2 * m_numOfLeaves - 1;
+}
+
+//-----------------------------------------------------------------------------------
+
+/* tables of port intervals with all supported bit vectors */
+template class PortIntervalTable< WAHBitVector >;
+template class PortIntervalTable< PlainBitVector >;
+template class PortIntervalTable< RoaringBitVector >;
@@ -0,0 +1,82 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <vector>
+
+#include "AclRule.hpp"
+#include "AccessControlList.hpp"
+#include "DimensionIndex.hpp"
+#include "MemoryArena.hpp"
+#include "ObjectPool.hpp"
+#include "WAHBitVector.hpp"
+#include "PlainBitVector.hpp"
+#include "RoaringBitVector.hpp"
+
+#ifndef PORT_INTERVAL_TABLE_H__8192736450918273645019283746501928374650192837465
+#define PORT_INTERVAL_TABLE_H__8192736450918273645019283746501928374650192837465
+
+/**
+ * Class PortIntervalTable represents the table of elementary intervals for one port dimension of ACL rule.
+ *
+ * Starts and ends of port ranges of all rules of the ACL split ports into elementary intervals,
+ * so every range consists of whole intervals and the interval of every port is found by one lookup
+ * in the direct-indexed table. Intervals are leaves of the complete binary tree stored in an array
+ * (segment tree) and the range of the rule is stored in the smallest set of nodes covering exactly
+ * its intervals. Nodes have the same bit vectors as nodes of PrefixTree: BitVector1 contains rules
+ * stored in the node, BitVector2 rules stored in the node or in its subtree. Two ranges overlap
+ * if a node of one of them is an ancestor of a node of the other, so the conflict bit vector is OR
+ * of BitVector2 of nodes of the range and BitVector1 of their ancestors. A range has at most
+ * two nodes per level and the tree has only about log2 of the number of intervals levels.
+ *
+ * Found conflicting rules are exactly the rules with overlapping ranges (negated ranges are handled
+ * as the whole range), which is the subset of rules found by the prefix tree of "super-prefixes"
+ * of ranges (see PrefixTree).
+ *
+ * The table is parametrized by the class of bit vectors (WAHBitVector, PlainBitVector
+ * or RoaringBitVector). Instances for all classes are compiled in PortIntervalTable.cpp.
+ */
+template < class BitVector >
+class PortIntervalTable : public DimensionIndex< BitVector >
+{
+    private:
+        static const u_int32_t NUM_OF_PORTS = 65536;   /** Number of port numbers (size of the table of intervals). */
+
+        const int m_dimension;                          /** Port dimension of rules (DIMENSION_SRC_PRT or DIMENSION_DST_PRT). */
+        const u_int32_t m_numOfAclRules;                /** Number of the rules in ACL for which the table is created. */
+        std::vector< u_int16_t > m_intervalOfPort;      /** Index of the elementary interval of every port. */
+        u_int32_t m_numOfIntervals;                     /** Number of elementary intervals. */
+        u_int32_t m_numOfLeaves;                        /** Number of leaves of the tree (power of two, at least the number of intervals). */
+        std::vector< BitVector* > m_bitVectors1;        /** BitVector1 of every node (root has index 1), NULL if empty. */
+        std::vector< BitVector* > m_bitVectors2;        /** BitVector2 of every node, NULL if empty. */
+        std::vector< u_int32_t > m_visitedBy;           /** Position of the rule (plus one) which visited the node last. */
+        std::vector< u_int32_t > m_rangeNodes;          /** Nodes of the range of the added rule. */
+        ObjectPool< BitVector > m_vectorPool;           /** Pool of bit vectors of all nodes. */
+
+    protected:
+        void getPortRange(const AclRule& rule, u_int16_t& start, u_int16_t& stop) const;
+        BitVector& nodeVector(std::vector< BitVector* >& vectors, u_int32_t node);
+
+    public:
+        PortIntervalTable(const AccessControlList& acl, int dimension, MemoryArena* arena = NULL);
+        virtual ~PortIntervalTable();
+
+        virtual void addNewRule(const AclRule& rule, BitVector& conflictVector);
+        virtual size_t numOfNodes() const;
+};
+
+#endif /* PORT_INTERVAL_TABLE_H__8192736450918273645019283746501928374650192837465 */
@@ -19,6 +19,8 @@
 
 #include <sys/types.h>
 
+#include "KeywordTable.hpp"
+
 #ifndef PORTS_DEF_HPP__8748486411084483480113887515387301840413015340744
 #define PORTS_DEF_HPP__8748486411084483480113887515387301840413015340744
 
@@ -103,4 +105,98 @@ const u_int16_t PORT_NFSD = 2049;               /** nfsd */
 const u_int16_t PORT_CVSPSERVER = 2401;         /** cvspserver */
 const u_int16_t PORT_NON500_ISAKMP = 4500;      /** non500-isakmp */
 
+/**
+ * Names of ports recognized by input parsers (see KeywordTable).
+ */
+const KEYWORD PORT_KEYWORDS[] =
+{
+    { "echo", PORT_ECHO },
+    { "discard", PORT_DISCARD },
+    { "daytime", PORT_DAYTIME },
+    { "chargen", PORT_CHARGEN },
+    { "ftp-data", PORT_FTP_DATA },
+    { "ftp", PORT_FTP },
+    { "ssh", PORT_SSH },
+    { "telnet", PORT_TELNET },
+    { "smtp", PORT_SMTP },
+    { "time", PORT_TIME },
+    { "nameserver", PORT_NAMESERVER },
+    { "whois", PORT_WHOIS },
+    { "tacacs", PORT_TACACS },
+    { "domain", PORT_DOMAIN },
+    { "tacacs-ds", PORT_TACACS_DS },
+    { "bootps", PORT_BOOTPS },
+    { "bootpc", PORT_BOOTPC },
+    { "tftp", PORT_TFTP },
+    { "gopher", PORT_GOPHER },
+    { "finger", PORT_FINGER },
+    { "www", PORT_WWW },
+    { "kerberos-sec", PORT_KERBEROS_SEC },
+    { "hostname", PORT_HOSTNAME },
+    { "pop2", PORT_POP2 },
+    { "pop3", PORT_POP3 },
+    { "sunrpc", PORT_SUNRPC },
+    { "ident", PORT_IDENT },
+    { "nntp", PORT_NNTP },
+    { "ntp", PORT_NTP },
+    { "netbios-ns", PORT_NETBIOS_NS },
+    { "netbios-dgm", PORT_NETBIOS_DGM },
+    { "netbios-ss", PORT_NETBIOS_SS },
+    { "imap", PORT_IMAP },
+    { "snmp", PORT_SNMP },
+    { "snmptrap", PORT_SNMPTRAP },
+    { "xdmcp", PORT_XDMCP },
+    { "bgp", PORT_BGP },
+    { "irc", PORT_IRC },
+    { "dnsix", PORT_DNSIX },
+    { "ldap", PORT_LDAP },
+    { "mobile-ip", PORT_MOBILE_IP },
+    { "mobilip-mn", PORT_MOBIL_IP_MN },
+    { "https", PORT_HTTPS },
+    { "snpp", PORT_SNPP },
+    { "pim-auto-rp", PORT_PIM_AUTO_RP },
+    { "isakmp", PORT_ISAKMP },
+    { "biff", PORT_BIFF },
+    { "exec", PORT_EXEC },
+    { "login", PORT_LOGIN },
+    { "who", PORT_WHO },
+    { "cmd", PORT_CMD },
+    { "syslog", PORT_SYSLOG },
+    { "lpd", PORT_LPD },
+    { "talk", PORT_TALK },
+    { "ntalk", PORT_NTALK },
+    { "rip", PORT_RIP },
+    { "timed", PORT_TIMED },
+    { "uucp", PORT_UUCP },
+    { "klogin", PORT_KLOGIN },
+    { "kshell", PORT_KSHELL },
+    { "dhcp", PORT_DHCP },
+    { "msdp", PORT_MSDP },
+    { "ldp", PORT_LDP },
+    { "krb-prop", PORT_KRB_PROP },
+    { "krbupdate", PORT_KRBUPDATE },
+    { "kpasswd", PORT_KPASSWD },
+    { "socks", PORT_SOCKS },
+    { "afs", PORT_AFS },
+    { "radius-old", PORT_RADIUS_OLD },
+    { "pptp", PORT_PPTP },
+    { "radius", PORT_RADIUS },
+    { "radacct", PORT_RADACCT },
+    { "zephyr-clt", PORT_ZEPHYR_CLT },
+    { "zephyr-hm", PORT_ZEPHYR_HM },
+    { "eklogin", PORT_EKLOGIN },
+    { "ekshell", PORT_EKSHELL },
+    { "rkinit", PORT_RKINIT },
+    { "nfsd", PORT_NFSD },
+    { "cvspserver", PORT_CVSPSERVER },
+    { "non500-isakmp", PORT_NON500_ISAKMP },
+    /* aliases */
+    { "comsat", PORT_BIFF },
+    { "http", PORT_WWW },
+    { "rwho", PORT_WHO },
+    { "router", PORT_RIP }
+};
+
+const size_t PORT_KEYWORDS_COUNT = sizeof(PORT_KEYWORDS) / sizeof(PORT_KEYWORDS[0]);   /** Number of port names. */
+
 #endif /* PORTS_DEF_HPP__8748486411084483480113887515387301840413015340744 */
\ No newline at end of file
@@ -30,24 +30,366 @@ using namespace std;
  *
  * @param aclSize unsigned value representing the number of rules in ACL
  *                for which the forest of prefix trees is created.
+ * @param indexType structure used for dimensions (constant INDEX_XXX, INDEX_BINARY_TRIE by default).
+ *                  INDEX_DIRECT_TABLES uses prefix trees for ports, as their table needs the whole ACL.
  * @param numOfDimensions umber of dimensions of rules which are in ACL.
  *                        Default value is DIMENSION_MAX + 1 (as the dimensions are numbered from "0").
  */
-PrefixForest::PrefixForest(u_int32_t aclSize, int numOfDimensions) : m_numOfAclRules(aclSize), m_numOfRuleDimensions(numOfDimensions)
+template < class BitVector >
+PrefixForest< BitVector >::PrefixForest(u_int32_t aclSize, int indexType, int numOfDimensions) : m_numOfAclRules(aclSize),
+                                                                     m_numOfRuleDimensions(numOfDimensions),
+                                                                     m_indexType(indexType),
+                                                                     m_insertionMode(INSERTION_SEQUENTIAL),
+                                                                     m_pipelinedAcl(NULL),
+                                                                     m_numOfStartedPipelines(0),
+                                                                     m_stopPipelines(false)
 {
-    /* create prefix trees */
-    for ( int i = DIMENSION_MIN; i < numOfDimensions; ++i )
+    pthread_mutex_init(&m_pipelineLock, NULL);
+    pthread_cond_init(&m_pipelineProduced, NULL);
+    pthread_cond_init(&m_pipelineConsumed, NULL);
+
+    createIndices(NULL);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class constructor.
+ *
+ * Class constructor that creates the forest for all dimensions of rules of the passed ACL.
+ * Structures of dimensions can be built from all rules of the ACL (see PortIntervalTable).
+ *
+ * @param acl reference to the ACL for which the forest is created. ACL has to exist until the forest is destroyed.
+ * @param indexType structure used for dimensions (constant INDEX_XXX, INDEX_BINARY_TRIE by default).
+ */
+template < class BitVector >
+PrefixForest< BitVector >::PrefixForest(const AccessControlList& acl, int indexType) : m_numOfAclRules(acl.size()),
+                                                                     m_numOfRuleDimensions(DIMENSION_MAX + 1),
+                                                                     m_indexType(indexType),
+                                                                     m_insertionMode(INSERTION_SEQUENTIAL),
+                                                                     m_pipelinedAcl(NULL),
+                                                                     m_numOfStartedPipelines(0),
+                                                                     m_stopPipelines(false)
+{
+    pthread_mutex_init(&m_pipelineLock, NULL);
+    pthread_cond_init(&m_pipelineProduced, NULL);
+    pthread_cond_init(&m_pipelineConsumed, NULL);
+
+    createIndices(&acl);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ *
+ * If the pipelined mode is used, threads updating the trees are stopped.
+ */
+template < class BitVector >
+PrefixForest< BitVector >::~PrefixForest()
+{
+    stopPipelinedInsertion();
+
+    pthread_cond_destroy(&m_pipelineConsumed);
+    pthread_cond_destroy(&m_pipelineProduced);
+    pthread_mutex_destroy(&m_pipelineLock);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method creates structures and reused conflict vectors of all dimensions of the forest.
+ *
+ * Every structure takes its memory from its own arena, so structures updated by different
+ * threads in the pipelined mode never share an arena.
+ *
+ * @param acl pointer to the ACL for which the forest is created, NULL if only its size is known.
+ */
+template < class BitVector >
+void PrefixForest< BitVector >::createIndices(const AccessControlList* acl)
+{
+    for ( int i = DIMENSION_MIN; i < m_numOfRuleDimensions; ++i )
     {
-        m_triesVector.push_back(new PrefixTree(aclSize));
+        m_arenas.push_back(new MemoryArena());
+        m_triesVector.push_back(createIndex(m_indexType, i, m_numOfAclRules, acl, &m_arenas.back()));
+        m_dimensionVectors.push_back(new BitVector(m_numOfAclRules));
+        m_andOperands.push_back(&m_dimensionVectors.back());
     }
 }
 
 //-----------------------------------------------------------------------------------
 
 /**
- * Class destructor.
+ * Method creates the structure for one dimension of the forest.
+ *
+ * @param indexType structure used for the dimension (constant INDEX_XXX), unknown values select INDEX_BINARY_TRIE.
+ * @param dimension dimension of rules (constant DIMENSION_XXX).
+ * @param aclSize number of rules in ACL.
+ * @param acl pointer to the ACL, NULL if it is not known (structures built from the whole ACL are replaced by prefix trees).
+ * @param arena pointer to the arena providing memory of nodes and bit vectors of the structure, it has to exist until the structure is destroyed.
+ * @return pointer to the new structure (owned by the caller).
+ */
+template < class BitVector >
+DimensionIndex< BitVector >* PrefixForest< BitVector >::createIndex(int indexType, int dimension, u_int32_t aclSize, const AccessControlList* acl, MemoryArena* arena)
+{
+    if ( indexType == INDEX_PATRICIA_TRIE )
+        return new PatriciaTree< BitVector >(aclSize, dimension, arena);
+
+    if ( indexType == INDEX_DIRECT_TABLES )
+    {
+        if ( dimension == DIMENSION_PROTO )
+            return new ProtocolTable< BitVector >(aclSize, arena);
+
+        if ( (dimension == DIMENSION_SRC_PRT || dimension == DIMENSION_DST_PRT) && (acl != NULL) )
+            return new PortIntervalTable< BitVector >(*acl, dimension, arena);
+    }
+
+    if ( dimension == DIMENSION_SRC_IP || dimension == DIMENSION_DST_IP )
+    {
+        if ( indexType == INDEX_MULTIBIT_TRIE || indexType == INDEX_DIRECT_TABLES )
+            return new MultibitTree< BitVector >(aclSize, dimension, STRIDES_8_8_8_8, arena);
+
+        if ( indexType == INDEX_MULTIBIT_WIDE_TRIE )
+            return new MultibitTree< BitVector >(aclSize, dimension, STRIDES_16_8_8, arena);
+    }
+
+    return new PrefixTree< BitVector >(aclSize, dimension, arena);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method starts the pipelined insertion of rules of passed ACL.
+ *
+ * Method starts one thread for every prefix tree of the forest. Each thread inserts
+ * rules of passed ACL into its tree in the order of the ACL and it can run up to
+ * PIPELINE_DEPTH - 1 rules ahead of the thread calling addAclRule(). Conflict vectors
+ * are computed into PIPELINE_DEPTH vectors of every thread allocated here, and the slot
+ * of the rule is handed back to the thread when the next rule is added. After this method
+ * is called, rules of passed ACL have to be added by addAclRule() in their order.
+ *
+ * @throw Exception if the pipelined mode is already started, ACL size does not match
+ *                  the size of the forest, or no thread could be started.
+ * @param acl reference to the ACL whose rules will be inserted into the forest.
+ *            ACL has to exist until the forest is destroyed.
  */
-PrefixForest::~PrefixForest() { }
+template < class BitVector >
+void PrefixForest< BitVector >::startPipelinedInsertion(const AccessControlList& acl) throw(Exception)
+{
+    if ( m_insertionMode == INSERTION_PIPELINED )
+        throw Exception("Pipelined insertion already started!");
+
+    if ( acl.size() != m_numOfAclRules )
+        throw Exception("ACL size does not match the size of the prefix forest!");
+
+    m_pipelinedAcl = &acl;
+    m_stopPipelines = false;
+    m_pipelines.resize(m_numOfRuleDimensions);
+
+    for ( int i = DIMENSION_MIN; i < m_numOfRuleDimensions; ++i )
+    {
+        m_pipelines[i].m_forest = this;
+        m_pipelines[i].m_dimension = i;
+        m_pipelines[i].m_slots.assign(PIPELINE_DEPTH, (BitVector*) NULL);
+        m_pipelines[i].m_produced = 0;
+        m_pipelines[i].m_taken = 0;
+        m_pipelines[i].m_consumed = 0;
+        m_pipelines[i].m_failedRule = m_numOfAclRules;
+
+        /* vectors of slots are reused for all rules */
+        for ( size_t j = 0; j < PIPELINE_DEPTH; ++j )
+            m_pipelines[i].m_slots[j] = new BitVector(m_numOfAclRules);
+    }
+
+    for ( m_numOfStartedPipelines = 0; m_numOfStartedPipelines < m_pipelines.size(); ++m_numOfStartedPipelines )
+    {
+        if ( pthread_create(&m_pipelines[m_numOfStartedPipelines].m_thread, NULL, PrefixForest< BitVector >::pipelineMain, &m_pipelines[m_numOfStartedPipelines]) != 0 )
+        {
+            stopPipelinedInsertion();
+            throw Exception("Cannot start thread for pipelined insertion!");
+        }
+    }
+
+    m_insertionMode = INSERTION_PIPELINED;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method builds structures of all dimensions from the rules of passed ACL at once.
+ *
+ * After this method is called, rules of passed ACL are only queried by addAclRule() and
+ * insertAclRule() and their conflict vectors contain also following rules of the ACL,
+ * so conflicting rules have to be bounded by the position of the rule (see getConflictsIterator()).
+ * Structures which do not support the bulk load (see DimensionIndex::bulkLoad()) are still
+ * updated rule by rule, so all rules of the ACL have to be added in their order.
+ *
+ * @throw Exception if the pipelined or bulk mode is already started, or ACL size does not match
+ *                  the size of the forest.
+ * @param acl reference to the ACL whose rules are loaded into the forest.
+ */
+template < class BitVector >
+void PrefixForest< BitVector >::bulkLoad(const AccessControlList& acl) throw(Exception)
+{
+    if ( m_insertionMode != INSERTION_SEQUENTIAL )
+        throw Exception("Insertion mode of the prefix forest already started!");
+
+    if ( acl.size() != m_numOfAclRules )
+        throw Exception("ACL size does not match the size of the prefix forest!");
+
+    for ( size_t i = 0; i < m_triesVector.size(); ++i )
+        m_triesVector[i].bulkLoad(acl);
+
+    m_insertionMode = INSERTION_BULK;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stops all threads of the pipelined insertion and frees not consumed conflict vectors.
+ */
+template < class BitVector >
+void PrefixForest< BitVector >::stopPipelinedInsertion()
+{
+    pthread_mutex_lock(&m_pipelineLock);
+    m_stopPipelines = true;
+    pthread_cond_broadcast(&m_pipelineConsumed);
+    pthread_mutex_unlock(&m_pipelineLock);
+
+    for ( size_t i = 0; i < m_numOfStartedPipelines; ++i )
+        pthread_join(m_pipelines[i].m_thread, NULL);
+
+    for ( size_t i = 0; i < m_pipelines.size(); ++i )
+    {
+        for ( size_t j = 0; j < m_pipelines[i].m_slots.size(); ++j )
+        {
+            delete m_pipelines[i].m_slots[j];
+            m_pipelines[i].m_slots[j] = NULL;
+        }
+    }
+
+    /* conflict vectors of the last rule were kept by slots */
+    for ( size_t i = 0; i < m_andOperands.size(); ++i )
+        m_andOperands[i] = &m_dimensionVectors[i];
+
+    m_numOfStartedPipelines = 0;
+    m_insertionMode = INSERTION_SEQUENTIAL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method containing the main loop of the thread updating one prefix tree.
+ *
+ * @param pipeline reference to the structure of the pipeline served by the thread.
+ */
+template < class BitVector >
+void PrefixForest< BitVector >::pipelineLoop(typename PrefixForest< BitVector >::DimensionPipeline& pipeline)
+{
+    DimensionIndex< BitVector >& tree = m_triesVector[pipeline.m_dimension];
+
+    for ( size_t j = 0; j < m_numOfAclRules; ++j )
+    {
+        /* wait for free slot in the buffer */
+        pthread_mutex_lock(&m_pipelineLock);
+        while ( ((pipeline.m_produced - pipeline.m_consumed) >= PIPELINE_DEPTH) && !m_stopPipelines )
+            pthread_cond_wait(&m_pipelineConsumed, &m_pipelineLock);
+
+        bool stop = m_stopPipelines;
+        pthread_mutex_unlock(&m_pipelineLock);
+
+        if ( stop )
+            return;
+
+        /* the slot is free, so its vector is not used by the calling thread */
+        const AclRule& rule = (*m_pipelinedAcl)[j];
+        BitVector* vector = pipeline.m_slots[j % PIPELINE_DEPTH];
+        string error;
+
+        try {
+            vector->reset(false);
+            tree.addNewRule(rule, *vector);
+        }
+        catch ( Exception& e )
+        {
+            error = e.getMessage();
+        }
+
+        pthread_mutex_lock(&m_pipelineLock);
+        if ( !error.empty() )
+        {
+            pipeline.m_error = error;
+            pipeline.m_failedRule = j;
+        }
+        ++pipeline.m_produced;
+        pthread_cond_broadcast(&m_pipelineProduced);
+        pthread_mutex_unlock(&m_pipelineLock);
+
+        if ( !error.empty() )
+            return;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Entry function of the thread updating one prefix tree.
+ *
+ * @param args pointer to the structure DimensionPipeline.
+ * @return always NULL.
+ */
+template < class BitVector >
+void* PrefixForest< BitVector >::pipelineMain(void* args)
+{
+    DimensionPipeline* pipeline = (DimensionPipeline*) args;
+    pipeline->m_forest->pipelineLoop(*pipeline);
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the mode in which rules are inserted into prefix trees.
+ *
+ * @return constant INSERTION_SEQUENTIAL, INSERTION_PIPELINED or INSERTION_BULK.
+ */
+template < class BitVector >
+int PrefixForest< BitVector >::insertionMode() const
+{
+    return m_insertionMode;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the structure used for dimensions of the forest.
+ *
+ * @return constant INDEX_XXX.
+ */
+template < class BitVector >
+int PrefixForest< BitVector >::indexType() const
+{
+    return m_indexType;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of nodes of structures of all dimensions.
+ *
+ * @return sum of numbers of nodes of all dimensions.
+ */
+template < class BitVector >
+size_t PrefixForest< BitVector >::numOfNodes() const
+{
+    size_t nodes = 0;
+
+    for ( size_t i = 0; i < m_triesVector.size(); ++i )
+        nodes += m_triesVector[i].numOfNodes();
+
+    return nodes;
+}
 
 //-----------------------------------------------------------------------------------
 
@@ -55,24 +397,150 @@ PrefixForest::~PrefixForest() { }
  * Method for adding new rule to prefix forest.
  *
  * Method adds passed rule to the forest of prefix trees. It returns the object auto_ptr containing the pointer
- * to conflict bit vector of type WAHBitVector for passed rule. Conflict bit vector has
+ * to conflict bit vector for passed rule. Conflict bit vector has
  * set value "1" at the position "i", if there is a rule in ACL at position "i", that
  * is in the conflict with passed rule and the rule "i" is already in the prefix forest.
  * The conflict is determined by dimensions of rules in prefix format.
  *
+ * @throw Exception if the insertion into some tree failed, or in the pipelined mode,
+ *                  if the rule is not the next rule of the ACL.
  * @param rule reference to the object AclRule to be added to the forest
- * @return object auto_ptr containing the pointer to the conflict bit vector of type WAHBitVector
+ * @return object auto_ptr containing the pointer to the conflict bit vector
  *         for passed rule 
  */
-auto_ptr< WAHBitVector > PrefixForest::addAclRule(const AclRule& rule)
+template < class BitVector >
+auto_ptr< BitVector > PrefixForest< BitVector >::addAclRule(const AclRule& rule) throw(Exception)
 {
-    auto_ptr< WAHBitVector > conflictsVector(new WAHBitVector(m_numOfAclRules, true));
+    auto_ptr< BitVector > conflictsVector(new BitVector(m_numOfAclRules));
+
+    addAclRule(rule, *conflictsVector);
+
+    return conflictsVector;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method for adding new rule to prefix forest.
+ *
+ * Method adds passed rule to the forest of prefix trees and stores its conflict bit vector
+ * to the passed vector (see addAclRule(const AclRule&)). Conflict vectors of single dimensions
+ * are kept by the forest and the result is stored to the vector of the caller, so no memory
+ * is allocated for conflict vectors once they are large enough. In the bulk mode the vector
+ * contains also conflicting rules following the passed rule.
+ *
+ * @throw Exception if the insertion into some tree failed, or in the pipelined mode,
+ *                  if the rule is not the next rule of the ACL.
+ * @param rule reference to the object AclRule to be added to the forest
+ * @param conflictsVector reference to the bit vector of the ACL size where the conflict
+ *                        bit vector for passed rule is stored.
+ */
+template < class BitVector >
+void PrefixForest< BitVector >::addAclRule(const AclRule& rule, BitVector& conflictsVector) throw(Exception)
+{
+    insertAclRule(rule);
+
+    /* AND of conflict vectors of all dimensions */
+    BitVector::andMany(conflictsVector, &m_andOperands[0], m_andOperands.size());
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method inserts new rule to prefix forest without computing its conflict bit vector.
+ *
+ * Conflict vectors of single dimensions are kept by the forest until the next rule is inserted
+ * and conflicting rules can be iterated by the iterator returned by getConflictsIterator().
+ *
+ * In the pipelined mode the rule is already inserted into the trees by their threads
+ * and the method only takes conflict vectors computed by them. In the bulk mode conflict
+ * vectors of the rule kept by loaded structures are used without copying.
+ *
+ * @throw Exception if the insertion into some tree failed, or in the pipelined mode,
+ *                  if the rule is not the next rule of the ACL.
+ * @param rule reference to the object AclRule to be added to the forest
+ */
+template < class BitVector >
+void PrefixForest< BitVector >::insertAclRule(const AclRule& rule) throw(Exception)
+{
+    if ( m_insertionMode == INSERTION_PIPELINED )
+    {
+        size_t index = m_pipelines[DIMENSION_MIN].m_taken;
+
+        if ( (index >= m_numOfAclRules) || (&rule != &(*m_pipelinedAcl)[index]) )
+            throw Exception("Rules have to be added in the order of the ACL in pipelined insertion mode!");
+
+        for ( int i = DIMENSION_MIN; i < m_numOfRuleDimensions; ++i )
+        {
+            DimensionPipeline& pipeline = m_pipelines[i];
+
+            pthread_mutex_lock(&m_pipelineLock);
+
+            /* hand the slot of the previous rule back to the thread */
+            if ( pipeline.m_consumed < pipeline.m_taken )
+            {
+                ++pipeline.m_consumed;
+                pthread_cond_broadcast(&m_pipelineConsumed);
+            }
+
+            while ( pipeline.m_produced <= index )
+                pthread_cond_wait(&m_pipelineProduced, &m_pipelineLock);
+
+            bool failed = (pipeline.m_failedRule == index);
+            string error = pipeline.m_error;
+            ++pipeline.m_taken;
+            pthread_mutex_unlock(&m_pipelineLock);
+
+            if ( failed )
+                throw Exception(error);
+
+            m_andOperands[i] = pipeline.m_slots[index % PIPELINE_DEPTH];
+        }
+
+        return;
+    }
 
-    unsigned tmp_rulePosition = rule.getPosition();
     for ( int i = DIMENSION_MIN; i < m_numOfRuleDimensions; ++i )
     {
-        *conflictsVector &= *(m_triesVector[i].addNewRulePrefix(rule.getFieldPrefix(i), tmp_rulePosition));
+        /* conflict vectors of loaded structures are used directly */
+        const BitVector* loadedVector = (m_insertionMode == INSERTION_BULK) ? m_triesVector[i].getLoadedConflictVector(rule) : NULL;
+
+        if ( loadedVector != NULL )
+        {
+            m_andOperands[i] = loadedVector;
+            continue;
+        }
+
+        m_triesVector[i].addNewRule(rule, m_dimensionVectors[i]);
+        m_andOperands[i] = &m_dimensionVectors[i];
     }
+}
 
-    return conflictsVector;
-}
\ No newline at end of file
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the iterator through conflicting rules of the last inserted rule.
+ *
+ * Iterator returns positions of set bits of the AND of conflict vectors of single dimensions,
+ * so the conflict bit vector is never built. Iterator is valid until the next rule is inserted.
+ *
+ * @throw Exception if the forest has no dimension.
+ * @param stopIndex position of the rule to which conflicting rules are iterated (not included),
+ *                  usually the position of the last inserted rule.
+ * @return iterator through positions of conflicting rules.
+ */
+template < class BitVector >
+typename BitVector::AndIterator PrefixForest< BitVector >::getConflictsIterator(u_int32_t stopIndex) throw(Exception)
+{
+    if ( m_andOperands.empty() )
+        throw Exception("Prefix forest has no dimension!");
+
+    return BitVector::getAndIterator(&m_andOperands[0], m_andOperands.size(), stopIndex);
+}
+
+//-----------------------------------------------------------------------------------
+
+/* forests of prefix trees with all supported bit vectors */
+template class PrefixForest< WAHBitVector >;
+template class PrefixForest< PlainBitVector >;
+template class PrefixForest< RoaringBitVector >;
@@ -16,29 +16,117 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>
  */
 
+#include <pthread.h>
+#include <vector>
+#include <string>
 #include <boost/ptr_container/ptr_vector.hpp>
 
 #include "AclRule.hpp"
+#include "AccessControlList.hpp"
+#include "DimensionIndex.hpp"
+#include "MemoryArena.hpp"
 #include "PrefixTree.hpp"
+#include "PatriciaTree.hpp"
+#include "MultibitTree.hpp"
+#include "ProtocolTable.hpp"
+#include "PortIntervalTable.hpp"
+#include "Exception.hpp"
 
 #ifndef PREFIX_FOREST_H__651351754168484351169411344616164137418631356816168454
 #define PREFIX_FOREST_H__651351754168484351169411344616164137418631356816168454
 
+/**
+ * Constants representing the mode of inserting rules into prefix trees of the forest.
+ */
+const int INSERTION_SEQUENTIAL = 0;     /** Rule is inserted into all trees one after another by the calling thread. */
+const int INSERTION_PIPELINED = 1;      /** Every tree is updated by its own thread running ahead of the calling thread. */
+const int INSERTION_BULK = 2;           /** Trees are built from the whole ACL at once, inserted rules only query them. */
+
 /**
  * Class PrefixForest represents the forest of prefix tress.
+ *
+ * By default the rule is inserted into all prefix trees by the thread calling addAclRule().
+ * In the pipelined mode (see startPipelinedInsertion()) every prefix tree is updated by its own
+ * thread, which inserts rules of the ACL ahead of the calling thread and stores conflict vectors
+ * of single dimensions into a bounded buffer. The calling thread then only does the AND
+ * of already computed vectors, while trees are already updated with following rules.
+ * In the bulk mode (see bulkLoad()) structures of dimensions are built from all rules of the ACL
+ * before the first rule is added and adding of the rule only computes its conflict vectors.
+ * Conflict vectors of all dimensions are combined by one k-way AND (BitVector::andMany()),
+ * or conflicting rules are iterated directly from them (getConflictsIterator()).
+ *
+ * Every dimension is served by the structure implementing DimensionIndex, which is selected by
+ * the constant INDEX_XXX passed in constructor (binary PrefixTree-s, path-compressed PatriciaTree-s,
+ * multibit MultibitTree-s for IP addresses, or direct-indexed ProtocolTable and PortIntervalTable-s).
+ *
+ * The forest owns one MemoryArena for every dimension, which provides memory of the structure of
+ * the dimension (nodes and bit vector objects), so building and discarding the forest of one ACL
+ * takes only a few large allocations. Words of bit vectors are still allocated on the heap.
+ *
+ * The forest is parametrized by the class of bit vectors used by its prefix trees (WAHBitVector,
+ * PlainBitVector or RoaringBitVector). Instances for all classes are compiled in PrefixForest.cpp.
  */
+template < class BitVector >
 class PrefixForest
 {
     private:
+        /**
+         * Structure representing the thread updating one prefix tree in the pipelined mode.
+         */
+        struct DimensionPipeline
+        {
+            PrefixForest* m_forest;                 /** Pointer to the forest owning the pipeline. */
+            int m_dimension;                        /** Dimension (and index of the tree) updated by the thread. */
+            pthread_t m_thread;                     /** Thread updating the tree. */
+            std::vector< BitVector* > m_slots;      /** Bounded buffer of conflict vectors (allocated once and reused). */
+            size_t m_produced;                      /** Number of rules inserted into the tree. */
+            size_t m_taken;                         /** Number of conflict vectors taken from the buffer. */
+            size_t m_consumed;                      /** Number of slots handed back to the thread (taken vectors no longer used). */
+            size_t m_failedRule;                    /** Position of the rule whose insertion failed, ACL size if there is none. */
+            std::string m_error;                    /** Error message, if the insertion failed. */
+        };
+
         const u_int32_t m_numOfAclRules;                /** Value representing the number of rules in ACL. */
         const int m_numOfRuleDimensions;                /** Value representing the number of dimensions of rules. */
-        boost::ptr_vector< PrefixTree > m_triesVector;  /** Smart container (vector) containing objects of PrefixTree-s. */
+        const int m_indexType;                          /** Structure used for dimensions (constant INDEX_XXX). */
+        boost::ptr_vector< MemoryArena > m_arenas;      /** Arenas providing memory of structures of dimensions (one per dimension, destroyed after them). */
+        boost::ptr_vector< DimensionIndex< BitVector > > m_triesVector;    /** Smart container (vector) containing structures of dimensions. */
+        boost::ptr_vector< BitVector > m_dimensionVectors;              /** Reused conflict vectors of single dimensions. */
+        std::vector< const BitVector* > m_andOperands;                  /** Pointers to conflict vectors of single dimensions of the last inserted rule. */
+
+        int m_insertionMode;                            /** Mode of inserting rules (constant INSERTION_XXX). */
+        const AccessControlList* m_pipelinedAcl;        /** Pointer to the ACL inserted in the pipelined mode. */
+        std::vector< DimensionPipeline > m_pipelines;   /** Threads updating prefix trees in the pipelined mode. */
+        size_t m_numOfStartedPipelines;                 /** Number of successfully started threads. */
+        bool m_stopPipelines;                           /** Flag set if threads should stop. */
+        pthread_mutex_t m_pipelineLock;                 /** Mutex protecting buffers of all pipelines. */
+        pthread_cond_t m_pipelineProduced;              /** Condition signalled when some conflict vector is computed. */
+        pthread_cond_t m_pipelineConsumed;              /** Condition signalled when some conflict vector is taken. */
+
+        static const size_t PIPELINE_DEPTH = 32;        /** Number of slots of every thread (slot of the last taken rule is kept until the next rule). */
+
+    protected:
+        void createIndices(const AccessControlList* acl);
+        void pipelineLoop(DimensionPipeline& pipeline);
+        void stopPipelinedInsertion();
+        static void* pipelineMain(void* args);
+        static DimensionIndex< BitVector >* createIndex(int indexType, int dimension, u_int32_t aclSize, const AccessControlList* acl, MemoryArena* arena);
 
     public:
-        PrefixForest(u_int32_t aclSize, int numOfDimensions = (DIMENSION_MAX + 1));
+        PrefixForest(u_int32_t aclSize, int indexType = INDEX_BINARY_TRIE, int numOfDimensions = (DIMENSION_MAX + 1));
+        PrefixForest(const AccessControlList& acl, int indexType = INDEX_BINARY_TRIE);
         virtual ~PrefixForest();
 
-        std::auto_ptr< WAHBitVector > addAclRule(const AclRule& rule);
+        void startPipelinedInsertion(const AccessControlList& acl) throw(Exception);
+        void bulkLoad(const AccessControlList& acl) throw(Exception);
+        int insertionMode() const;
+        int indexType() const;
+        size_t numOfNodes() const;
+
+        std::auto_ptr< BitVector > addAclRule(const AclRule& rule) throw(Exception);
+        void addAclRule(const AclRule& rule, BitVector& conflictsVector) throw(Exception);
+        void insertAclRule(const AclRule& rule) throw(Exception);
+        typename BitVector::AndIterator getConflictsIterator(u_int32_t stopIndex) throw(Exception);
 };
 
 #endif /* PREFIX_FOREST_H__651351754168484351169411344616164137418631356816168454 */
\ No newline at end of file
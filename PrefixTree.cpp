@@ -17,6 +17,8 @@
  */
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
 
 #include "PrefixTree.hpp"
 #include "GlobalDefs.hpp"
@@ -26,7 +28,8 @@ using namespace std;
 /**
  * Class constructor.
  */
-PrefixTree::TreeNode::TreeNode() : m_parent(NULL), m_0_Lchild(NULL), m_1_Rchild(NULL), m_isValidPrefixNode(false) { }
+template < class BitVector >
+PrefixTree< BitVector >::TreeNode::TreeNode() : m_parent(NULL), m_0_Lchild(NULL), m_1_Rchild(NULL), m_bitVector1(NULL), m_bitVector2(NULL), m_validDescendants(NULL), m_isValidPrefixNode(false) { }
 
 //-----------------------------------------------------------------------------------
 
@@ -35,14 +38,39 @@ PrefixTree::TreeNode::TreeNode() : m_parent(NULL), m_0_Lchild(NULL), m_1_Rchild(
  *
  * @param parent pointer to node which is parent of this new node in trie.
  */
-PrefixTree::TreeNode::TreeNode(PrefixTree::TreeNode* parent) : m_parent(parent), m_0_Lchild(NULL), m_1_Rchild(NULL), m_isValidPrefixNode(false) { }
+template < class BitVector >
+PrefixTree< BitVector >::TreeNode::TreeNode(typename PrefixTree< BitVector >::TreeNode* parent) : m_parent(parent), m_0_Lchild(NULL), m_1_Rchild(NULL), m_bitVector1(NULL), m_bitVector2(NULL), m_validDescendants(NULL), m_isValidPrefixNode(false) { }
 
 //-----------------------------------------------------------------------------------
 
 /**
  * Class destructor.
  */
-PrefixTree::TreeNode::~TreeNode() { }
+template < class BitVector >
+PrefixTree< BitVector >::TreeNode::~TreeNode() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator compares prefixes by their bits, then by their length and then by positions of rules.
+ *
+ * Sorted prefix always follows all its shorter prefixes and prefixes of one node are
+ * sorted by positions of their rules.
+ *
+ * @param other reference to the compared prefix.
+ * @return true if this prefix precedes the other prefix.
+ */
+template < class BitVector >
+bool PrefixTree< BitVector >::LoadedPrefix::operator<(const typename PrefixTree< BitVector >::LoadedPrefix& other) const
+{
+    if ( m_prefixBits != other.m_prefixBits )
+        return m_prefixBits < other.m_prefixBits;
+
+    if ( m_prefixLength != other.m_prefixLength )
+        return m_prefixLength < other.m_prefixLength;
+
+    return m_position < other.m_position;
+}
 
 
 /*************************************************************/
@@ -52,18 +80,25 @@ PrefixTree::TreeNode::~TreeNode() { }
  * Class constructor.
  *
  * @param aclSize number of rules in ACL for which is this prefix tree used.
+ * @param dimension dimension of rules added by addNewRule() (constant DIMENSION_XXX).
+ * @param arena pointer to the arena providing memory of nodes, bit vectors and sets of descendants, NULL if the memory is taken from the heap.
+ *              The arena has to exist until the tree is destroyed.
  */
-PrefixTree::PrefixTree(u_int32_t aclSize) : m_rootNode(new TreeNode()), m_numOfAclRules(aclSize)
-{
-    m_allTreeNodes.push_back(m_rootNode);
-}
+template < class BitVector >
+PrefixTree< BitVector >::PrefixTree(u_int32_t aclSize, int dimension, MemoryArena* arena) : m_arena(arena), m_nodePool(arena), m_vectorPool(arena),
+                                                                        m_descendantsPool(arena), m_rootNode(m_nodePool.construct()), m_numOfAclRules(aclSize),
+                                                                        m_dimension(dimension), m_numOfNodes(1), m_isBulkLoaded(false)
+{}
 
 //-----------------------------------------------------------------------------------
 
 /**
  * Class destructor.
+ *
+ * Nodes, bit vectors and sets of nearest valid descendants are destructed by their pools.
  */
-PrefixTree::~PrefixTree() { }
+template < class BitVector >
+PrefixTree< BitVector >::~PrefixTree() { }
 
 //-----------------------------------------------------------------------------------
 
@@ -75,7 +110,8 @@ PrefixTree::~PrefixTree() { }
  * @param parent pointer to parent node.
  * @return pointer to newly created node.
  */
-PrefixTree::TreeNode* PrefixTree::allocateNewNode(PrefixTree::TreeNode* const parent)
+template < class BitVector >
+typename PrefixTree< BitVector >::TreeNode* PrefixTree< BitVector >::allocateNewNode(typename PrefixTree< BitVector >::TreeNode* const parent)
 {
     /* kontrola parametrov */
     if ( parent == NULL )
@@ -89,39 +125,88 @@ PrefixTree::TreeNode* PrefixTree::allocateNewNode(PrefixTree::TreeNode* const pa
         exit(1);
     }
 
-    TreeNode* newNode = new TreeNode(parent);
-    m_allTreeNodes.push_back(newNode);
+    ++m_numOfNodes;
+    return m_nodePool.construct(parent);
+}
+
+//-----------------------------------------------------------------------------------
 
-    return newNode;
+/**
+ * Method allocates new empty set of nearest valid descendants whose elements are allocated from the arena of the tree.
+ *
+ * @return pointer to the new set (owned by the pool of sets).
+ */
+template < class BitVector >
+typename PrefixTree< BitVector >::DescendantSet* PrefixTree< BitVector >::allocateDescendants()
+{
+    return m_descendantsPool.construct(std::less< ValidDescendant >(), typename DescendantSet::allocator_type(m_arena));
 }
 
 //-----------------------------------------------------------------------------------
 
 /**
- * Method recursively computes BitVector2 for subtree with passed root node.
+ * Method links the node which becomes valid with its nearest valid ancestor and computes its BitVector2.
+ *
+ * Nearest valid descendants of the ancestor are disjoint prefixes ordered by their bits, so those
+ * below the new valid node form one continuous range. The range is moved to the set of the new node
+ * and replaced by the node itself, and BitVector2-s of the range are added to BitVector2 of the node.
+ * The time depends on the number of nearest valid descendants of the node, not on its subtree.
  *
- * @param node pointer to tree node used as root for the subtree for which the BitVector2 is computed.
- * @param vector reference to the object WAHBitVector where computed BitVector2 will be stored.
+ * @param node pointer to the node which becomes valid (its BitVector2 has to be allocated).
+ * @param prefix reference to the prefix of the node.
+ * @param ancestor pointer to the nearest valid ancestor of the node (or the root), the node itself if it is the root.
  */
-void PrefixTree::getBitVector2forSubTree(PrefixTree::TreeNode* const node, WAHBitVector& vector)
+template < class BitVector >
+void PrefixTree< BitVector >::linkValidNode(typename PrefixTree< BitVector >::TreeNode* const node, const FIELD_PREFIX& prefix,
+                                            typename PrefixTree< BitVector >::TreeNode* const ancestor)
 {
-    /* parameters's check */
-    if ( node == NULL )
-        return;
+    typedef typename DescendantSet::iterator DescendantIterator;
 
-    /* if the current node is valid, we do OR and return */
-    if ( node->m_isValidPrefixNode )
+    /* the root keeps the set of its nearest valid descendants even if it is not valid */
+    if ( node == ancestor )
     {
-        vector |= *(node->m_bitVector2);
+        if ( node->m_validDescendants != NULL )
+            for ( DescendantIterator it = node->m_validDescendants->begin(); it != node->m_validDescendants->end(); ++it )
+                *(node->m_bitVector2) |= *(it->m_node->m_bitVector2);
 
         return;
     }
 
-    /* continue with left subtree */
-    getBitVector2forSubTree(node->m_0_Lchild, vector);
+    if ( ancestor->m_validDescendants == NULL )
+        ancestor->m_validDescendants = allocateDescendants();
+
+    DescendantSet& siblings = *(ancestor->m_validDescendants);
+
+    ValidDescendant descendant;
+    descendant.m_prefixBits = prefix.bits;
+    descendant.m_node = node;
+
+    /* new leaf node can not have any valid descendant */
+    if ( node->m_0_Lchild == NULL && node->m_1_Rchild == NULL )
+    {
+        siblings.insert(descendant);
+        return;
+    }
+
+    u_int32_t lastBits = prefix.bits | ~(0xFFFFFFFF << (32 - prefix.length));
+
+    DescendantIterator first = siblings.lower_bound(descendant);
+    DescendantIterator last = first;
 
-    /* continue with right subtree */
-    getBitVector2forSubTree(node->m_1_Rchild, vector);
+    while ( last != siblings.end() && last->m_prefixBits <= lastBits )
+    {
+        *(node->m_bitVector2) |= *(last->m_node->m_bitVector2);
+        ++last;
+    }
+
+    if ( first != last )
+    {
+        node->m_validDescendants = allocateDescendants();
+        node->m_validDescendants->insert(first, last);
+        siblings.erase(first, last);
+    }
+
+    siblings.insert(last, descendant);
 }
 
 //-----------------------------------------------------------------------------------
@@ -129,17 +214,43 @@ void PrefixTree::getBitVector2forSubTree(PrefixTree::TreeNode* const node, WAHBi
 /**
  * Method adds new rule to the tree according to its prefix.
  *
- * @param prefix reference to bit vector containing prefix which will be added.
+ * @param prefix reference to structure containing prefix which will be added.
  * @param rulePositionNum position of the rule in ACL.
- * @return smart pointer with pointer to the object WAHBitVector containing conflict bit vector for new rule.
+ * @return smart pointer with pointer to the bit vector containing conflict bit vector for new rule.
  */
-std::auto_ptr< WAHBitVector > PrefixTree::addNewRulePrefix(const boost::dynamic_bitset< >& prefix, int rulePositionNum)
+template < class BitVector >
+std::auto_ptr< BitVector > PrefixTree< BitVector >::addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum)
+{
+    auto_ptr< BitVector > conflictVector(new BitVector(m_numOfAclRules));
+
+    addNewRulePrefix(prefix, rulePositionNum, *conflictVector);
+
+    return conflictVector;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to its prefix.
+ *
+ * Conflict bit vector is stored to the passed vector, so the caller can reuse
+ * one vector (and its memory) for all added rules.
+ *
+ * @param prefix reference to structure containing prefix which will be added.
+ * @param rulePositionNum position of the rule in ACL.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void PrefixTree< BitVector >::addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum, BitVector& conflictVector)
 {
     /* conflict vector for newly added rule */
-    auto_ptr< WAHBitVector > conflictVector(new WAHBitVector(m_numOfAclRules));
+    conflictVector.reset(false);
 
     TreeNode* curentNode = m_rootNode;
-    unsigned prefixSize = prefix.size();
+    TreeNode* validAncestor = m_rootNode;
+    unsigned prefixSize = prefix.length;
+    u_int32_t prefixBits = prefix.bits;
 
     /* traversing the tree according to the prefix */
     for ( unsigned i = 0; i < prefixSize; ++i )
@@ -148,12 +259,13 @@ std::auto_ptr< WAHBitVector > PrefixTree::addNewRulePrefix(const boost::dynamic_
         if ( curentNode->m_isValidPrefixNode )
         {
             curentNode->m_bitVector2->set(rulePositionNum);
-            *conflictVector |= *(curentNode->m_bitVector1);
+            conflictVector |= *(curentNode->m_bitVector1);
+            validAncestor = curentNode;
         }
 
         /* shift to next node in tree */
         /* if there is value "1" at the current position of the prefix -> shift to right child */
-        if ( prefix[i] )
+        if ( prefixBits & (0x80000000 >> i) )
         {
             /* if there is no right child */
             if ( curentNode->m_1_Rchild == NULL )
@@ -196,18 +308,274 @@ std::auto_ptr< WAHBitVector > PrefixTree::addNewRulePrefix(const boost::dynamic_
     else
     {
         /* create bit vectors */
-        curentNode->m_bitVector1 = auto_ptr< WAHBitVector > (new WAHBitVector(m_numOfAclRules));
-        curentNode->m_bitVector2 = auto_ptr< WAHBitVector > (new WAHBitVector(m_numOfAclRules));
+        curentNode->m_bitVector1 = m_vectorPool.construct(m_numOfAclRules);
+        curentNode->m_bitVector2 = m_vectorPool.construct(m_numOfAclRules);
 
         curentNode->m_bitVector1->set(rulePositionNum);
         curentNode->m_bitVector2->set(rulePositionNum);
 
-        getBitVector2forSubTree(curentNode, *(curentNode->m_bitVector2));
+        linkValidNode(curentNode, prefix, validAncestor);
 
         curentNode->m_isValidPrefixNode = true;
     }
 
-    *conflictVector |= *(curentNode->m_bitVector2);
-    
-    return conflictVector;
-}
\ No newline at end of file
+    conflictVector |= *(curentNode->m_bitVector2);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method builds the tree from all rules of the ACL at once.
+ *
+ * Prefixes of all rules are sorted, so the path of every prefix is created only from the node where
+ * it diverges from the path of the previous prefix, and bits of BitVector1 of every node are set
+ * in the increasing order of positions (compressed vectors are only appended). BitVector2-s are
+ * computed afterwards by one post-order sweep (see sweepBitVector2()) and then replaced by conflict
+ * vectors of their prefixes (see sweepConflictVectors()). Sets of nearest valid descendants
+ * are not built, as no node becomes valid after the load.
+ *
+ * @param acl reference to the ACL whose rules are loaded.
+ * @return true if the tree was built, false if some rule was already added to the tree.
+ */
+template < class BitVector >
+bool PrefixTree< BitVector >::bulkLoad(const AccessControlList& acl)
+{
+    if ( m_isBulkLoaded || m_rootNode->m_isValidPrefixNode || m_rootNode->m_0_Lchild != NULL || m_rootNode->m_1_Rchild != NULL )
+        return false;
+
+    /* sort prefixes of all rules */
+    vector< LoadedPrefix > prefixes(acl.size());
+
+    for ( size_t j = 0; j < acl.size(); ++j )
+    {
+        FIELD_PREFIX prefix = acl[j].getFieldPrefix(m_dimension);
+
+        prefixes[j].m_prefixBits = prefix.bits;
+        prefixes[j].m_prefixLength = prefix.length;
+        prefixes[j].m_position = acl[j].getPosition();
+    }
+
+    sort(prefixes.begin(), prefixes.end());
+
+    /* path of the previous prefix, path[i] is the node in depth i */
+    TreeNode* path[33];
+    u_int32_t pathBits = 0;
+    u_int32_t pathLength = 0;
+
+    path[0] = m_rootNode;
+
+    for ( size_t j = 0; j < prefixes.size(); ++j )
+    {
+        const LoadedPrefix& prefix = prefixes[j];
+
+        /* continue from the last common node of both paths */
+        u_int32_t depth = (pathLength < prefix.m_prefixLength) ? pathLength : prefix.m_prefixLength;
+        u_int32_t differentBits = pathBits ^ prefix.m_prefixBits;
+
+        if ( (differentBits != 0) && (u_int32_t(__builtin_clz(differentBits)) < depth) )
+            depth = __builtin_clz(differentBits);
+
+        for ( ; depth < prefix.m_prefixLength; ++depth )
+        {
+            TreeNode* node = path[depth];
+
+            if ( prefix.m_prefixBits & (0x80000000 >> depth) )
+            {
+                if ( node->m_1_Rchild == NULL )
+                    node->m_1_Rchild = allocateNewNode(node);
+
+                path[depth + 1] = node->m_1_Rchild;
+            }
+            else
+            {
+                if ( node->m_0_Lchild == NULL )
+                    node->m_0_Lchild = allocateNewNode(node);
+
+                path[depth + 1] = node->m_0_Lchild;
+            }
+        }
+
+        pathBits = prefix.m_prefixBits;
+        pathLength = prefix.m_prefixLength;
+
+        TreeNode* node = path[pathLength];
+
+        if ( !node->m_isValidPrefixNode )
+        {
+            node->m_bitVector1 = m_vectorPool.construct(m_numOfAclRules);
+            node->m_isValidPrefixNode = true;
+        }
+
+        node->m_bitVector1->set(prefix.m_position);
+    }
+
+    sweepBitVector2(m_rootNode, NULL);
+
+    boost::ptr_vector< BitVector > levelVectors;
+    sweepConflictVectors(m_rootNode, NULL, levelVectors, 0);
+
+    m_isBulkLoaded = true;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method computes BitVector2-s of all valid nodes of the subtree by the post-order sweep.
+ *
+ * BitVector2 of the valid node is its BitVector1 with BitVector2-s of its nearest valid descendants,
+ * so every BitVector2 is added only to BitVector2 of its nearest valid ancestor.
+ *
+ * @param node pointer to the root of the subtree.
+ * @param ancestorVector pointer to BitVector2 of the nearest valid ancestor, NULL if there is none.
+ */
+template < class BitVector >
+void PrefixTree< BitVector >::sweepBitVector2(typename PrefixTree< BitVector >::TreeNode* const node, BitVector* const ancestorVector)
+{
+    if ( node == NULL )
+        return;
+
+    BitVector* vector = ancestorVector;
+
+    if ( node->m_isValidPrefixNode )
+    {
+        node->m_bitVector2 = m_vectorPool.construct(m_numOfAclRules);
+        *(node->m_bitVector2) |= *(node->m_bitVector1);
+        vector = node->m_bitVector2;
+    }
+
+    sweepBitVector2(node->m_0_Lchild, vector);
+    sweepBitVector2(node->m_1_Rchild, vector);
+
+    if ( node->m_isValidPrefixNode && (ancestorVector != NULL) )
+        *ancestorVector |= *(node->m_bitVector2);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method replaces BitVector2-s of all valid nodes of the subtree by conflict vectors of their prefixes.
+ *
+ * Conflict vector of the prefix is the OR of BitVector1-s of its valid ancestors and its BitVector2
+ * (see addNewRulePrefix()). The OR of BitVector1-s of valid ancestors is kept for every number
+ * of valid ancestors in the vector levelVectors, so it is computed once for every valid node.
+ *
+ * @param node pointer to the root of the subtree.
+ * @param ancestorsVector pointer to the OR of BitVector1-s of valid ancestors, NULL if there is none.
+ * @param levelVectors reference to the vector of ORs of BitVector1-s of valid ancestors.
+ * @param level number of valid ancestors of the node.
+ */
+template < class BitVector >
+void PrefixTree< BitVector >::sweepConflictVectors(typename PrefixTree< BitVector >::TreeNode* const node, const BitVector* const ancestorsVector,
+                                                   boost::ptr_vector< BitVector >& levelVectors, size_t level)
+{
+    if ( node == NULL )
+        return;
+
+    const BitVector* vector = ancestorsVector;
+
+    if ( node->m_isValidPrefixNode )
+    {
+        if ( ancestorsVector != NULL )
+            *(node->m_bitVector2) |= *ancestorsVector;
+
+        /* valid leaf node has no descendant */
+        if ( node->m_0_Lchild == NULL && node->m_1_Rchild == NULL )
+            return;
+
+        if ( level == levelVectors.size() )
+            levelVectors.push_back(new BitVector(m_numOfAclRules));
+
+        if ( ancestorsVector != NULL )
+            BitVector::orInto(levelVectors[level], *ancestorsVector, *(node->m_bitVector1));
+        else
+        {
+            levelVectors[level].reset(false);
+            levelVectors[level] |= *(node->m_bitVector1);
+        }
+
+        vector = &levelVectors[level];
+        ++level;
+    }
+
+    sweepConflictVectors(node->m_0_Lchild, vector, levelVectors, level);
+    sweepConflictVectors(node->m_1_Rchild, vector, levelVectors, level);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the conflict bit vector of the rule of the ACL loaded by bulkLoad().
+ *
+ * Vector contains all rules of the ACL whose prefixes conflict with the prefix of the rule,
+ * i.e. also rules following the rule.
+ *
+ * @param rule reference to the rule of the loaded ACL.
+ * @return pointer to the conflict vector owned by the tree, NULL if the tree was not built by bulkLoad().
+ */
+template < class BitVector >
+const BitVector* PrefixTree< BitVector >::getLoadedConflictVector(const AclRule& rule)
+{
+    if ( !m_isBulkLoaded )
+        return NULL;
+
+    FIELD_PREFIX prefix = rule.getFieldPrefix(m_dimension);
+    TreeNode* curentNode = m_rootNode;
+
+    for ( unsigned i = 0; (i < prefix.length) && (curentNode != NULL); ++i )
+        curentNode = (prefix.bits & (0x80000000 >> i)) ? curentNode->m_1_Rchild : curentNode->m_0_Lchild;
+
+    /* rule is not from the loaded ACL */
+    if ( curentNode == NULL || !curentNode->m_isValidPrefixNode )
+        return NULL;
+
+    return curentNode->m_bitVector2;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the tree according to the prefix of its dimension.
+ *
+ * If the tree was built by bulkLoad(), the rule is already in the tree and only
+ * its conflict bit vector is copied (see getLoadedConflictVector()).
+ *
+ * @param rule reference to the added rule.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void PrefixTree< BitVector >::addNewRule(const AclRule& rule, BitVector& conflictVector)
+{
+    if ( m_isBulkLoaded )
+    {
+        const BitVector* loadedVector = getLoadedConflictVector(rule);
+
+        conflictVector.reset(false);
+        if ( loadedVector != NULL )
+            conflictVector |= *loadedVector;
+    }
+    else
+        addNewRulePrefix(rule.getFieldPrefix(m_dimension), rule.getPosition(), conflictVector);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of nodes of the tree.
+ *
+ * @return number of allocated nodes including the root.
+ */
+template < class BitVector >
+size_t PrefixTree< BitVector >::numOfNodes() const
+{
+    return m_numOfNodes;
+}
+
+//-----------------------------------------------------------------------------------
+
+/* prefix trees with all supported bit vectors */
+template class PrefixTree< WAHBitVector >;
+template class PrefixTree< PlainBitVector >;
+template class PrefixTree< RoaringBitVector >;
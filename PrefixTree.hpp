@@ -17,20 +17,72 @@
  */
 
 #include <memory>
-#include <boost/dynamic_bitset.hpp>
+#include <set>
 #include <boost/ptr_container/ptr_vector.hpp>
 
+#include "AclRule.hpp"
+#include "DimensionIndex.hpp"
+#include "MemoryArena.hpp"
+#include "ObjectPool.hpp"
 #include "WAHBitVector.hpp"
+#include "PlainBitVector.hpp"
+#include "RoaringBitVector.hpp"
 
 #ifndef PREFIX_TREE_H_863418738481687421681315418613438413414341684416838
 #define PREFIX_TREE_H_863418738481687421681315418613438413414341684416838
 
 /**
  * Class PrefixTree represents the prefix tree for one dimension of ACL rule.
+ *
+ * The tree is parametrized by the class of bit vectors used in its nodes (WAHBitVector,
+ * PlainBitVector or RoaringBitVector). Instances for all classes are compiled in PrefixTree.cpp.
+ * Nodes, their bit vectors and sets of nearest valid descendants are allocated from MemoryArena
+ * passed in constructor (PrefixForest owns one arena for every tree), so building and destroying
+ * the tree takes only a few large allocations. Without the arena they are taken from the heap.
+ * Words of bit vectors are always allocated on the heap by the bit vectors themselves.
+ *
+ * Every bit of the prefix is represented by one node, the path-compressed variant
+ * of the tree is PatriciaTree. Every valid node (and the root) keeps the ordered set of its nearest
+ * valid descendants, so the node which becomes valid takes its own nearest valid descendants over
+ * from its nearest valid ancestor and computes BitVector2 from them, instead of visiting its subtree.
+ *
+ * The whole ACL can be loaded at once by bulkLoad(): prefixes are sorted, so the path of every
+ * prefix continues from the path of the previous one, bits of BitVector1-s are set only in
+ * the increasing order of rules (appended) and BitVector2-s are computed by one post-order sweep.
+ * Then BitVector2 of every valid node is replaced by the conflict vector of its prefix, so rules
+ * of the loaded ACL are looked up without any operation with bit vectors.
  */
-class PrefixTree
+template < class BitVector >
+class PrefixTree : public DimensionIndex< BitVector >
 {
     protected:
+        class TreeNode;
+
+        /**
+         * Structure representing the nearest valid descendant of the node.
+         */
+        struct ValidDescendant
+        {
+            u_int32_t m_prefixBits;     /** Bits of the prefix of the descendant aligned to the most significant bit. */
+            TreeNode* m_node;           /** Pointer to the valid descendant. */
+
+            bool operator<(const ValidDescendant& other) const { return m_prefixBits < other.m_prefixBits; }
+        };
+
+        typedef std::set< ValidDescendant, std::less< ValidDescendant >, ArenaAllocator< ValidDescendant > > DescendantSet;
+
+        /**
+         * Structure representing the prefix of one rule sorted by the bulk load.
+         */
+        struct LoadedPrefix
+        {
+            u_int32_t m_prefixBits;     /** Bits of the prefix aligned to the most significant bit. */
+            u_int32_t m_prefixLength;   /** Length of the prefix. */
+            u_int32_t m_position;       /** Position of the rule in ACL. */
+
+            bool operator<(const LoadedPrefix& other) const;
+        };
+
         /**
          * Class TreeNode represents the node of a prefix tree.
          */
@@ -41,8 +93,9 @@ class PrefixTree
                 TreeNode* m_0_Lchild;   /** Pointer to left child. */
                 TreeNode* m_1_Rchild;   /** Pointer to right child. */
 
-                std::auto_ptr< WAHBitVector > m_bitVector1;     /** Smart pointer containing BitVector1. */
-                std::auto_ptr< WAHBitVector > m_bitVector2;     /** Smart pointer containing BitVector2. */
+                BitVector* m_bitVector1;        /** Pointer to BitVector1 (owned by the pool of vectors of the tree). */
+                BitVector* m_bitVector2;        /** Pointer to BitVector2 (owned by the pool of vectors of the tree). */
+                DescendantSet* m_validDescendants;  /** Nearest valid descendants (valid nodes and the root), NULL if there is none. */
             
                 bool m_isValidPrefixNode;       /** Flag set if the node represents valid prefix. */
 
@@ -52,19 +105,34 @@ class PrefixTree
         };
 
     private:
+        MemoryArena* const m_arena;                     /** Arena providing memory of the tree, NULL if it is taken from the heap. */
+        ObjectPool< TreeNode > m_nodePool;              /** Pool of all nodes of the tree (the memory will be freed in destruction). */
+        ObjectPool< BitVector > m_vectorPool;           /** Pool of bit vectors of all nodes of the tree. */
+        ObjectPool< DescendantSet > m_descendantsPool;  /** Pool of sets of nearest valid descendants. */
         TreeNode* const m_rootNode;                     /** Constant pointer to the root of the prefix tree. */
         const u_int32_t m_numOfAclRules;                /** Number of the rules in ACL for which the tree is created. */
-        boost::ptr_vector< TreeNode > m_allTreeNodes;   /** Vector of pointers to all nodes of tree (the memory will be freed in destruction). */
+        const int m_dimension;                          /** Dimension of rules stored in the tree. */
+        size_t m_numOfNodes;                            /** Number of allocated nodes. */
+        bool m_isBulkLoaded;                            /** Flag set if the tree was built by bulkLoad(). */
 
     protected:
         TreeNode* allocateNewNode(TreeNode* const parent);
-        void getBitVector2forSubTree(TreeNode* const node, WAHBitVector& vector);
+        DescendantSet* allocateDescendants();
+        void linkValidNode(TreeNode* const node, const FIELD_PREFIX& prefix, TreeNode* const ancestor);
+        void sweepBitVector2(TreeNode* const node, BitVector* const ancestorVector);
+        void sweepConflictVectors(TreeNode* const node, const BitVector* const ancestorsVector, boost::ptr_vector< BitVector >& levelVectors, size_t level);
         
     public:
-        PrefixTree(u_int32_t aclSize);
+        PrefixTree(u_int32_t aclSize, int dimension = DIMENSION_MIN, MemoryArena* arena = NULL);
         virtual ~PrefixTree();
 
-        std::auto_ptr< WAHBitVector > addNewRulePrefix(const boost::dynamic_bitset< >& prefix, int rulePositionNum);
+        std::auto_ptr< BitVector > addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum);
+        void addNewRulePrefix(const FIELD_PREFIX& prefix, int rulePositionNum, BitVector& conflictVector);
+
+        virtual void addNewRule(const AclRule& rule, BitVector& conflictVector);
+        virtual bool bulkLoad(const AccessControlList& acl);
+        virtual const BitVector* getLoadedConflictVector(const AclRule& rule);
+        virtual size_t numOfNodes() const;
 };
 
 #endif /* PREFIX_TREE_H_863418738481687421681315418613438413414341684416838 */
\ No newline at end of file
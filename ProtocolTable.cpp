@@ -0,0 +1,107 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "ProtocolTable.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * @param aclSize number of rules in ACL for which is this table used.
+ * @param arena pointer to the arena providing blocks of the pool of bit vectors, NULL if they are taken from the heap.
+ *              The arena has to exist until the table is destroyed.
+ */
+template < class BitVector >
+ProtocolTable< BitVector >::ProtocolTable(u_int32_t aclSize, MemoryArena* arena) : m_vectorPool(arena), m_wildcardVector(aclSize), m_allRulesVector(aclSize),
+                                                               m_numOfAclRules(aclSize), m_numOfVectors(0)
+{
+    for ( int i = 0; i < NUM_OF_PROTOCOLS; ++i )
+        m_protocolVectors[i] = NULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ *
+ * Bit vectors of protocol numbers are destructed by their pool.
+ */
+template < class BitVector >
+ProtocolTable< BitVector >::~ProtocolTable() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method adds new rule to the table according to its protocol.
+ *
+ * Rule with a protocol number conflicts with rules of the same number and with wildcards,
+ * rule with PROTO_ANY or PROTO_IPv4 conflicts with all rules.
+ *
+ * @param rule reference to the added rule.
+ * @param conflictVector reference to the bit vector of the ACL size where the conflict
+ *                       bit vector for new rule is stored.
+ */
+template < class BitVector >
+void ProtocolTable< BitVector >::addNewRule(const AclRule& rule, BitVector& conflictVector)
+{
+    int protocol = rule.getProtocol();
+    unsigned rulePositionNum = rule.getPosition();
+
+    m_allRulesVector.set(rulePositionNum);
+    conflictVector.reset(false);
+
+    /* wildcard (or protocol out of the table) -> conflicts with all rules */
+    if ( protocol < 0 || protocol >= NUM_OF_PROTOCOLS )
+    {
+        m_wildcardVector.set(rulePositionNum);
+        conflictVector |= m_allRulesVector;
+
+        return;
+    }
+
+    if ( m_protocolVectors[protocol] == NULL )
+    {
+        m_protocolVectors[protocol] = m_vectorPool.construct(m_numOfAclRules);
+        ++m_numOfVectors;
+    }
+
+    m_protocolVectors[protocol]->set(rulePositionNum);
+
+    BitVector::orInto(conflictVector, *(m_protocolVectors[protocol]), m_wildcardVector);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the number of entries of the table.
+ *
+ * @return number of allocated vectors of protocol numbers and the vector of wildcards.
+ */
+template < class BitVector >
+size_t ProtocolTable< BitVector >::numOfNodes() const
+{
+    return m_numOfVectors + 1;
+}
+
+//-----------------------------------------------------------------------------------
+
+/* protocol tables with all supported bit vectors */
+template class ProtocolTable< WAHBitVector >;
+template class ProtocolTable< PlainBitVector >;
+template class ProtocolTable< RoaringBitVector >;
@@ -0,0 +1,63 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "AclRule.hpp"
+#include "DimensionIndex.hpp"
+#include "MemoryArena.hpp"
+#include "ObjectPool.hpp"
+#include "WAHBitVector.hpp"
+#include "PlainBitVector.hpp"
+#include "RoaringBitVector.hpp"
+
+#ifndef PROTOCOL_TABLE_H__2750193846571029384756102938475610293847561029384756
+#define PROTOCOL_TABLE_H__2750193846571029384756102938475610293847561029384756
+
+/**
+ * Class ProtocolTable represents the direct-indexed table for the protocol dimension of ACL rule.
+ *
+ * Protocols of rules are either single protocol numbers, or PROTO_ANY and PROTO_IPv4, which
+ * overlap with every protocol (see Conflict::compareProtocol()). The table has one bit vector
+ * for every protocol number with rules of that protocol and one vector with rules of both
+ * wildcards. The conflict bit vector of the rule is then found by one table lookup instead
+ * of the walk through the prefix tree of protocol codes.
+ *
+ * The table is parametrized by the class of bit vectors (WAHBitVector, PlainBitVector
+ * or RoaringBitVector). Instances for all classes are compiled in ProtocolTable.cpp.
+ */
+template < class BitVector >
+class ProtocolTable : public DimensionIndex< BitVector >
+{
+    private:
+        static const int NUM_OF_PROTOCOLS = PROTO__MAX + 1;    /** Number of protocol numbers (size of the table). */
+
+        ObjectPool< BitVector > m_vectorPool;           /** Pool of bit vectors of protocol numbers. */
+        BitVector* m_protocolVectors[NUM_OF_PROTOCOLS]; /** Rules with the protocol number, NULL if there is no such rule. */
+        BitVector m_wildcardVector;                     /** Rules with PROTO_ANY or PROTO_IPv4. */
+        BitVector m_allRulesVector;                     /** All added rules. */
+        const u_int32_t m_numOfAclRules;                /** Number of the rules in ACL for which the table is created. */
+        size_t m_numOfVectors;                          /** Number of allocated vectors of protocol numbers. */
+
+    public:
+        ProtocolTable(u_int32_t aclSize, MemoryArena* arena = NULL);
+        virtual ~ProtocolTable();
+
+        virtual void addNewRule(const AclRule& rule, BitVector& conflictVector);
+        virtual size_t numOfNodes() const;
+};
+
+#endif /* PROTOCOL_TABLE_H__2750193846571029384756102938475610293847561029384756 */
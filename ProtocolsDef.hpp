@@ -18,6 +18,8 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include "KeywordTable.hpp"
+
 #ifndef PROTOCOLS_DEF_HPP__5442511154211631315451313584615878641643808484068164
 #define PROTOCOLS_DEF_HPP__5442511154211631315451313584615878641643808484068164
 
@@ -905,4 +907,29 @@ const boost::dynamic_bitset< > PROTO_UNKNOWN_PREFIX(10, 0x000003FD);    /* prefi
 const int PROTO__MIN = PROTO_ANY;
 const int PROTO__MAX = 255;
 
+//--------------------------------------------------------------------------------
+
+/**
+ * Names of protocols recognized by input parsers (see KeywordTable).
+ */
+const KEYWORD PROTO_KEYWORDS[] =
+{
+    { "ip", PROTO_IPv4 },
+    { "icmp", PROTO_ICMPv4 },
+    { "igmp", PROTO_IGMP },
+    { "ipinip", PROTO_IP_IN_IP },
+    { "nos", PROTO_IP_IN_IP },              /* old name of protocol number 4 */
+    { "tcp", PROTO_TCP },
+    { "udp", PROTO_UDP },
+    { "gre", PROTO_GRE },
+    { "esp", PROTO_ESP },
+    { "ahp", PROTO_AH },
+    { "eigrp", PROTO_EIGRP },
+    { "ospf", PROTO_OSPF },
+    { "pim", PROTO_PIM },
+    { "pcp", PROTO_IP_COMP }
+};
+
+const size_t PROTO_KEYWORDS_COUNT = sizeof(PROTO_KEYWORDS) / sizeof(PROTO_KEYWORDS[0]);    /** Number of protocol names. */
+
 #endif /* PROTOCOLS_DEF_HPP__5442511154211631315451313584615878641643808484068164 */
\ No newline at end of file
@@ -0,0 +1,1350 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <utility>
+
+#include "RoaringBitVector.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * New vector with passed size is created. The size is fixed after construction.
+ *
+ * @param size size of created vector in bits.
+ * @param fillBit initial value for all bits of newly created vector.
+ */
+RoaringBitVector::RoaringBitVector(const u_int32_t size, bool fillBit) : m_sizeInBits(size)
+{
+    reset(fillBit);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method sets all bits of the vector to passed value.
+ *
+ * @param fillBit new value for all bits of the vector.
+ */
+void RoaringBitVector::reset(bool fillBit)
+{
+    m_containers.clear();
+
+    if ( !fillBit )
+        return;
+
+    for ( u_int32_t key = 0; (key * CHUNK_BITS) < m_sizeInBits; ++key )
+    {
+        u_int32_t chunkSize = ((m_sizeInBits - (key * CHUNK_BITS)) < CHUNK_BITS) ? (m_sizeInBits - (key * CHUNK_BITS)) : CHUNK_BITS;
+
+        m_containers.push_back(Container());
+        m_containers.back().m_key = key;
+        m_containers.back().m_type = CONTAINER_RUN;
+        m_containers.back().m_cardinality = chunkSize;
+        m_containers.back().m_values.push_back(0);
+        m_containers.back().m_values.push_back(chunkSize - 1);
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method finds the container with passed key.
+ *
+ * @param key index of the chunk.
+ * @return pointer to the container, or NULL if the chunk is empty.
+ */
+RoaringBitVector::Container* RoaringBitVector::findContainer(u_int32_t key)
+{
+    for ( size_t i = 0; i < m_containers.size(); ++i )
+    {
+        if ( m_containers[i].m_key == key )
+            return &m_containers[i];
+        if ( m_containers[i].m_key > key )
+            break;
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method checks if the passed bit is set in the container.
+ *
+ * @param cont reference to the container.
+ * @param value index of the bit within the chunk.
+ * @return TRUE - if the bit is set.
+ *         FALSE - otherwise.
+ */
+bool RoaringBitVector::contains(const RoaringBitVector::Container& cont, u_int16_t value)
+{
+    switch ( cont.m_type )
+    {
+        case CONTAINER_ARRAY:
+            return binary_search(cont.m_values.begin(), cont.m_values.end(), value);
+
+        case CONTAINER_BITMAP:
+            return ( (cont.m_bitmap[value / 64] >> (value % 64)) & 1 ) != 0;
+
+        default:
+        {
+            /* binary search of the last run starting before or at the value */
+            size_t low = 0;
+            size_t high = cont.m_values.size() / 2;
+
+            while ( low < high )
+            {
+                size_t middle = (low + high) / 2;
+
+                if ( cont.m_values[2 * middle] <= value )
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+
+            return ( (low > 0) && (value <= (cont.m_values[2 * (low - 1)] + cont.m_values[(2 * (low - 1)) + 1])) );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method sets the bit in the container.
+ *
+ * @param cont reference to the container.
+ * @param value index of the bit within the chunk.
+ */
+void RoaringBitVector::setInContainer(RoaringBitVector::Container& cont, u_int16_t value)
+{
+    switch ( cont.m_type )
+    {
+        case CONTAINER_ARRAY:
+        {
+            vector< u_int16_t >::iterator it = lower_bound(cont.m_values.begin(), cont.m_values.end(), value);
+
+            if ( (it != cont.m_values.end()) && (*it == value) )
+                return;
+
+            cont.m_values.insert(it, value);
+            ++cont.m_cardinality;
+
+            if ( cont.m_cardinality > ARRAY_MAX_SIZE )
+                optimize(cont);
+
+            return;
+        }
+
+        case CONTAINER_BITMAP:
+        {
+            u_int64_t mask = ((u_int64_t) 1) << (value % 64);
+
+            if ( (cont.m_bitmap[value / 64] & mask) == 0 )
+            {
+                cont.m_bitmap[value / 64] |= mask;
+                ++cont.m_cardinality;
+            }
+
+            return;
+        }
+
+        default:
+        {
+            if ( contains(cont, value) )
+                return;
+
+            /* find the first run starting after the value */
+            size_t next = 0;
+            while ( (next < cont.m_values.size()) && (cont.m_values[next] < value) )
+                next += 2;
+
+            bool joinsPrevious = (next > 0) && ((cont.m_values[next - 2] + cont.m_values[next - 1] + 1) == value);
+            bool joinsNext = (next < cont.m_values.size()) && ((value + 1) == cont.m_values[next]);
+
+            if ( joinsPrevious && joinsNext )
+            {
+                cont.m_values[next - 1] += cont.m_values[next + 1] + 2;
+                cont.m_values.erase(cont.m_values.begin() + next, cont.m_values.begin() + next + 2);
+            }
+            else if ( joinsPrevious )
+                ++cont.m_values[next - 1];
+            else if ( joinsNext )
+            {
+                --cont.m_values[next];
+                ++cont.m_values[next + 1];
+            }
+            else
+            {
+                u_int16_t run[2] = { value, 0 };
+                cont.m_values.insert(cont.m_values.begin() + next, run, run + 2);
+            }
+
+            ++cont.m_cardinality;
+
+            if ( (cont.m_values.size() / 2) > (ARRAY_MAX_SIZE / 2) )
+                optimize(cont);
+
+            return;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores set bits of the container as bitmap.
+ *
+ * @param cont reference to the container.
+ * @param words reference to the vector where BITMAP_WORDS words of the bitmap are stored.
+ */
+void RoaringBitVector::toBitmap(const RoaringBitVector::Container& cont, std::vector< u_int64_t >& words)
+{
+    if ( cont.m_type == CONTAINER_BITMAP )
+    {
+        words = cont.m_bitmap;
+        return;
+    }
+
+    words.assign(BITMAP_WORDS, 0);
+
+    if ( cont.m_type == CONTAINER_ARRAY )
+    {
+        for ( size_t i = 0; i < cont.m_values.size(); ++i )
+            words[cont.m_values[i] / 64] |= ((u_int64_t) 1) << (cont.m_values[i] % 64);
+
+        return;
+    }
+
+    for ( size_t i = 0; i < cont.m_values.size(); i += 2 )
+    {
+        u_int32_t start = cont.m_values[i];
+        u_int32_t end = start + cont.m_values[i + 1];      /* included */
+
+        for ( u_int32_t word = start / 64; word <= end / 64; ++word )
+        {
+            u_int64_t mask = ~((u_int64_t) 0);
+
+            if ( word == (start / 64) )
+                mask &= ~((u_int64_t) 0) << (start % 64);
+            if ( word == (end / 64) )
+                mask &= ~((u_int64_t) 0) >> (63 - (end % 64));
+
+            words[word] |= mask;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores set bits of the container as sorted runs.
+ *
+ * @param cont reference to the container.
+ * @param runs reference to the vector where pairs (start, length - 1) of runs are stored.
+ */
+void RoaringBitVector::toRuns(const RoaringBitVector::Container& cont, std::vector< u_int16_t >& runs)
+{
+    runs.clear();
+
+    if ( cont.m_type == CONTAINER_RUN )
+    {
+        runs = cont.m_values;
+        return;
+    }
+
+    if ( cont.m_type == CONTAINER_ARRAY )
+    {
+        for ( size_t i = 0; i < cont.m_values.size(); ++i )
+        {
+            if ( !runs.empty() && ((runs[runs.size() - 2] + runs.back() + 1) == cont.m_values[i]) )
+                ++runs.back();
+            else
+            {
+                runs.push_back(cont.m_values[i]);
+                runs.push_back(0);
+            }
+        }
+
+        return;
+    }
+
+    /* bitmap -> find runs of ones word by word */
+    bool inRun = false;
+
+    for ( u_int32_t word = 0; word < BITMAP_WORDS; ++word )
+    {
+        u_int64_t bits = cont.m_bitmap[word];
+        u_int32_t offset = 0;
+
+        while ( offset < 64 )
+        {
+            if ( inRun )
+            {
+                /* find the end of the run (first zero) */
+                u_int64_t zeroes = ~bits >> offset;
+                if ( zeroes == 0 )
+                {
+                    runs.back() += 64 - offset;
+                    break;
+                }
+
+                u_int32_t length = __builtin_ctzll(zeroes);
+                runs.back() += length;
+                offset += length;
+                inRun = false;
+            }
+            else
+            {
+                /* find the start of next run (first one) */
+                u_int64_t ones = bits >> offset;
+                if ( ones == 0 )
+                    break;
+
+                offset += __builtin_ctzll(ones);
+                runs.push_back((word * 64) + offset);
+                runs.push_back(0);
+                ++offset;
+                inRun = true;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores set bits of the container as sorted array.
+ *
+ * @param cont reference to the container.
+ * @param values reference to the vector where set bits are stored.
+ */
+void RoaringBitVector::toArray(const RoaringBitVector::Container& cont, std::vector< u_int16_t >& values)
+{
+    values.clear();
+
+    if ( cont.m_type == CONTAINER_ARRAY )
+    {
+        values = cont.m_values;
+        return;
+    }
+
+    values.reserve(cont.m_cardinality);
+
+    if ( cont.m_type == CONTAINER_RUN )
+    {
+        for ( size_t i = 0; i < cont.m_values.size(); i += 2 )
+        {
+            u_int32_t end = cont.m_values[i] + cont.m_values[i + 1];
+            for ( u_int32_t value = cont.m_values[i]; value <= end; ++value )
+                values.push_back(value);
+        }
+
+        return;
+    }
+
+    for ( u_int32_t word = 0; word < BITMAP_WORDS; ++word )
+    {
+        u_int64_t bits = cont.m_bitmap[word];
+
+        while ( bits != 0 )
+        {
+            values.push_back((word * 64) + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method counts runs of set bits in the container.
+ *
+ * @param cont reference to the container.
+ * @return number of runs.
+ */
+u_int32_t RoaringBitVector::numOfRuns(const RoaringBitVector::Container& cont)
+{
+    u_int32_t result = 0;
+
+    if ( cont.m_type == CONTAINER_RUN )
+        return cont.m_values.size() / 2;
+
+    if ( cont.m_type == CONTAINER_ARRAY )
+    {
+        for ( size_t i = 0; i < cont.m_values.size(); ++i )
+        {
+            if ( (i == 0) || (cont.m_values[i] != (cont.m_values[i - 1] + 1)) )
+                ++result;
+        }
+
+        return result;
+    }
+
+    /* run starts at every one preceded by zero */
+    u_int64_t carry = 0;
+    for ( u_int32_t word = 0; word < BITMAP_WORDS; ++word )
+    {
+        u_int64_t bits = cont.m_bitmap[word];
+        result += __builtin_popcountll(bits & ~((bits << 1) | carry));
+        carry = bits >> 63;
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method converts the container to the type with the smallest size.
+ *
+ * Size of array container is 2 bytes per set bit, size of bitmap container is 8kB
+ * and size of run container is 4 bytes per run.
+ *
+ * @param cont reference to the container.
+ */
+void RoaringBitVector::optimize(RoaringBitVector::Container& cont)
+{
+    u_int32_t arraySize = (cont.m_cardinality <= ARRAY_MAX_SIZE) ? (2 * cont.m_cardinality) : 0xFFFFFFFF;
+    u_int32_t bitmapSize = 8 * BITMAP_WORDS;
+    u_int32_t runSize = 4 * numOfRuns(cont);
+    int type = CONTAINER_BITMAP;
+
+    if ( (runSize < arraySize) && (runSize < bitmapSize) )
+        type = CONTAINER_RUN;
+    else if ( arraySize <= bitmapSize )
+        type = CONTAINER_ARRAY;
+
+    if ( type == cont.m_type )
+        return;
+
+    switch ( type )
+    {
+        case CONTAINER_ARRAY:
+        {
+            vector< u_int16_t > values;
+            toArray(cont, values);
+            cont.m_values.swap(values);
+            vector< u_int64_t >().swap(cont.m_bitmap);
+            break;
+        }
+
+        case CONTAINER_BITMAP:
+            toBitmap(cont, cont.m_bitmap);
+            vector< u_int16_t >().swap(cont.m_values);
+            break;
+
+        default:
+        {
+            vector< u_int16_t > runs;
+            toRuns(cont, runs);
+            cont.m_values.swap(runs);
+            vector< u_int64_t >().swap(cont.m_bitmap);
+            break;
+        }
+    }
+
+    cont.m_type = type;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method computes logical AND of two containers with the same key.
+ *
+ * Arrays are intersected directly (array with any other container is filtered),
+ * runs are intersected as intervals and other containers as bitmaps.
+ *
+ * @param cont1 reference to the first container.
+ * @param cont2 reference to the second container.
+ * @param result reference to the container where the result is stored.
+ */
+void RoaringBitVector::andContainers(const RoaringBitVector::Container& cont1, const RoaringBitVector::Container& cont2, RoaringBitVector::Container& result)
+{
+    result.m_key = cont1.m_key;
+    result.m_values.clear();
+    result.m_bitmap.clear();
+
+    if ( (cont1.m_type == CONTAINER_ARRAY) && (cont2.m_type == CONTAINER_ARRAY) )
+    {
+        result.m_type = CONTAINER_ARRAY;
+        set_intersection(cont1.m_values.begin(), cont1.m_values.end(), cont2.m_values.begin(), cont2.m_values.end(), back_inserter(result.m_values));
+        result.m_cardinality = result.m_values.size();
+        return;
+    }
+
+    if ( (cont1.m_type == CONTAINER_ARRAY) || (cont2.m_type == CONTAINER_ARRAY) )
+    {
+        const Container& array = (cont1.m_type == CONTAINER_ARRAY) ? cont1 : cont2;
+        const Container& other = (cont1.m_type == CONTAINER_ARRAY) ? cont2 : cont1;
+
+        result.m_type = CONTAINER_ARRAY;
+        for ( size_t i = 0; i < array.m_values.size(); ++i )
+        {
+            if ( contains(other, array.m_values[i]) )
+                result.m_values.push_back(array.m_values[i]);
+        }
+        result.m_cardinality = result.m_values.size();
+        return;
+    }
+
+    if ( (cont1.m_type == CONTAINER_RUN) && (cont2.m_type == CONTAINER_RUN) )
+    {
+        result.m_type = CONTAINER_RUN;
+        result.m_cardinality = 0;
+
+        size_t i = 0;
+        size_t j = 0;
+        while ( (i < cont1.m_values.size()) && (j < cont2.m_values.size()) )
+        {
+            u_int32_t end1 = cont1.m_values[i] + cont1.m_values[i + 1];
+            u_int32_t end2 = cont2.m_values[j] + cont2.m_values[j + 1];
+            u_int32_t start = max(cont1.m_values[i], cont2.m_values[j]);
+            u_int32_t end = min(end1, end2);
+
+            if ( start <= end )
+            {
+                result.m_values.push_back(start);
+                result.m_values.push_back(end - start);
+                result.m_cardinality += end - start + 1;
+            }
+
+            if ( end1 < end2 )
+                i += 2;
+            else
+                j += 2;
+        }
+
+        optimize(result);
+        return;
+    }
+
+    vector< u_int64_t > words;
+    toBitmap(cont1, result.m_bitmap);
+    toBitmap(cont2, words);
+
+    result.m_type = CONTAINER_BITMAP;
+    result.m_cardinality = 0;
+    for ( u_int32_t i = 0; i < BITMAP_WORDS; ++i )
+    {
+        result.m_bitmap[i] &= words[i];
+        result.m_cardinality += __builtin_popcountll(result.m_bitmap[i]);
+    }
+
+    optimize(result);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method computes logical OR of two containers with the same key.
+ *
+ * Arrays are merged directly, runs are merged as intervals and other containers as bitmaps.
+ *
+ * @param cont1 reference to the first container.
+ * @param cont2 reference to the second container.
+ * @param result reference to the container where the result is stored.
+ */
+void RoaringBitVector::orContainers(const RoaringBitVector::Container& cont1, const RoaringBitVector::Container& cont2, RoaringBitVector::Container& result)
+{
+    result.m_key = cont1.m_key;
+    result.m_values.clear();
+    result.m_bitmap.clear();
+
+    if ( (cont1.m_type == CONTAINER_ARRAY) && (cont2.m_type == CONTAINER_ARRAY) )
+    {
+        result.m_type = CONTAINER_ARRAY;
+        set_union(cont1.m_values.begin(), cont1.m_values.end(), cont2.m_values.begin(), cont2.m_values.end(), back_inserter(result.m_values));
+        result.m_cardinality = result.m_values.size();
+
+        if ( result.m_cardinality > ARRAY_MAX_SIZE )
+            optimize(result);
+        return;
+    }
+
+    if ( (cont1.m_type == CONTAINER_RUN) && (cont2.m_type == CONTAINER_RUN) )
+    {
+        result.m_type = CONTAINER_RUN;
+        result.m_cardinality = 0;
+
+        size_t i = 0;
+        size_t j = 0;
+        while ( (i < cont1.m_values.size()) || (j < cont2.m_values.size()) )
+        {
+            /* take the run starting first */
+            const vector< u_int16_t >* runs;
+            size_t index;
+
+            if ( (j >= cont2.m_values.size()) || ((i < cont1.m_values.size()) && (cont1.m_values[i] <= cont2.m_values[j])) )
+            {
+                runs = &cont1.m_values;
+                index = i;
+                i += 2;
+            }
+            else
+            {
+                runs = &cont2.m_values;
+                index = j;
+                j += 2;
+            }
+
+            u_int32_t start = (*runs)[index];
+            u_int32_t end = start + (*runs)[index + 1];
+
+            /* merge with the last run, if they overlap or touch */
+            if ( !result.m_values.empty() && (start <= (u_int32_t)(result.m_values[result.m_values.size() - 2] + result.m_values.back() + 1)) )
+            {
+                u_int32_t lastStart = result.m_values[result.m_values.size() - 2];
+                u_int32_t lastEnd = lastStart + result.m_values.back();
+
+                if ( end > lastEnd )
+                {
+                    result.m_values.back() = end - lastStart;
+                    result.m_cardinality += end - lastEnd;
+                }
+            }
+            else
+            {
+                result.m_values.push_back(start);
+                result.m_values.push_back(end - start);
+                result.m_cardinality += end - start + 1;
+            }
+        }
+
+        optimize(result);
+        return;
+    }
+
+    vector< u_int64_t > words;
+    toBitmap(cont1, result.m_bitmap);
+    toBitmap(cont2, words);
+
+    result.m_type = CONTAINER_BITMAP;
+    result.m_cardinality = 0;
+    for ( u_int32_t i = 0; i < BITMAP_WORDS; ++i )
+    {
+        result.m_bitmap[i] |= words[i];
+        result.m_cardinality += __builtin_popcountll(result.m_bitmap[i]);
+    }
+
+    optimize(result);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method sets the bit at passed index to value "1".
+ *
+ * @throw Exception if the index is out of the vector.
+ * @param index position of the bit to be set to value 1. Position has to be
+ * less than size of the vector.
+ */
+void RoaringBitVector::set(const u_int32_t index) throw(Exception)
+{
+    if ( index >= m_sizeInBits )
+        throw Exception("Index out of borders!");
+
+    u_int32_t key = index / CHUNK_BITS;
+    Container* cont = findContainer(key);
+
+    if ( cont != NULL )
+    {
+        setInContainer(*cont, index % CHUNK_BITS);
+        return;
+    }
+
+    /* create new array container */
+    vector< Container >::iterator it = m_containers.begin();
+    while ( (it != m_containers.end()) && (it->m_key < key) )
+        ++it;
+
+    it = m_containers.insert(it, Container());
+    it->m_key = key;
+    it->m_type = CONTAINER_ARRAY;
+    it->m_cardinality = 1;
+    it->m_values.push_back(index % CHUNK_BITS);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method for getting value of bit on passed index.
+ *
+ * @throw Exception if the index is out of the vector.
+ * @param index position of the bit we want to get its value. Position has to be
+ * less than size of the vector.
+ * @return value of the bit at passed index.
+ */
+bool RoaringBitVector::get(const u_int32_t index) throw(Exception)
+{
+    if ( index >= m_sizeInBits )
+        throw Exception("Index out of borders!");
+
+    Container* cont = findContainer(index / CHUNK_BITS);
+
+    return ( (cont != NULL) && contains(*cont, index % CHUNK_BITS) );
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method to get size of bit vector.
+ *
+ * @return number of bits in bit vector.
+ */
+u_int32_t RoaringBitVector::size()
+{
+    return m_sizeInBits;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method counts set bits of the vector.
+ *
+ * @return number of bits set to value "1".
+ */
+u_int32_t RoaringBitVector::count() const
+{
+    u_int32_t result = 0;
+
+    for ( size_t i = 0; i < m_containers.size(); ++i )
+        result += m_containers[i].m_cardinality;
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns string representing the containers of the vector for debug purposes.
+ *
+ * @return string containing the type and the content of every container.
+ */
+std::string RoaringBitVector::toStringHex()
+{
+    static const char* types[] = { "ARRAY", "BITMAP", "RUN" };
+    std::stringstream output;
+
+    for ( size_t i = 0; i < m_containers.size(); ++i )
+    {
+        const Container& cont = m_containers[i];
+
+        output << "Container " << std::dec << cont.m_key << " " << types[cont.m_type] << " (" << cont.m_cardinality << "):";
+
+        if ( cont.m_type == CONTAINER_BITMAP )
+        {
+            for ( u_int32_t j = 0; j < BITMAP_WORDS; ++j )
+                output << " 0x" << std::setw(16) << std::setfill('0') << std::right << std::hex << std::uppercase << cont.m_bitmap[j];
+        }
+        else
+        {
+            for ( size_t j = 0; j < cont.m_values.size(); ++j )
+                output << " 0x" << std::setw(4) << std::setfill('0') << std::right << std::hex << std::uppercase << cont.m_values[j];
+        }
+
+        output << std::endl;
+    }
+
+    output << "Size= " << std::dec << m_sizeInBits << std::endl;
+
+    return output.str();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the object of iterator through indeces of ones in current bit vector.
+ *
+ * @param stopIndex value of end index to which we want not iterate the positions of ones (not included).
+ * @param startIndex value of start index from which we want to iterate the positions of one (included).
+ * @return iterator through the indices of ones in current bit vector.
+ */
+RoaringBitVector::OnesIterator RoaringBitVector::getOnesIterator(const u_int32_t stopIndex, const u_int32_t startIndex) throw(Exception)
+{
+    if (stopIndex < startIndex)
+        throw Exception("Stop index smaller than Start index!");
+
+    u_int32_t stop = (stopIndex < size()) ? stopIndex : size();
+
+    return RoaringBitVector::OnesIterator(m_containers.empty() ? NULL : &m_containers[0], m_containers.size(), stop, startIndex);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns bit vector in non-compressed format.
+ *
+ * @return non-compressed bit vector.
+ */
+boost::dynamic_bitset<> RoaringBitVector::getUncompressedVector()
+{
+    boost::dynamic_bitset<> vector(m_sizeInBits, 0);
+    OnesIterator it = getOnesIterator(m_sizeInBits);
+
+    int32_t index;
+    while ( (index = it.next()) != -1 )
+        vector[index] = true;
+
+    return vector;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical AND.
+ *
+ * @param vector2 reference to the second bit vector.
+ * @return new bit vector which is the AND of two vectors.
+ */
+RoaringBitVector RoaringBitVector::operator&(const RoaringBitVector& vector2) const
+{
+    RoaringBitVector result = *this;
+    result &= vector2;
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical OR.
+ *
+ * @param vector2 reference to he second bit vector.
+ * @return new bit vector which is the OR of two vectors.
+ */
+RoaringBitVector RoaringBitVector::operator|(const RoaringBitVector& vector2) const
+{
+    RoaringBitVector result = *this;
+    result |= vector2;
+    return result;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical AND with assignment.
+ *
+ * @param vector2 reference to the second bit vector.
+ * @return reference to the original bit vector which is AND of original and the second vector.
+ */
+RoaringBitVector& RoaringBitVector::operator&=(const RoaringBitVector& vector2)
+{
+    andInto(*this, *this, vector2);
+
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical OR with assignment.
+ *
+ * @param vector2 reference to the second bit vector.
+ * @return reference to the original bit vector which is logical OR of original and the second vector.
+ */
+RoaringBitVector& RoaringBitVector::operator|=(const RoaringBitVector& vector2)
+{
+    orInto(*this, *this, vector2);
+
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical AND of two vectors into the destination vector.
+ *
+ * Only containers with the same key in both vectors are combined, empty results are removed.
+ * Destination vector can be the same object as one of the operands.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vector1 reference to the first bit vector.
+ * @param vector2 reference to the second bit vector.
+ */
+void RoaringBitVector::andInto(RoaringBitVector& dst, const RoaringBitVector& vector1, const RoaringBitVector& vector2)
+{
+    const vector< Container >& containers1 = vector1.m_containers;
+    const vector< Container >& containers2 = vector2.m_containers;
+    vector< Container > newContainers;
+    size_t i = 0;
+    size_t j = 0;
+
+    while ( (i < containers1.size()) && (j < containers2.size()) )
+    {
+        if ( containers1[i].m_key < containers2[j].m_key )
+            ++i;
+        else if ( containers1[i].m_key > containers2[j].m_key )
+            ++j;
+        else
+        {
+            newContainers.push_back(Container());
+            andContainers(containers1[i], containers2[j], newContainers.back());
+
+            if ( newContainers.back().m_cardinality == 0 )
+                newContainers.pop_back();
+
+            ++i;
+            ++j;
+        }
+    }
+
+    dst.m_containers.swap(newContainers);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical AND of passed vectors into the destination vector.
+ *
+ * Vectors are combined from the one with the fewest containers, so the intermediate results
+ * are as small as possible. If the intermediate result is empty, remaining vectors are skipped.
+ * Destination vector can not be one of the vectors.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array. If zero is passed, all bits of the result are set.
+ */
+void RoaringBitVector::andMany(RoaringBitVector& dst, const RoaringBitVector* const* vectors, size_t numOfVectors)
+{
+    if ( numOfVectors < 2 )
+    {
+        if ( numOfVectors == 0 )
+            dst.reset(true);
+        else
+            andInto(dst, *vectors[0], *vectors[0]);
+
+        return;
+    }
+
+    vector< pair< size_t, const RoaringBitVector* > > order(numOfVectors);
+    for ( size_t i = 0; i < numOfVectors; ++i )
+        order[i] = make_pair(vectors[i]->m_containers.size(), vectors[i]);
+
+    sort(order.begin(), order.end());
+
+    andInto(dst, *order[0].second, *order[1].second);
+
+    for ( size_t i = 2; (i < numOfVectors) && !dst.m_containers.empty(); ++i )
+        andInto(dst, dst, *order[i].second);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical OR of two vectors into the destination vector.
+ *
+ * Containers with the same key are combined, other containers are copied.
+ * Destination vector can be the same object as one of the operands.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vector1 reference to the first bit vector.
+ * @param vector2 reference to the second bit vector.
+ */
+void RoaringBitVector::orInto(RoaringBitVector& dst, const RoaringBitVector& vector1, const RoaringBitVector& vector2)
+{
+    const vector< Container >& containers1 = vector1.m_containers;
+    const vector< Container >& containers2 = vector2.m_containers;
+
+    if ( containers2.empty() || containers1.empty() )
+    {
+        if ( &dst != (containers2.empty() ? &vector1 : &vector2) )
+            dst.m_containers = containers2.empty() ? containers1 : containers2;
+        return;
+    }
+
+    vector< Container > newContainers;
+    size_t i = 0;
+    size_t j = 0;
+
+    while ( (i < containers1.size()) || (j < containers2.size()) )
+    {
+        if ( (j >= containers2.size()) || ((i < containers1.size()) && (containers1[i].m_key < containers2[j].m_key)) )
+            newContainers.push_back(containers1[i++]);
+        else if ( (i >= containers1.size()) || (containers1[i].m_key > containers2[j].m_key) )
+            newContainers.push_back(containers2[j++]);
+        else
+        {
+            newContainers.push_back(Container());
+            orContainers(containers1[i++], containers2[j++], newContainers.back());
+        }
+    }
+
+    dst.m_containers.swap(newContainers);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the object of iterator through indices of ones in logical AND of passed vectors.
+ *
+ * @throw Exception if no vector is passed.
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array.
+ * @param stopIndex value of end index to which we want to iterate the positions of ones (not included).
+ * @return iterator through the indices of ones in logical AND of passed vectors.
+ */
+RoaringBitVector::AndIterator RoaringBitVector::getAndIterator(const RoaringBitVector* const* vectors, size_t numOfVectors, const u_int32_t stopIndex) throw(Exception)
+{
+    if ( numOfVectors == 0 )
+        throw Exception("No bit vectors to iterate!");
+
+    u_int32_t stop = (stopIndex < vectors[0]->m_sizeInBits) ? stopIndex : vectors[0]->m_sizeInBits;
+
+    return RoaringBitVector::AndIterator(vectors, numOfVectors, stop);
+}
+
+/********************************************************/
+/************ IMPLEMENTATION OF OnesIterator ************/
+/********************************************************/
+
+/**
+ * Class constructor.
+ *
+ * The only meaningful way how to acquire the obect of class OnesIterator is by the method of class
+ * RoaringBitVector getOnesIterator().
+ *
+ * @param containers pointer to the first container of the vector.
+ * @param numOfContainers number of containers of the vector.
+ * @param stopIndex end index to which we want to search ones in the vector (not included).
+ * @param startIndex start index from which we want to search ones in the vector (included).
+ */
+RoaringBitVector::OnesIterator::OnesIterator(const RoaringBitVector::Container* containers, size_t numOfContainers, u_int32_t stopIndex, u_int32_t startIndex) : m_containers(containers),
+              m_numOfContainers(numOfContainers),
+              m_stopIndex(stopIndex),
+              m_containerIndex(0),
+              m_position(0),
+              m_word(0),
+              m_runValue(0)
+{
+    /* skip containers before the start index */
+    while ( (m_containerIndex < m_numOfContainers) && (m_containers[m_containerIndex].m_key < (startIndex / CHUNK_BITS)) )
+        ++m_containerIndex;
+
+    if ( m_containerIndex >= m_numOfContainers )
+        return;
+
+    if ( m_containers[m_containerIndex].m_key == (startIndex / CHUNK_BITS) )
+        enterContainer(startIndex % CHUNK_BITS);
+    else
+        enterContainer(0);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method prepares the iteration of the current container.
+ *
+ * @param fromValue index of the first bit within the chunk which can be returned.
+ */
+void RoaringBitVector::OnesIterator::enterContainer(u_int32_t fromValue)
+{
+    const Container& cont = m_containers[m_containerIndex];
+
+    switch ( cont.m_type )
+    {
+        case CONTAINER_ARRAY:
+            m_position = lower_bound(cont.m_values.begin(), cont.m_values.end(), fromValue) - cont.m_values.begin();
+            break;
+
+        case CONTAINER_BITMAP:
+            m_position = fromValue / 64;
+            m_word = cont.m_bitmap[m_position] & (~((u_int64_t) 0) << (fromValue % 64));
+            break;
+
+        default:
+            m_position = 0;
+            m_runValue = fromValue;
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the position of next one in the vector.
+ *
+ * @return index of the next one. If there is no next one found, returns -1.
+ */
+int32_t RoaringBitVector::OnesIterator::next()
+{
+    while ( m_containerIndex < m_numOfContainers )
+    {
+        const Container& cont = m_containers[m_containerIndex];
+        int32_t value = -1;
+
+        switch ( cont.m_type )
+        {
+            case CONTAINER_ARRAY:
+                if ( m_position < cont.m_values.size() )
+                    value = cont.m_values[m_position++];
+                break;
+
+            case CONTAINER_BITMAP:
+                while ( (m_word == 0) && (++m_position < BITMAP_WORDS) )
+                    m_word = cont.m_bitmap[m_position];
+
+                if ( m_word != 0 )
+                {
+                    value = (m_position * 64) + __builtin_ctzll(m_word);
+                    m_word &= m_word - 1;
+                }
+                break;
+
+            default:
+                for ( ; m_position < cont.m_values.size(); m_position += 2 )
+                {
+                    u_int32_t start = cont.m_values[m_position];
+
+                    if ( m_runValue < start )
+                        m_runValue = start;
+
+                    if ( m_runValue <= (start + cont.m_values[m_position + 1]) )
+                    {
+                        value = m_runValue++;
+                        break;
+                    }
+                }
+                break;
+        }
+
+        if ( value >= 0 )
+        {
+            u_int32_t index = (cont.m_key * CHUNK_BITS) + value;
+
+            if ( index < m_stopIndex )
+                return index;
+
+            m_containerIndex = m_numOfContainers;
+            return -1;
+        }
+
+        /* container is exhausted */
+        if ( ++m_containerIndex < m_numOfContainers )
+            enterContainer(0);
+    }
+
+    return -1;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores positions of following ones in the vector to passed array.
+ *
+ * @param out pointer to the array where positions are stored.
+ * @param maxCount maximum number of stored positions (size of the array).
+ * @return number of stored positions. If it is zero, there is no next one.
+ */
+size_t RoaringBitVector::OnesIterator::nextBatch(int32_t* out, size_t maxCount)
+{
+    size_t count = 0;
+    int32_t index;
+
+    while ( (count < maxCount) && ((index = next()) != -1) )
+        out[count++] = index;
+
+    return count;
+}
+
+/********************************************************/
+/************ IMPLEMENTATION OF AndIterator *************/
+/********************************************************/
+
+/**
+ * Class constructor.
+ *
+ * The only meaningful way how to acquire the object of class AndIterator is by the method
+ * RoaringBitVector::getAndIterator().
+ *
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array (at least one).
+ * @param stopIndex end index to which we want to search ones (not included), at most the size of vectors.
+ */
+RoaringBitVector::AndIterator::AndIterator(const RoaringBitVector* const* vectors, size_t numOfVectors, u_int32_t stopIndex) : m_containers(numOfVectors),
+              m_positions(numOfVectors, 0),
+              m_stopIndex(stopIndex),
+              m_key(0),
+              m_valueIndex(0)
+{
+    for ( size_t i = 0; i < numOfVectors; ++i )
+        m_containers[i] = &vectors[i]->m_containers;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method finds the following chunk with some set bit in the AND of vectors.
+ *
+ * @return TRUE - if the chunk was found, its set bits are stored in m_values.
+ *         FALSE - if there is no such chunk before the stop index.
+ */
+bool RoaringBitVector::AndIterator::nextChunk()
+{
+    if ( m_stopIndex == 0 )
+        return false;
+
+    u_int32_t lastKey = (m_stopIndex - 1) / CHUNK_BITS;
+    size_t numOfVectors = m_containers.size();
+
+    while ( true )
+    {
+        /* the greatest key of current containers is the smallest possible common key */
+        u_int32_t key = 0;
+        for ( size_t i = 0; i < numOfVectors; ++i )
+        {
+            if ( m_positions[i] >= m_containers[i]->size() )
+                return false;
+
+            key = max(key, (*m_containers[i])[m_positions[i]].m_key);
+        }
+
+        if ( key > lastKey )
+            return false;
+
+        bool common = true;
+        for ( size_t i = 0; i < numOfVectors; ++i )
+        {
+            const vector< Container >& containers = *m_containers[i];
+
+            while ( (m_positions[i] < containers.size()) && (containers[m_positions[i]].m_key < key) )
+                ++m_positions[i];
+
+            if ( (m_positions[i] >= containers.size()) || (containers[m_positions[i]].m_key != key) )
+                common = false;
+        }
+
+        if ( !common )
+            continue;
+
+        const Container& first = (*m_containers[0])[m_positions[0]];
+
+        if ( numOfVectors == 1 )
+            toArray(first, m_values);
+        else
+        {
+            andContainers(first, (*m_containers[1])[m_positions[1]], m_result);
+
+            for ( size_t i = 2; (i < numOfVectors) && (m_result.m_cardinality > 0); ++i )
+            {
+                andContainers(m_result, (*m_containers[i])[m_positions[i]], m_partial);
+
+                /* swap the partial result to m_result, memory of both is reused */
+                m_result.m_values.swap(m_partial.m_values);
+                m_result.m_bitmap.swap(m_partial.m_bitmap);
+                m_result.m_type = m_partial.m_type;
+                m_result.m_cardinality = m_partial.m_cardinality;
+            }
+
+            toArray(m_result, m_values);
+        }
+
+        for ( size_t i = 0; i < numOfVectors; ++i )
+            ++m_positions[i];
+
+        if ( !m_values.empty() )
+        {
+            m_key = key;
+            m_valueIndex = 0;
+            return true;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the position of next one in the AND of vectors.
+ *
+ * @return index of the next one. If there is no next one found, returns -1.
+ */
+int32_t RoaringBitVector::AndIterator::next()
+{
+    if ( m_valueIndex >= m_values.size() )
+    {
+        if ( !nextChunk() )
+        {
+            m_values.clear();
+            return -1;
+        }
+    }
+
+    u_int32_t index = (m_key * CHUNK_BITS) + m_values[m_valueIndex++];
+
+    if ( index >= m_stopIndex )
+    {
+        m_values.clear();
+        m_valueIndex = 0;
+        for ( size_t i = 0; i < m_positions.size(); ++i )
+            m_positions[i] = m_containers[i]->size();
+
+        return -1;
+    }
+
+    return index;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores positions of following ones in the AND of vectors to passed array.
+ *
+ * Set bits of the current chunk are copied at once.
+ *
+ * @param out pointer to the array where positions are stored.
+ * @param maxCount maximum number of stored positions (size of the array).
+ * @return number of stored positions. If it is zero, there is no next one.
+ */
+size_t RoaringBitVector::AndIterator::nextBatch(int32_t* out, size_t maxCount)
+{
+    size_t count = 0;
+
+    while ( count < maxCount )
+    {
+        if ( (m_valueIndex >= m_values.size()) && !nextChunk() )
+        {
+            m_values.clear();
+            m_valueIndex = 0;
+            break;
+        }
+
+        u_int32_t chunkStartIndex = m_key * CHUNK_BITS;
+
+        while ( (m_valueIndex < m_values.size()) && (count < maxCount) )
+        {
+            u_int32_t index = chunkStartIndex + m_values[m_valueIndex++];
+
+            if ( index >= m_stopIndex )
+            {
+                m_values.clear();
+                m_valueIndex = 0;
+                for ( size_t i = 0; i < m_positions.size(); ++i )
+                    m_positions[i] = m_containers[i]->size();
+
+                return count;
+            }
+
+            out[count++] = index;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,161 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <vector>
+#include <string>
+#include <sys/types.h>
+#include <boost/dynamic_bitset.hpp>
+
+#include "Exception.hpp"
+
+#ifndef ROARING_BIT_VECTOR_H_736152094817263549018273645102938475610293847
+#define ROARING_BIT_VECTOR_H_736152094817263549018273645102938475610293847
+
+/**
+ * Class RoaringBitVector represents bit vector compressed by containers (Roaring bitmap).
+ *
+ * Bits of the vector are split to chunks of 65536 bits and every chunk containing some set bit
+ * is stored in one container. Container is either sorted array of set bits (up to 4096 bits),
+ * bitmap of 1024 64bit words, or sorted array of runs of set bits. After every operation
+ * the container with the smallest size is used. Vector with a few set bits therefore occupies
+ * only a few bytes and AND/OR operations of such vectors are intersections and unions of
+ * sorted arrays. The interface is the same as the interface of WAHBitVector, so the class
+ * can be used as the bit vector of prefix trees.
+ */
+class RoaringBitVector
+{
+    private:
+        static const int CONTAINER_ARRAY = 0;           /** Container is sorted array of set bits. */
+        static const int CONTAINER_BITMAP = 1;          /** Container is bitmap. */
+        static const int CONTAINER_RUN = 2;             /** Container is sorted array of runs. */
+
+        static const u_int32_t CHUNK_BITS = 65536;      /** Number of bits in one chunk. */
+        static const u_int32_t BITMAP_WORDS = 1024;     /** Number of 64bit words of bitmap container. */
+        static const u_int32_t ARRAY_MAX_SIZE = 4096;   /** Maximum number of items of array container. */
+
+        /**
+         * Structure representing one container.
+         */
+        struct Container
+        {
+            u_int32_t m_key;                    /** Index of the chunk stored in the container. */
+            int m_type;                         /** Type of the container (constant CONTAINER_XXX). */
+            u_int32_t m_cardinality;            /** Number of set bits in the container. */
+            std::vector< u_int16_t > m_values;  /** Sorted set bits (array), or pairs start, length - 1 (run). */
+            std::vector< u_int64_t > m_bitmap;  /** Words of the bitmap (bitmap). */
+        };
+
+        std::vector< Container > m_containers;  /** Containers of not empty chunks sorted by their keys. */
+        u_int32_t m_sizeInBits;                 /** Length of vector in bits */
+
+    protected:
+        Container* findContainer(u_int32_t key);
+
+        static bool contains(const Container& cont, u_int16_t value);
+        static void setInContainer(Container& cont, u_int16_t value);
+        static void toBitmap(const Container& cont, std::vector< u_int64_t >& words);
+        static void toRuns(const Container& cont, std::vector< u_int16_t >& runs);
+        static void toArray(const Container& cont, std::vector< u_int16_t >& values);
+        static u_int32_t numOfRuns(const Container& cont);
+        static void optimize(Container& cont);
+        static void andContainers(const Container& cont1, const Container& cont2, Container& result);
+        static void orContainers(const Container& cont1, const Container& cont2, Container& result);
+
+    public:
+        class OnesIterator;         /** forward declaration of class OnesIterator */
+        class AndIterator;          /** forward declaration of class AndIterator */
+
+        RoaringBitVector(const u_int32_t size, bool setBit = false);
+        virtual ~RoaringBitVector() { };
+
+        void reset(bool fillBit = false);
+
+        void set(const u_int32_t index) throw(Exception);
+        bool get(const u_int32_t index) throw(Exception);
+        u_int32_t size();
+        u_int32_t count() const;
+        std::string toStringHex();
+        OnesIterator getOnesIterator(const u_int32_t stopIndex, const u_int32_t startIndex = 0) throw(Exception);
+
+        boost::dynamic_bitset<> getUncompressedVector();
+
+        RoaringBitVector operator | (const RoaringBitVector& vector2) const;
+        RoaringBitVector operator & (const RoaringBitVector& vector2) const;
+        RoaringBitVector& operator |= (const RoaringBitVector& vector2);
+        RoaringBitVector& operator &= (const RoaringBitVector& vector2);
+
+        static void andInto(RoaringBitVector& dst, const RoaringBitVector& vector1, const RoaringBitVector& vector2);
+        static void orInto(RoaringBitVector& dst, const RoaringBitVector& vector1, const RoaringBitVector& vector2);
+        static void andMany(RoaringBitVector& dst, const RoaringBitVector* const* vectors, size_t numOfVectors);
+        static AndIterator getAndIterator(const RoaringBitVector* const* vectors, size_t numOfVectors, const u_int32_t stopIndex) throw(Exception);
+
+        /**
+         * Class OnesIterator represents the iterator of bit vector RoaringBitVector which iterates through set bits.
+         *
+         * Iterator goes through containers in the order of their keys and returns set bits
+         * stored in them.
+         */
+        class OnesIterator
+        {
+            private:
+                const Container* const m_containers;    /** Pointer to the first container of the vector */
+                const size_t m_numOfContainers;         /** Number of containers of the vector */
+                const u_int32_t m_stopIndex;            /** Variable containing the value of end index to which we search set bits (not included) */
+                size_t m_containerIndex;                /** Index of the current container */
+                u_int32_t m_position;                   /** Position in the current container (item of array or run, word of bitmap) */
+                u_int64_t m_word;                       /** Not yet returned set bits of the current word of bitmap */
+                u_int32_t m_runValue;                   /** Next value of the current run */
+
+                void enterContainer(u_int32_t fromValue);
+
+            public:
+                OnesIterator(const Container* containers, size_t numOfContainers, u_int32_t stopIndex, u_int32_t startIndex = 0);
+                ~OnesIterator() { };
+                int32_t next();
+                size_t nextBatch(int32_t* out, size_t maxCount);
+        };
+
+        /**
+         * Class AndIterator represents the iterator through set bits of logical AND of several RoaringBitVector-s.
+         *
+         * Iterator finds keys of containers present in all vectors and combines only these
+         * containers, one chunk at a time. Containers after the stop index are not combined.
+         */
+        class AndIterator
+        {
+            private:
+                std::vector< const std::vector< Container >* > m_containers;   /** Containers of all vectors */
+                std::vector< size_t > m_positions;      /** Indexes of the next not combined container of every vector */
+                const u_int32_t m_stopIndex;            /** Variable containing the value of end index to which we search set bits (not included) */
+                Container m_result;                     /** AND of containers of the current chunk */
+                Container m_partial;                    /** Partial AND of containers of the current chunk */
+                std::vector< u_int16_t > m_values;      /** Set bits of the current chunk */
+                u_int32_t m_key;                        /** Key of the current chunk */
+                size_t m_valueIndex;                    /** Index of the next not returned set bit of the current chunk */
+
+                bool nextChunk();
+
+            public:
+                AndIterator(const RoaringBitVector* const* vectors, size_t numOfVectors, u_int32_t stopIndex);
+                ~AndIterator() { };
+                int32_t next();
+                size_t nextBatch(int32_t* out, size_t maxCount);
+        };
+};
+
+#endif /* ROARING_BIT_VECTOR_H_736152094817263549018273645102938475610293847 */
@@ -36,14 +36,46 @@ using namespace std;
  * @param size size of created vector in bits.
  * @param fillBit initial value for all bits of newly created vector.
  */
-WAHBitVector::WAHBitVector(const u_int32_t size, bool fillBit) : m_sizeInBits(size), m_activeWordValue(0)
+WAHBitVector::WAHBitVector(const u_int32_t size, bool fillBit) : m_sizeInBits(size)
 {
-    m_activeWordBitsCnt = size % 31;        /* number of bits, less than 31 which are not compressed */
-    u_int32_t numOfWords = size / 31;       /* number of words in FILL */
+    reset(fillBit);
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Copy constructor.
+ *
+ * Buffer for results of logical operations and the skip index are not copied.
+ *
+ * @param vector reference to the copied vector.
+ */
+WAHBitVector::WAHBitVector(const WAHBitVector& vector) : m_vec(vector.m_vec),
+                                                        m_sizeInBits(vector.m_sizeInBits),
+                                                        m_activeWordValue(vector.m_activeWordValue),
+                                                        m_activeWordBitsCnt(vector.m_activeWordBitsCnt),
+                                                        m_skipIndexValid(false)
+{
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method sets all bits of the vector to passed value.
+ *
+ * Memory of the vector is not freed, so it can be reused without new allocation.
+ *
+ * @param fillBit new value for all bits of the vector.
+ */
+void WAHBitVector::reset(bool fillBit)
+{
+    m_activeWordBitsCnt = m_sizeInBits % 31;        /* number of bits, less than 31 which are not compressed */
+    u_int32_t numOfWords = m_sizeInBits / 31;       /* number of words in FILL */
+
+    m_activeWordValue = fillBit ? 0xFFFFFFFF : 0;
+    m_vec.clear();
+    m_skipIndexValid = false;
 
-    if ( fillBit )
-        m_activeWordValue = 0xFFFFFFFF;
-    
     if (numOfWords > 0)
     {
         if ( fillBit )
@@ -51,7 +83,7 @@ WAHBitVector::WAHBitVector(const u_int32_t size, bool fillBit) : m_sizeInBits(si
         else
             numOfWords |= 0x80000000;   /* set MSB bit to signalize that it is FILL of zeroes*/
 
-        m_vec.assign(1, numOfWords);    /* add FILL to vector */
+        m_vec.push_back(numOfWords);    /* add FILL to vector */
     }
 }
 
@@ -60,6 +92,9 @@ WAHBitVector::WAHBitVector(const u_int32_t size, bool fillBit) : m_sizeInBits(si
 /**
  * Method sets the bit at passed index to value "1".
  *
+ * Prefix trees set bits in increasing order, so the wanted RUN is usually one of the last
+ * TAIL_RUNS RUNs and it is found in constant time. Other RUNs are found using the skip index.
+ *
  * @throw Exception if it is not possible to set a bit due to error, an exception is thrown.
  * @param index position of the bit to be set to value 1. Position has to be 
  * less than size of the vector - 1.
@@ -80,8 +115,18 @@ void WAHBitVector::set(const u_int32_t index) throw(Exception)
     /* set a bit in some RUN in the vector */
     else
     {
-        std::vector<u_int32_t>::iterator iter = m_vec.begin();
-        u_int32_t actRunStartIndex = 0;
+        u_int32_t actRunStartIndex = m_sizeInBits - m_activeWordBitsCnt;
+        std::vector<u_int32_t>::iterator iter = m_vec.end();
+
+        /* bits are mostly set in increasing order --> try the last RUNs first, otherwise use the skip index */
+        for ( u_int32_t i = 0; (i < TAIL_RUNS) && (iter > m_vec.begin()) && (index < actRunStartIndex); ++i )
+        {
+            --iter;
+            actRunStartIndex -= (*iter > 0x7FFFFFFF) ? (31 * (*iter & 0x3FFFFFFF)) : 31;
+        }
+
+        if ( index < actRunStartIndex )
+            iter = m_vec.begin() + findRun(index, actRunStartIndex);
         
         /* shift to the proper RUN */
         while ( iter < m_vec.end() )
@@ -104,18 +149,23 @@ void WAHBitVector::set(const u_int32_t index) throw(Exception)
                     /* if wanted index belongs to the first RUN, if we decompose FILL to RUNs */
                     else if ( index < actRunStartIndex + 31 )
                     {
+                        u_int32_t wordPos = iter - m_vec.begin();
                         --*iter;                  /* we decrease number of compressed 31-bit words */
                         iter = m_vec.insert(iter, 0);
+                        shiftSkipIndex(wordPos, 1);
                     }
                     /* if wanted index belongs to the last RUN, if we decompose FILL to RUNs */
                     else if ( index >= (actRunStartIndex + (31 * ((*iter & 0x3FFFFFFF) - 1))) )
                     {
+                        u_int32_t wordPos = iter - m_vec.begin();
                         --(*iter);                /* we decrease number of compressed 31-bit words */
                         iter = m_vec.insert(iter + 1, 0);
+                        shiftSkipIndex(wordPos, 1);
                     }
                     /* if wanted index belongs to some RUN in the middle, if we decompose FILL to RUNs */
                     else
                     {
+                        u_int32_t wordPos = iter - m_vec.begin();
                         u_int32_t runsInTheFront = (index - actRunStartIndex) / 31;     /* find out how many RUNs are before the RUN where we want to set a bit */
                         *iter -= runsInTheFront + 1;                                    /* we decrease number of RUNs before + one in which we want to set a bit */
                         runsInTheFront |= 0x80000000;                                   /* make a FILL from number of preceding RUNs */
@@ -123,6 +173,7 @@ void WAHBitVector::set(const u_int32_t index) throw(Exception)
                         iter = m_vec.insert(iter, runsInTheFront);
                         ++iter;
                         iter = m_vec.insert(iter, 0);
+                        shiftSkipIndex(wordPos, 2);
                     }
 
                     /* set wanted bit */
@@ -159,7 +210,8 @@ void WAHBitVector::set(const u_int32_t index) throw(Exception)
                             {
                                 /* combine previous, current and following RUN */
                                 *(iter - 1) += (*(iter + 1) & 0x3FFFFFFF) + 1;
-                                m_vec.erase(iter, iter + 1);
+                                m_vec.erase(iter, iter + 2);
+                                m_skipIndexValid = false;
                                 return;
                             }
                             else
@@ -167,6 +219,7 @@ void WAHBitVector::set(const u_int32_t index) throw(Exception)
                                 /* add one FILL to preceding and delete current */
                                 ++*(iter - 1);
                                 m_vec.erase(iter);
+                                m_skipIndexValid = false;
                                 return;
                             }
                         }
@@ -176,6 +229,7 @@ void WAHBitVector::set(const u_int32_t index) throw(Exception)
                             /* add one FILL to following and delete current */
                             ++*(iter + 1);
                             m_vec.erase(iter);
+                            m_skipIndexValid = false;
                             return;
                         }
                         /* if preceding nor following FILL is not FILL of Ones */
@@ -226,8 +280,8 @@ bool WAHBitVector::get(const u_int32_t index) throw(Exception)
     /* we want to get bit value from some vector RUN */
     else
     {
-        std::vector<u_int32_t>::iterator iter = m_vec.begin();
         u_int32_t actRunStartIndex = 0;
+        std::vector<u_int32_t>::iterator iter = m_vec.begin() + findRun(index, actRunStartIndex);
 
         /* move to wanted RUN */
         while ( iter != m_vec.end() )
@@ -254,7 +308,7 @@ bool WAHBitVector::get(const u_int32_t index) throw(Exception)
                 if ( (index >= actRunStartIndex) && (index < (actRunStartIndex + 31 )) )
                 {
                     u_int32_t maska = 0x40000000 >> (index % 31);   /* construct a mask with one at the position */
-                    return ( (m_activeWordValue & maska) == maska );
+                    return ( (*iter & maska) == maska );
                 }
                 else
                 {
@@ -271,6 +325,108 @@ bool WAHBitVector::get(const u_int32_t index) throw(Exception)
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Method finds the 32bit word from which the RUN containing passed index should be searched.
+ *
+ * Short vectors are searched from the beginning. For longer vectors the skip index is built
+ * (if it is not valid) and the last indexed word starting before passed index is found
+ * by binary search, so at most about SKIP_INTERVAL words have to be scanned linearly.
+ *
+ * @param index position of the searched bit.
+ * @param runStartIndex reference to variable where the index of the first bit of found word is stored.
+ * @return position of found word in m_vec.
+ */
+u_int32_t WAHBitVector::findRun(const u_int32_t index, u_int32_t& runStartIndex)
+{
+    runStartIndex = 0;
+
+    if ( m_vec.size() <= SKIP_INTERVAL )
+        return 0;
+
+    if ( !m_skipIndexValid )
+        rebuildSkipIndex();
+
+    /* find the last entry with start index less or equal to passed index */
+    size_t low = 0;
+    size_t high = m_skipIndex.size();
+
+    while ( (high - low) > 1 )
+    {
+        size_t middle = (low + high) / 2;
+
+        if ( m_skipIndex[middle].m_startIndex <= index )
+            low = middle;
+        else
+            high = middle;
+    }
+
+    runStartIndex = m_skipIndex[low].m_startIndex;
+    return m_skipIndex[low].m_wordPos;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method builds the skip index containing every SKIP_INTERVAL-th word of the vector.
+ */
+void WAHBitVector::rebuildSkipIndex()
+{
+    u_int32_t actRunStartIndex = 0;
+    u_int32_t numOfWords = m_vec.size();
+
+    m_skipIndex.clear();
+
+    for ( u_int32_t i = 0; i < numOfWords; ++i )
+    {
+        if ( (i % SKIP_INTERVAL) == 0 )
+        {
+            SkipEntry entry = { i, actRunStartIndex };
+            m_skipIndex.push_back(entry);
+        }
+
+        /* add number of bits coded by FILL or LITERAL */
+        if ( m_vec[i] > 0x7FFFFFFF )
+            actRunStartIndex += 31 * (m_vec[i] & 0x3FFFFFFF);
+        else
+            actRunStartIndex += 31;
+    }
+
+    m_skipIndexValid = true;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method updates the skip index after new words were inserted behind the passed word.
+ *
+ * Words inserted by set() code the same bits as the split FILL, so only positions of
+ * following indexed words change. If too many words were inserted between two entries,
+ * the index is invalidated and it will be built again when needed.
+ *
+ * @param wordPos position of the word which was split (entries after it are shifted).
+ * @param numOfWords number of inserted words.
+ */
+void WAHBitVector::shiftSkipIndex(const u_int32_t wordPos, const u_int32_t numOfWords)
+{
+    if ( !m_skipIndexValid )
+        return;
+
+    size_t i = m_skipIndex.size();
+    while ( (i > 0) && (m_skipIndex[i - 1].m_wordPos > wordPos) )
+    {
+        --i;
+        m_skipIndex[i].m_wordPos += numOfWords;
+    }
+
+    /* i is the first shifted entry, entry i - 1 contains the split word */
+    u_int32_t nextWordPos = (i < m_skipIndex.size()) ? m_skipIndex[i].m_wordPos : m_vec.size();
+
+    if ( (i == 0) || ((nextWordPos - m_skipIndex[i - 1].m_wordPos) > (2 * SKIP_INTERVAL)) )
+        m_skipIndexValid = false;
+}
+
+//-----------------------------------------------------------------------------------
+
 /**
  * Method to get size of bit vector.
  *
@@ -327,6 +483,27 @@ WAHBitVector::OnesIterator WAHBitVector::getOnesIterator(const u_int32_t stopInd
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Method returns the object of iterator through indices of ones in logical AND of passed vectors.
+ *
+ * @throw Exception if no vector is passed.
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array.
+ * @param stopIndex value of end index to which we want to iterate the positions of ones (not included).
+ * @return iterator through the indices of ones in logical AND of passed vectors.
+ */
+WAHBitVector::AndIterator WAHBitVector::getAndIterator(const WAHBitVector* const* vectors, size_t numOfVectors, const u_int32_t stopIndex) throw(Exception)
+{
+    if ( numOfVectors == 0 )
+        throw Exception("No bit vectors to iterate!");
+
+    u_int32_t stop = (stopIndex < vectors[0]->m_sizeInBits) ? stopIndex : vectors[0]->m_sizeInBits;
+
+    return WAHBitVector::AndIterator(vectors, numOfVectors, stop);
+}
+
+//-----------------------------------------------------------------------------------
+
 /**
  * Method returns bit vector in non-compressed format.
  *
@@ -420,12 +597,49 @@ WAHBitVector WAHBitVector::operator|(const WAHBitVector& vector2) const
  */
 WAHBitVector& WAHBitVector::operator&=(const WAHBitVector& vector2)
 {
+    andInto(*this, *this, vector2);
+
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Operator of logical OR with assignment.
+ *
+ * @param vector2 reference to the second bit vector.
+ * @return reference to the original bit vector which is logical OR of original and the second vector.
+ */
+WAHBitVector& WAHBitVector::operator|=(const WAHBitVector& vector2)
+{
+    orInto(*this, *this, vector2);
+
+    return *this;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical AND of two vectors into the destination vector.
+ *
+ * Result is built in the buffer of the destination vector, which is then swapped
+ * with its words. Memory of both is reused by following operations, so no memory
+ * is allocated once the buffers are large enough. Destination vector can be
+ * the same object as one of the operands.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vector1 reference to the first bit vector.
+ * @param vector2 reference to the second bit vector.
+ */
+void WAHBitVector::andInto(WAHBitVector& dst, const WAHBitVector& vector1, const WAHBitVector& vector2)
+{
+    std::vector<u_int32_t>& newVector = dst.m_scratch;
+    newVector.clear();
+
     /* if the vectors are not empty, do AND also under words in the vector */
-    if ( (!m_vec.empty()) && (!vector2.m_vec.empty()) )
+    if ( (!vector1.m_vec.empty()) && (!vector2.m_vec.empty()) )
     {
-        std::vector<u_int32_t> newVector;
-
-        WAHBitVector::VectorRun run1 = WAHBitVector::VectorRun(m_vec.begin(), m_vec.end());
+        WAHBitVector::VectorRun run1 = WAHBitVector::VectorRun(vector1.m_vec.begin(), vector1.m_vec.end());
         WAHBitVector::VectorRun run2 = WAHBitVector::VectorRun(vector2.m_vec.begin(), vector2.m_vec.end());
 
         while ( !run1.isExhausted() && !run2.isExhausted() )
@@ -456,31 +670,38 @@ WAHBitVector& WAHBitVector::operator&=(const WAHBitVector& vector2)
                 --run2.m_wordsCount;
             }
         }
-
-        m_vec = newVector;
     }
-    
-    m_activeWordValue &= vector2.m_activeWordValue;
+    else
+        newVector = vector1.m_vec;
 
-    return *this;
+    dst.m_vec.swap(newVector);
+    dst.m_skipIndexValid = false;
+    dst.m_activeWordValue = vector1.m_activeWordValue & vector2.m_activeWordValue;
 }
 
 //-----------------------------------------------------------------------------------
 
 /**
- * Operator of logical OR with assignment.
+ * Method stores logical OR of two vectors into the destination vector.
  *
+ * Result is built in the buffer of the destination vector, which is then swapped
+ * with its words. Memory of both is reused by following operations, so no memory
+ * is allocated once the buffers are large enough. Destination vector can be
+ * the same object as one of the operands.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vector1 reference to the first bit vector.
  * @param vector2 reference to the second bit vector.
- * @return reference to the original bit vector which is logical OR of original and the second vector.
  */
-WAHBitVector& WAHBitVector::operator|=(const WAHBitVector& vector2)
+void WAHBitVector::orInto(WAHBitVector& dst, const WAHBitVector& vector1, const WAHBitVector& vector2)
 {
-    /* ak nie su vectory prazdne, rabime AND aj nad slovami vo vectore */
-    if ( (!m_vec.empty()) && (!vector2.m_vec.empty()) )
-    {
-        std::vector<u_int32_t> newVector;
+    std::vector<u_int32_t>& newVector = dst.m_scratch;
+    newVector.clear();
 
-        WAHBitVector::VectorRun run1 = WAHBitVector::VectorRun(m_vec.begin(), m_vec.end());
+    /* if the vectors are not empty, do OR also under words in the vector */
+    if ( (!vector1.m_vec.empty()) && (!vector2.m_vec.empty()) )
+    {
+        WAHBitVector::VectorRun run1 = WAHBitVector::VectorRun(vector1.m_vec.begin(), vector1.m_vec.end());
         WAHBitVector::VectorRun run2 = WAHBitVector::VectorRun(vector2.m_vec.begin(), vector2.m_vec.end());
 
         while ( !run1.isExhausted() && !run2.isExhausted() )
@@ -511,13 +732,119 @@ WAHBitVector& WAHBitVector::operator|=(const WAHBitVector& vector2)
                 --run2.m_wordsCount;
             }
         }
+    }
+    else
+        newVector = vector1.m_vec;
+
+    dst.m_vec.swap(newVector);
+    dst.m_skipIndexValid = false;
+    dst.m_activeWordValue = vector1.m_activeWordValue | vector2.m_activeWordValue;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores logical AND of passed vectors into the destination vector.
+ *
+ * RUNs of all vectors are decoded simultaneously and only the final result is built,
+ * so no intermediate vectors are created. FILL of zeroes in any vector is copied to
+ * the result at once and the words it covers are skipped in the other vectors. If FILL
+ * of zeroes reaches the end of some vector, the rest of other vectors is not decoded at all.
+ * More than MAX_AND_VECTORS vectors are combined with the result one by one.
+ * Destination vector can be the same object as one of the vectors.
+ *
+ * @param dst reference to the vector where the result is stored.
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array. If zero is passed, all bits of the result are set.
+ */
+void WAHBitVector::andMany(WAHBitVector& dst, const WAHBitVector* const* vectors, size_t numOfVectors)
+{
+    if ( numOfVectors < 2 )
+    {
+        if ( numOfVectors == 0 )
+            dst.reset(true);
+        else
+            andInto(dst, *vectors[0], *vectors[0]);
 
-        m_vec = newVector;
+        return;
     }
-    
-    m_activeWordValue |= vector2.m_activeWordValue;
 
-    return *this;
+    size_t numOfDecoded = (numOfVectors < MAX_AND_VECTORS) ? numOfVectors : MAX_AND_VECTORS;
+    std::vector<u_int32_t>& newVector = dst.m_scratch;
+    WAHBitVector::VectorRun runs[MAX_AND_VECTORS];
+    u_int32_t activeWordValue = 0xFFFFFFFF;
+
+    newVector.clear();
+
+    for ( size_t i = 0; i < numOfDecoded; ++i )
+    {
+        runs[i] = WAHBitVector::VectorRun(vectors[i]->m_vec.begin(), vectors[i]->m_vec.end());
+        activeWordValue &= vectors[i]->m_activeWordValue;
+    }
+
+    /* all vectors have the same number of words, so they are exhausted at once */
+    while ( !runs[0].isExhausted() )
+    {
+        u_int32_t word = 0x7FFFFFFF;
+        u_int32_t zeroWords = 0;                /* the longest FILL of zeroes */
+        u_int32_t onesWords = 0xFFFFFFFF;       /* the shortest FILL of ones */
+        bool allFills = true;
+        bool zeroesToEnd = false;
+
+        for ( size_t i = 0; i < numOfDecoded; ++i )
+        {
+            if ( runs[i].m_wordsCount == 0 )
+            {
+                runs[i].decodeRun();
+                ++runs[i].m_iterator;
+            }
+
+            if ( !runs[i].m_isFill )
+                allFills = false;
+            else if ( runs[i].m_word != 0 )
+                onesWords = (runs[i].m_wordsCount < onesWords) ? runs[i].m_wordsCount : onesWords;
+            else
+            {
+                zeroWords = (runs[i].m_wordsCount > zeroWords) ? runs[i].m_wordsCount : zeroWords;
+                zeroesToEnd = zeroesToEnd || (runs[i].m_iterator == runs[i].m_iterEnd);
+            }
+
+            word &= runs[i].m_word;
+        }
+
+        if ( zeroWords > 0 )
+        {
+            WAHBitVector::VectorRun::appendFill(newVector, zeroWords, 0);
+
+            /* the rest of the result contains only zeroes */
+            if ( zeroesToEnd )
+                break;
+
+            for ( size_t i = 0; i < numOfDecoded; ++i )
+                runs[i].skipWords(zeroWords);
+        }
+        else if ( allFills )
+        {
+            WAHBitVector::VectorRun::appendFill(newVector, onesWords, 0x7FFFFFFF);
+
+            for ( size_t i = 0; i < numOfDecoded; ++i )
+                runs[i].m_wordsCount -= onesWords;
+        }
+        else
+        {
+            WAHBitVector::VectorRun::appendLiteral(newVector, word);
+
+            for ( size_t i = 0; i < numOfDecoded; ++i )
+                --runs[i].m_wordsCount;
+        }
+    }
+
+    dst.m_vec.swap(newVector);
+    dst.m_skipIndexValid = false;
+    dst.m_activeWordValue = activeWordValue;
+
+    for ( size_t i = numOfDecoded; i < numOfVectors; ++i )
+        andInto(dst, dst, *vectors[i]);
 }
 
 /********************************************************/
@@ -566,9 +893,9 @@ WAHBitVector::OnesIterator::OnesIterator(std::vector< u_int32_t >::const_iterato
         /* till shift to required RUN */
         while ( !(((int32_t)m_startIndex >= m_actRunStartIndex) && ((int32_t)m_startIndex <= m_actRunEndIndex)) )
         {
+            ++m_iterator;
             m_actRunStartIndex = m_actRunEndIndex + 1;
             m_actRunEndIndex = (*m_iterator > 0x7FFFFFFF) ? ((31 * (*m_iterator & 0x3FFFFFFF)) + m_actRunEndIndex) : (m_actRunEndIndex + 31);
-            ++m_iterator;
         }
     } 
 }
@@ -643,44 +970,49 @@ int32_t WAHBitVector::OnesIterator::next()
             /* it is literal */
             else
             {
-                while ( indexToCheck <= m_actRunEndIndex )
+                /* ones of the literal at the checked index and after it, the first one is found by counting leading zeroes */
+                u_int32_t bits = *m_iterator & (0x7FFFFFFF >> (indexToCheck - m_actRunStartIndex));
+
+                if ( bits != 0 )
                 {
-                    u_int32_t maska = 0x40000000 >> (indexToCheck % 31);
+                    indexToCheck = m_actRunStartIndex + __builtin_clz(bits) - 1;
 
-                    /* if the one is found */
-                    if ( (*m_iterator & maska) == maska )
-                    {
-                        m_lastOneIndex = indexToCheck;
-                        return m_lastOneIndex;
-                    }
+                    /* if end index is reached, return */
+                    if ( indexToCheck >= (int32_t)m_stopIndex )
+                        break;
 
-                    /* the one is not found, try next index */
-                    if ( ++indexToCheck >= (int32_t)m_stopIndex )
-                    {
-                        /* if end index is reached, return */
-                        m_reachedEnd = true;
-                        return -1;
-                    }
+                    m_lastOneIndex = indexToCheck;
+                    return m_lastOneIndex;
+                }
+
+                /* the one is not found, go to next word */
+                if ( (indexToCheck = m_actRunEndIndex + 1) >= (int32_t)m_stopIndex )
+                {
+                    /* if end index is reached, return */
+                    m_reachedEnd = true;
+                    return -1;
                 }
                 continue;
             }
         }
 
         /* vector is checked, search in active word */
-        while ( indexToCheck < (int32_t)m_vectorSize )
+        if ( (m_iterator >= m_iterEnd) && (indexToCheck < (int32_t)m_vectorSize) )
         {
-            u_int32_t maska = 0x80000000 >> (indexToCheck % 31);
+            u_int32_t activeWordStartIndex = m_vectorSize - m_activeWordBitsCnt;
+            u_int32_t bits = m_activeWordValue & (0xFFFFFFFF >> (indexToCheck - activeWordStartIndex));
 
-            /* one was found */
-            if ( (m_activeWordValue & maska) == maska )
+            if ( bits != 0 )
             {
-                m_lastOneIndex = indexToCheck;
-                return m_lastOneIndex;
-            }
+                indexToCheck = activeWordStartIndex + __builtin_clz(bits);
 
-            /* one is not found, try next index */
-            if ( ++indexToCheck >= (int32_t)m_stopIndex )
-                break;
+                /* one was found */
+                if ( (indexToCheck < (int32_t)m_stopIndex) && (indexToCheck < (int32_t)m_vectorSize) )
+                {
+                    m_lastOneIndex = indexToCheck;
+                    return m_lastOneIndex;
+                }
+            }
         }
 
         /* if this is reached, no one has been found and this is the end */
@@ -690,6 +1022,228 @@ int32_t WAHBitVector::OnesIterator::next()
     return -1;
 }
 
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores positions of following ones in the vector to passed array.
+ *
+ * Positions in FILL of ones are stored at once, ones of LITERALs are found by counting leading zeroes.
+ *
+ * @param out pointer to the array where positions are stored.
+ * @param maxCount maximum number of stored positions (size of the array).
+ * @return number of stored positions. If it is zero, there is no next one.
+ */
+size_t WAHBitVector::OnesIterator::nextBatch(int32_t* out, size_t maxCount)
+{
+    size_t count = 0;
+
+    while ( count < maxCount )
+    {
+        int32_t indexToCheck = m_lastOneIndex + 1;
+
+        /* the checked index is in FILL of ones --> store the rest of FILL */
+        if ( !m_reachedEnd && (m_iterator < m_iterEnd) && (*m_iterator >= 0xC0000000) && (indexToCheck <= m_actRunEndIndex) )
+        {
+            int32_t lastIndex = (m_actRunEndIndex < (int32_t)m_stopIndex) ? m_actRunEndIndex : ((int32_t)m_stopIndex - 1);
+
+            while ( (indexToCheck <= lastIndex) && (count < maxCount) )
+                out[count++] = indexToCheck++;
+
+            m_lastOneIndex = indexToCheck - 1;
+
+            if ( indexToCheck <= lastIndex )
+                break;
+        }
+
+        int32_t index = next();
+        if ( index == -1 )
+            break;
+
+        out[count++] = index;
+    }
+
+    return count;
+}
+
+/********************************************************/
+/************ IMPLEMENTATION OF AndIterator *************/
+/********************************************************/
+
+/**
+ * Class constructor.
+ *
+ * The only meaningful way how to acquire the object of class AndIterator is by the method
+ * WAHBitVector::getAndIterator().
+ *
+ * @param vectors array of pointers to the vectors of the same size.
+ * @param numOfVectors number of vectors in the array (at least one).
+ * @param stopIndex end index to which we want to search ones (not included), at most the size of vectors.
+ */
+WAHBitVector::AndIterator::AndIterator(const WAHBitVector* const* vectors, size_t numOfVectors, u_int32_t stopIndex) : m_runs(numOfVectors),
+              m_activeWordValue(0xFFFFFFFF),
+              m_stopIndex(stopIndex),
+              m_wordStartIndex(0),
+              m_nextWordStartIndex(0),
+              m_word(0),
+              m_activeWordDone(false)
+{
+    for ( size_t i = 0; i < numOfVectors; ++i )
+    {
+        m_runs[i] = WAHBitVector::VectorRun(vectors[i]->m_vec.begin(), vectors[i]->m_vec.end());
+        m_activeWordValue &= vectors[i]->m_activeWordValue;
+    }
+
+    /* bit on index 0 of active word is MSB, bit on index 0 of LITERAL is the bit 30 */
+    m_activeWordValue >>= 1;
+    m_runsDone = m_runs[0].isExhausted();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method decodes the following 31bit word of the AND of vectors.
+ *
+ * FILLs of zeroes are skipped at once. If FILL of zeroes reaches the end of some vector,
+ * only active word is left.
+ *
+ * @return TRUE - if some word was decoded (it can contain only zeroes).
+ *         FALSE - if there is no word before the stop index.
+ */
+bool WAHBitVector::AndIterator::nextWord()
+{
+    m_wordStartIndex = m_nextWordStartIndex;
+    m_word = 0;
+
+    if ( m_wordStartIndex >= m_stopIndex )
+        return false;
+
+    if ( m_runsDone )
+    {
+        if ( m_activeWordDone )
+            return false;
+
+        m_activeWordDone = true;
+        m_word = m_activeWordValue;
+        return true;
+    }
+
+    u_int32_t word = 0x7FFFFFFF;
+    u_int32_t zeroWords = 0;        /* the longest FILL of zeroes */
+    bool zeroesToEnd = false;
+
+    for ( size_t i = 0; i < m_runs.size(); ++i )
+    {
+        if ( m_runs[i].m_wordsCount == 0 )
+        {
+            m_runs[i].decodeRun();
+            ++m_runs[i].m_iterator;
+        }
+
+        if ( m_runs[i].m_isFill && (m_runs[i].m_word == 0) )
+        {
+            zeroWords = (m_runs[i].m_wordsCount > zeroWords) ? m_runs[i].m_wordsCount : zeroWords;
+            zeroesToEnd = zeroesToEnd || (m_runs[i].m_iterator == m_runs[i].m_iterEnd);
+        }
+
+        word &= m_runs[i].m_word;
+    }
+
+    if ( zeroWords > 0 )
+    {
+        m_nextWordStartIndex += 31 * zeroWords;
+
+        if ( zeroesToEnd )
+        {
+            m_runsDone = true;
+            return true;
+        }
+
+        for ( size_t i = 0; i < m_runs.size(); ++i )
+            m_runs[i].skipWords(zeroWords);
+    }
+    else
+    {
+        m_word = word;
+        m_nextWordStartIndex += 31;
+
+        for ( size_t i = 0; i < m_runs.size(); ++i )
+            --m_runs[i].m_wordsCount;
+    }
+
+    m_runsDone = m_runs[0].isExhausted();
+    return true;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method returns the position of next one in the AND of vectors.
+ *
+ * @return index of the next one. If there is no next one found, returns -1.
+ */
+int32_t WAHBitVector::AndIterator::next()
+{
+    while ( m_word == 0 )
+    {
+        if ( !nextWord() )
+            return -1;
+    }
+
+    u_int32_t bit = __builtin_clz(m_word) - 1;      /* index 0 is the bit 30 of the word */
+    u_int32_t index = m_wordStartIndex + bit;
+
+    if ( index >= m_stopIndex )
+    {
+        m_word = 0;
+        m_nextWordStartIndex = m_stopIndex;
+        return -1;
+    }
+
+    m_word &= ~(0x40000000 >> bit);
+
+    return index;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method stores positions of following ones in the AND of vectors to passed array.
+ *
+ * @param out pointer to the array where positions are stored.
+ * @param maxCount maximum number of stored positions (size of the array).
+ * @return number of stored positions. If it is zero, there is no next one.
+ */
+size_t WAHBitVector::AndIterator::nextBatch(int32_t* out, size_t maxCount)
+{
+    size_t count = 0;
+
+    while ( count < maxCount )
+    {
+        if ( m_word == 0 )
+        {
+            if ( !nextWord() )
+                break;
+
+            continue;
+        }
+
+        u_int32_t bit = __builtin_clz(m_word) - 1;      /* index 0 is the bit 30 of the word */
+        u_int32_t index = m_wordStartIndex + bit;
+
+        if ( index >= m_stopIndex )
+        {
+            m_word = 0;
+            m_nextWordStartIndex = m_stopIndex;
+            break;
+        }
+
+        m_word &= ~(0x40000000 >> bit);
+        out[count++] = index;
+    }
+
+    return count;
+}
+
 /*****************************************************/
 /************ IMPLEMENTATION OF VectorRun ************/
 /*****************************************************/
@@ -739,6 +1293,29 @@ void WAHBitVector::VectorRun::decodeRun()
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Method skips passed number of 31bit words, decoding following RUNs if necessary.
+ *
+ * @param numOfWords number of skipped words. The vector has to contain at least so many not processed words.
+ */
+void WAHBitVector::VectorRun::skipWords(u_int32_t numOfWords)
+{
+    while ( numOfWords > 0 )
+    {
+        if ( m_wordsCount == 0 )
+        {
+            decodeRun();
+            ++m_iterator;
+        }
+
+        u_int32_t skipped = (m_wordsCount < numOfWords) ? m_wordsCount : numOfWords;
+        m_wordsCount -= skipped;
+        numOfWords -= skipped;
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
 /**
  * Method retuns value representing if is the vector exhausted.
  *
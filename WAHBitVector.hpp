@@ -45,12 +45,38 @@ class WAHBitVector
         u_int32_t m_activeWordValue;        /** Variable containing the value of active word */
         u_int32_t m_activeWordBitsCnt;      /** Variable containing the number of valid bits in active word */
 
+        std::vector<u_int32_t> m_scratch;   /** Buffer for results of logical operations, swapped with m_vec (memory of both is reused) */
+
+        /**
+         * Structure representing one entry of the skip index.
+         */
+        struct SkipEntry
+        {
+            u_int32_t m_wordPos;        /** Position of the indexed 32bit word in m_vec */
+            u_int32_t m_startIndex;     /** Index of the first bit coded by the indexed word */
+        };
+
+        std::vector<SkipEntry> m_skipIndex; /** Skip index of every SKIP_INTERVAL-th word of m_vec, used by set() and get() */
+        bool m_skipIndexValid;              /** Flag set if the skip index corresponds to the content of m_vec */
+
+        static const u_int32_t SKIP_INTERVAL = 64;     /** Number of 32bit words between two entries of the skip index */
+        static const u_int32_t TAIL_RUNS = 2;          /** Number of RUNs at the end of the vector tried by set() before the skip index */
+        static const size_t MAX_AND_VECTORS = 8;       /** Maximum number of vectors decoded simultaneously by andMany() */
+
+        u_int32_t findRun(const u_int32_t index, u_int32_t& runStartIndex);
+        void rebuildSkipIndex();
+        void shiftSkipIndex(const u_int32_t wordPos, const u_int32_t numOfWords);
+
     public:
         class OnesIterator;         /** forward declaration of class OnesIterator */
+        class AndIterator;          /** forward declaration of class AndIterator */
             
         WAHBitVector(const u_int32_t size, bool setBit = false);
+        WAHBitVector(const WAHBitVector& vector);
         virtual ~WAHBitVector() { };
 
+        void reset(bool fillBit = false);
+
         void set(const u_int32_t index) throw(Exception);
         bool get(const u_int32_t index) throw(Exception);
         u_int32_t size();
@@ -64,6 +90,11 @@ class WAHBitVector
         WAHBitVector& operator |= (const WAHBitVector& vector2);
         WAHBitVector& operator &= (const WAHBitVector& vector2);
 
+        static void andInto(WAHBitVector& dst, const WAHBitVector& vector1, const WAHBitVector& vector2);
+        static void orInto(WAHBitVector& dst, const WAHBitVector& vector1, const WAHBitVector& vector2);
+        static void andMany(WAHBitVector& dst, const WAHBitVector* const* vectors, size_t numOfVectors);
+        static AndIterator getAndIterator(const WAHBitVector* const* vectors, size_t numOfVectors, const u_int32_t stopIndex) throw(Exception);
+
         /**
          * Class OnesIterator represents the iterator of bit vector WAHBitVector which iterates through set bits.
          *
@@ -92,6 +123,7 @@ class WAHBitVector
                 OnesIterator(std::vector<u_int32_t>::const_iterator begin, std::vector<u_int32_t>::const_iterator end, u_int32_t awValue, u_int32_t awBits, u_int32_t size, u_int32_t stopIndex, u_int32_t startIndex = 0);
                 ~OnesIterator() { };
                 int32_t next();
+                size_t nextBatch(int32_t* out, size_t maxCount);
         };
 
     protected:
@@ -108,18 +140,48 @@ class WAHBitVector
          class VectorRun
          {
              public:
-                 const std::vector<u_int32_t>::const_iterator m_iterEnd;
+                 std::vector<u_int32_t>::const_iterator m_iterEnd;              /** Iterator pointing to the end of the vector of 32bit words */
                  std::vector<u_int32_t>::const_iterator m_iterator;             /** Iterator of 32bit words of WAH bit vector */
                  u_int32_t m_word;           /** One word (31bit) representation of "FILL" or "LITERAL" */
                  u_int32_t m_wordsCount;     /** Number of words coded in actual "RUN" */
                  bool m_isFill;              /** Is actual RUN a FILL? */
 
+                 VectorRun() : m_wordsCount(0) { };
                  VectorRun(std::vector< u_int32_t>::const_iterator begin, std::vector< u_int32_t>::const_iterator end);
                  void decodeRun();
+                 void skipWords(u_int32_t numOfWords);
                  bool isExhausted();
                  static void appendLiteral(std::vector<u_int32_t>& vec, u_int32_t value);
                  static void appendFill(std::vector<u_int32_t>& vec, u_int32_t numOfRuns, u_int32_t fillBit);
           };
 };
 
+/**
+ * Class AndIterator represents the iterator through set bits of logical AND of several WAHBitVector-s.
+ *
+ * RUNs of all vectors are decoded simultaneously like in WAHBitVector::andMany(), but set bits
+ * of the result are returned directly, so the result is never stored in a vector. Words after
+ * the stop index are not decoded at all.
+ */
+class WAHBitVector::AndIterator
+{
+    private:
+        std::vector<VectorRun> m_runs;      /** Decoded RUNs of all vectors */
+        u_int32_t m_activeWordValue;        /** AND of active words of all vectors, shifted to bits of LITERAL */
+        const u_int32_t m_stopIndex;        /** Variable containing the value of end index to which we search set bits (not included) */
+        u_int32_t m_wordStartIndex;         /** Variable containing first index of the current word */
+        u_int32_t m_nextWordStartIndex;     /** Variable containing first index of the following word */
+        u_int32_t m_word;                   /** Not yet returned set bits of the current word (LITERAL) */
+        bool m_runsDone;                    /** Flag set if all words before active word were decoded */
+        bool m_activeWordDone;              /** Flag set if active word was already used */
+
+        bool nextWord();
+
+    public:
+        AndIterator(const WAHBitVector* const* vectors, size_t numOfVectors, u_int32_t stopIndex);
+        ~AndIterator() { };
+        int32_t next();
+        size_t nextBatch(int32_t* out, size_t maxCount);
+};
+
 #endif /* WAHBIT_VECTOR_H_832789326782748484924874678234 */
\ No newline at end of file
@@ -207,47 +207,40 @@ int XmlInputParser::parseAction(char* string)
 /**
  * Method parses passed input stream and returns a ector of parsed ACLs wit their rules.
  *
+ * The whole stream is read into InputBuffer and parsed by parse(InputBuffer&).
+ *
  * @throw Exception when error occures, method throws exception.
  * @param inputStream reference to input stream std::istream containing input configuration.
  * @return smart pointer containing pointer to vector of ACLs with their rules.
  */
 std::auto_ptr< boost::ptr_vector< AccessControlList > > XmlInputParser::parse(std::istream& inputStream) throw(Exception)
+{
+    auto_ptr< InputBuffer > input = InputBuffer::fromStream(inputStream);
+
+    return parse(*input);
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Method parses XML configuration held by passed buffer and returns a vector of parsed ACLs with their rules.
+ *
+ * The buffer is parsed in-situ by rapidxml, so its data are modified and strings of the DOM tree
+ * point directly into the buffer (for the mapped file only touched pages are copied).
+ *
+ * @throw Exception when error occures, method throws exception.
+ * @param input reference to the buffer containing input configuration.
+ * @return smart pointer containing pointer to vector of ACLs with their rules.
+ */
+std::auto_ptr< boost::ptr_vector< AccessControlList > > XmlInputParser::parse(InputBuffer& input) throw(Exception)
 {
     /* use smart vector to store address and control allocated memory */
     auto_ptr< boost::ptr_vector< AccessControlList > > aclsVector(new boost::ptr_vector< AccessControlList >);
-    unsigned long inputFileLength = 0;
-    
-    /* get the size of input XML */
-    inputStream.seekg (0, ios_base::end);
-    inputFileLength = inputStream.tellg();      /* get the position of the offset in stream (the size of the stream) */
-    inputStream.seekg (0, ios_base::beg);
-    inputFileLength++;                          /* for appending "/0" */
 
     #ifdef XML_PARSER_DEBUG
-    cerr << endl << "DEBUG: Input length= " << inputFileLength << endl;
+    cerr << endl << "DEBUG: Input length= " << input.size() << endl;
     #endif
 
-    /* if the stream contains less than one character */
-    if ( inputFileLength < 1 )
-        throw Exception("Cannot parse input file! File is empty!");
-
-    /*************************************************/
-    /* allocation of the buffer for reading the file */
-    char* tmp = NULL;
-    if ( (tmp = new char[inputFileLength]) == NULL )
-    {
-        cerr << "ERROR-XmlInputParser: Not enough memory to alocate buffer for input XML file!";
-        #ifdef DEBUG
-        cerr << " (file:" << __FILE__ << ",line:" << __LINE__ << ")";
-        #endif
-        cerr << endl;
-
-        throw Exception("Parsing of input file failed!");
-    }
-
-    inputStream.read(tmp, (inputFileLength - 1));      /* reading the input from stream to the buffer */
-    tmp[inputFileLength - 1] = '\0';                   /* append NULL for RapidXML parser */
-
     /* pointers necessary for working with parsed XML file */
     xml_document< > xmlParsedDoc;
     xml_node< >* tmp_accessListNode = NULL;
@@ -256,7 +249,7 @@ std::auto_ptr< boost::ptr_vector< AccessControlList > > XmlInputParser::parse(st
     /**************************************/
     /* parsing the buffer to DOM XML tree */
     try {
-        xmlParsedDoc.parse<0>(tmp);
+        xmlParsedDoc.parse<0>(input.data());
     }
     catch (parse_error e)
     {
@@ -268,7 +261,6 @@ std::auto_ptr< boost::ptr_vector< AccessControlList > > XmlInputParser::parse(st
         #endif
         cerr << endl;
 
-        delete[](tmp);
         
         throw Exception("Parsing of input file failed!");
     }
@@ -310,8 +302,7 @@ std::auto_ptr< boost::ptr_vector< AccessControlList > > XmlInputParser::parse(st
               tmpRuleNode != NULL;
               ++pos, tmpRuleNode = tmpRuleNode->next_sibling("ecm:rule") )
         {
-            AclRule* newRule = new AclRule(pos);
-            newAcl->pushBack(newRule);
+            auto_ptr< AclRule > newRule(new AclRule(pos));
             IP_ADDRESS tmpIp1;
             IP_ADDRESS tmpIp2;
             
@@ -325,11 +316,12 @@ std::auto_ptr< boost::ptr_vector< AccessControlList > > XmlInputParser::parse(st
             /* destination IP */
             XmlInputParser::parseIpRange(tmpIp1, tmpIp2, tmpRuleNode->first_attribute("destination")->value());
             newRule->setDstIP(tmpIp1, tmpIp2);
+
+            newAcl->pushBack(newRule.release());    /* add the complete rule to ACL */
         }
     }
 
     xmlParsedDoc.clear();       /* delete the DOM tree of the XML file */
-    delete[](tmp);
     
     return aclsVector;
 }
\ No newline at end of file
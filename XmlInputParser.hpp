@@ -41,6 +41,7 @@ class XmlInputParser : public InputParser
         
     public:
         virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(std::istream& inputStream) throw(Exception);
+        virtual std::auto_ptr< boost::ptr_vector< AccessControlList > > parse(InputBuffer& input) throw(Exception);
 };
 
 #endif /* XML_INPUTPARSER_H__89723645878378901287845879128767357829338 */
\ No newline at end of file
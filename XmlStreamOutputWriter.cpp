@@ -0,0 +1,316 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "XmlStreamOutputWriter.hpp"
+
+using namespace std;
+
+/**
+ * Class constructor.
+ *
+ * The XML declaration and the start of the root element are formatted immediately.
+ *
+ * @param outputStream reference to the output stream to which the XML document will be written.
+ * @param outputDetail value representing output data detail level (constant OUTPUT_DETAIL_X).
+ */
+XmlStreamOutputWriter::XmlStreamOutputWriter(std::ostream& outputStream, int outputDetail) : OutputWriter(outputStream, outputDetail),
+                                                                                            m_aclOpened(false),
+                                                                                            m_aclEmpty(false),
+                                                                                            m_docEmpty(true),
+                                                                                            m_finished(false)
+{
+    m_buffer.reserve(BUFFER_SIZE + 4096);
+
+    m_buffer += "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<AclCheck-analysis";
+    appendAttribute("output-detail", outDetailToString());
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Class destructor.
+ */
+XmlStreamOutputWriter::~XmlStreamOutputWriter() { }
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method appends the attribute with given value to the buffer.
+ *
+ * Value is quoted and escaped in the same way as by rapidxml printer: double quotes
+ * are used, unless the value contains them.
+ *
+ * @param name pointer to the string containing name of the attribute.
+ * @param value reference to the string containing value of the attribute.
+ */
+void XmlStreamOutputWriter::appendAttribute(const char* name, const std::string& value)
+{
+    char quote = (value.find('"') == string::npos) ? '"' : '\'';
+
+    m_buffer += ' ';
+    m_buffer += name;
+    m_buffer += '=';
+    m_buffer += quote;
+
+    size_t size = value.size();
+    for ( size_t i = 0; i < size; ++i )
+    {
+        char c = value[i];
+
+        /* character of the other quote type is not expanded */
+        if ( ((c == '"') || (c == '\'')) && (c != quote) )
+        {
+            m_buffer += c;
+            continue;
+        }
+
+        switch ( c )
+        {
+            case '<':
+                m_buffer += "&lt;";
+                break;
+
+            case '>':
+                m_buffer += "&gt;";
+                break;
+
+            case '\'':
+                m_buffer += "&apos;";
+                break;
+
+            case '"':
+                m_buffer += "&quot;";
+                break;
+
+            case '&':
+                m_buffer += "&amp;";
+                break;
+
+            default:
+                m_buffer += c;
+        }
+    }
+
+    m_buffer += quote;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method appends the element of one rule of the conflict to the buffer.
+ *
+ * Attributes of the rule depend on choosen detail level, ports are written
+ * from OUTPUT_DETAIL_3 and only for TCP and UDP rules.
+ *
+ * @param element pointer to the string containing name of the element ("ruleX" or "ruleY").
+ * @param rule reference to the rule.
+ */
+void XmlStreamOutputWriter::appendRule(const char* element, const AclRule& rule)
+{
+    m_buffer += "\t\t\t<";
+    m_buffer += element;
+    appendAttribute("name", rule.getName());
+
+    if ( m_outputDetail >= OUTPUT_DETAIL_2 )
+    {
+        bool hasPorts = (m_outputDetail >= OUTPUT_DETAIL_3) && ((rule.getProtocol() == PROTO_TCP) || (rule.getProtocol() == PROTO_UDP));
+
+        appendAttribute("proto", rule.getProtocolString());
+        appendAttribute("srcIP", rule.getSrcIpRangeString());
+        if ( hasPorts )
+            appendAttribute("srcPort", rule.getSrcPortRangeString());
+        if ( m_outputDetail >= OUTPUT_DETAIL_3 )
+            appendAttribute("dstIP", rule.getDstIpRangeString());
+        if ( hasPorts )
+            appendAttribute("dstPort", rule.getDstPortRangeString());
+        appendAttribute("action", rule.getActionString());
+    }
+
+    m_buffer += "/>\n";
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method appends the element with relations of dimensions of the conflict to the buffer.
+ *
+ * @param confl reference to the object representing the conflict.
+ */
+void XmlStreamOutputWriter::appendRelations(const Conflict& confl)
+{
+    m_buffer += "\t\t\t<relation";
+    appendAttribute("proto", Conflict::relationTypeToString(confl.getDimensionsRelation(DIMENSION_PROTO)));
+    appendAttribute("srcIP", Conflict::relationTypeToString(confl.getDimensionsRelation(DIMENSION_SRC_IP)));
+    appendAttribute("srcPort", Conflict::relationTypeToString(confl.getDimensionsRelation(DIMENSION_SRC_PRT)));
+    appendAttribute("dstIP", Conflict::relationTypeToString(confl.getDimensionsRelation(DIMENSION_DST_IP)));
+    appendAttribute("dstPort", Conflict::relationTypeToString(confl.getDimensionsRelation(DIMENSION_DST_PRT)));
+    m_buffer += "/>\n";
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method finishes the element of the actual ACL, if there is any.
+ *
+ * ACL without conflicts is written as the empty element.
+ */
+void XmlStreamOutputWriter::closeAcl()
+{
+    if ( !m_aclOpened )
+        return;
+
+    if ( m_aclEmpty )
+        m_buffer += "/>\n";
+    else
+        m_buffer += "\t</access-list>\n";
+
+    m_aclOpened = false;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method writes the content of the buffer to the output stream and clears the buffer.
+ */
+void XmlStreamOutputWriter::writeBuffer()
+{
+    m_outStream.write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method converting seted detail value to a string.
+ *
+ * @return string containing numeric value representing the data detail level.
+ */
+string XmlStreamOutputWriter::outDetailToString()
+{
+    switch ( m_outputDetail )
+    {
+        case OUTPUT_DETAIL_1:
+            return "1";
+
+        case OUTPUT_DETAIL_2:
+            return "2";
+
+        case OUTPUT_DETAIL_3:
+            return "3";
+
+        case OUTPUT_DETAIL_4:
+            return "4";
+
+        default:
+            return "unknown";
+    }
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method for writing a new ACL with given name (ID).
+ *
+ * The element of the previous ACL is finished and the following new conflicts
+ * are written into the element of the new ACL.
+ *
+ * @param aclID reference to a string containing name (ID) of the ACL.
+ */
+void XmlStreamOutputWriter::writeNewACL(std::string aclID)
+{
+    if ( m_finished )
+        return;
+
+    closeAcl();
+
+    if ( m_docEmpty )
+    {
+        m_buffer += ">\n";
+        m_docEmpty = false;
+    }
+
+    m_buffer += "\t<access-list";
+    appendAttribute("id", aclID);
+
+    m_aclOpened = true;
+    m_aclEmpty = true;
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method for writing new conflict under the actual ACL.
+ *
+ * Content of the conflict depends on choosen detail level (see OUTPUT_DETAIL_X).
+ *
+ * @param confl reference to the object containing conflict data.
+ */
+void XmlStreamOutputWriter::writeNewConflict(const Conflict& confl)
+{
+    if ( m_finished )
+        return;
+
+    if ( !m_aclOpened )
+        writeNewACL("no-id");
+
+    if ( m_aclEmpty )
+    {
+        m_buffer += ">\n";
+        m_aclEmpty = false;
+    }
+
+    m_buffer += "\t\t<conflict";
+    appendAttribute("type", confl.conflictTypeStr());
+    m_buffer += ">\n";
+
+    appendRule("ruleX", confl.getRuleXRef());
+    appendRule("ruleY", confl.getRuleYRef());
+
+    if ( m_outputDetail == OUTPUT_DETAIL_4 )
+        appendRelations(confl);
+
+    m_buffer += "\t\t</conflict>\n";
+
+    if ( m_buffer.size() >= BUFFER_SIZE )
+        writeBuffer();
+}
+
+//-----------------------------------------------------------------------------------
+
+/**
+ * Method finishes the XML document and writes the rest of it to the output stream given in constructor.
+ *
+ * Conflicts written after the document is finished are ignored.
+ */
+void XmlStreamOutputWriter::flush()
+{
+    if ( !m_finished )
+    {
+        closeAcl();
+
+        if ( m_docEmpty )
+            m_buffer += "/>\n\n";
+        else
+            m_buffer += "</AclCheck-analysis>\n\n";
+
+        m_finished = true;
+    }
+
+    writeBuffer();
+    m_outStream.flush();
+}
@@ -0,0 +1,63 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <string>
+
+#include "OutputWriter.hpp"
+
+#ifndef XML_STREAM_OUTPUTWRITER_HPP__8305716294058317462093857160293847561029384756
+#define XML_STREAM_OUTPUTWRITER_HPP__8305716294058317462093857160293847561029384756
+
+/**
+ * Class XmlStreamOutputWriter writes the XML document of the analysis while conflicts are found.
+ *
+ * Produced document is the same as the document of XmlOutputWriter (including indenting and
+ * escaping of rapidxml printer), but no DOM is built. Every conflict is formatted into the
+ * buffer, which is written to the output stream whenever it exceeds BUFFER_SIZE bytes, so the
+ * memory does not grow with the number of conflicts. The document is finished by flush().
+ */
+class XmlStreamOutputWriter : public OutputWriter
+{
+    private:
+        static const size_t BUFFER_SIZE = 64 * 1024;     /** Size of the buffer after which it is written to the stream. */
+
+        std::string m_buffer;       /** Buffer with formatted data not written to the stream yet. */
+        bool m_aclOpened;           /** Flag set if an element of the ACL was started. */
+        bool m_aclEmpty;            /** Flag set if the started element of the ACL has no conflict yet. */
+        bool m_docEmpty;            /** Flag set if the root element has no ACL yet. */
+        bool m_finished;            /** Flag set if the document was finished by flush(). */
+
+    protected:
+        void appendAttribute(const char* name, const std::string& value);
+        void appendRule(const char* element, const AclRule& rule);
+        void appendRelations(const Conflict& confl);
+        void closeAcl();
+        void writeBuffer();
+
+        std::string outDetailToString();
+
+    public:
+        XmlStreamOutputWriter(std::ostream& outputStream, int outputDetail = OUTPUT_DETAIL_2);
+        virtual ~XmlStreamOutputWriter();
+
+        virtual void writeNewACL(std::string aclID);
+        virtual void writeNewConflict(const Conflict& confl);
+        virtual void flush();
+};
+
+#endif /* XML_STREAM_OUTPUTWRITER_HPP__8305716294058317462093857160293847561029384756 */
@@ -0,0 +1,363 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/* Benchmark comparing the analysis using compressed (WAHBitVector), non-compressed
+ * (PlainBitVector) and container (RoaringBitVector) bit vectors in prefix trees on ACLs in ClassBench format
+ * (e.g. testing_ACLs/performance sets).
+ */
+
+#include <unistd.h>
+#include <sys/time.h>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+
+#include "ClassBenchInputParser.hpp"
+#include "AccessControlList.hpp"
+#include "AclAnalyzer.hpp"
+#include "OutputWriter.hpp"
+
+using namespace std;
+
+/**
+ * Class BenchOutputWriter is an output writer which only counts written conflicts.
+ */
+class BenchOutputWriter : public OutputWriter
+{
+    private:
+        unsigned long m_numOfConflicts;     /** Number of written conflicts. */
+
+    public:
+        BenchOutputWriter() : OutputWriter(cout), m_numOfConflicts(0) { };
+        virtual ~BenchOutputWriter() { };
+
+        virtual void writeNewACL(std::string aclID) { };
+        virtual void writeNewConflict(const Conflict& confl) { ++m_numOfConflicts; };
+        virtual void flush() { };
+
+        unsigned long getNumOfConflicts() const { return m_numOfConflicts; };
+};
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Print program usage.
+ *
+ * @param prog pointer to string containing program name.
+ */
+static void usage(char* prog)
+{
+    cout << "PROGRAM USAGE:" << endl;
+    cout << prog << " [-r <repetitions>] [-f] [-s] [-m] [-l] [-d <dimension_index>] <input_file> [<input_file> ...]" << endl;
+    cout << " <input_file>\t\tFile with ACL in ClassBench format." << endl;
+    cout << " -r <repetitions>\tNumber of repetitions of each analysis, the best time is printed." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, every analysis is run once." << endl;
+    cout << " -f\t\t\tCompare all dimensions of every pair of rules (no short-circuit classification)." << endl;
+    cout << " -s\t\t\tPrint numbers of disjoint and tested pairs of rules per dimension in the final" << endl;
+    cout << "\t\t\torder of the short-circuit classification." << endl;
+    cout << " -m\t\t\tReorder rules by reverse specificity (most specific rules first), so short" << endl;
+    cout << "\t\t\tprefixes are added to prefix trees after all longer ones." << endl;
+    cout << " -l\t\t\tBuild prefix trees from all rules at once before the analysis (bulk load)." << endl;
+    cout << " -d <dimension_index>\tStructure used for dimensions: \"binary\" (default), \"patricia\", \"multibit\"," << endl;
+    cout << "\t\t\t\"multibit16\" or \"tables\"." << endl << endl;
+    cout << "Printed columns: file, number of rules, measured density, estimated memory of non-compressed" << endl;
+    cout << "bit vectors [MB], class selected by \"auto\", times with \"wah\", \"plain\"" << endl;
+    cout << "and \"roaring\" [s], number of conflicts, number of nodes of all dimensions." << endl;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Function returns the name of passed dimension (as used in the XML output).
+ *
+ * @param dimension constant DIMENSION_XXX.
+ * @return name of the dimension.
+ */
+static const char* dimensionToString(int dimension)
+{
+    static const char* const names[DIMENSION_MAX + 1] = { "proto", "srcIP", "dstIP", "srcPort", "dstPort" };
+
+    return names[dimension];
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Structure representing the position of the rule and the sum of lengths of its prefixes.
+ */
+typedef struct rule_specificity {
+    unsigned specificity;   /** Sum of lengths of prefixes of all dimensions. */
+    size_t position;        /** Position of the rule in the original ACL. */
+
+    bool operator < (const struct rule_specificity& other) const { return specificity > other.specificity; };
+} RULE_SPECIFICITY;
+
+/**
+ * Function creates the copy of passed ACL with rules ordered by reverse specificity.
+ *
+ * Rules with longer prefixes are placed first (rules with equal specificity keep their order),
+ * so every short prefix is added to prefix trees after all longer prefixes below it.
+ *
+ * @param acl reference to the original ACL.
+ * @return smart pointer with the reordered ACL.
+ */
+static auto_ptr< AccessControlList > reverseSpecificity(const AccessControlList& acl)
+{
+    vector< RULE_SPECIFICITY > order(acl.size());
+
+    for ( size_t i = 0; i < acl.size(); ++i )
+    {
+        order[i].specificity = 0;
+        order[i].position = i;
+
+        for ( int dimension = DIMENSION_MIN; dimension <= DIMENSION_MAX; ++dimension )
+            order[i].specificity += acl[i].getFieldPrefix(dimension).length;
+    }
+
+    stable_sort(order.begin(), order.end());
+
+    auto_ptr< AccessControlList > reordered(new AccessControlList(acl.name()));
+
+    for ( size_t i = 0; i < order.size(); ++i )
+    {
+        const AclRule& rule = acl[order[i].position];
+        AclRule* newRule = new AclRule(i, rule.getName());
+
+        newRule->setProtocol(rule.getProtocol());
+        newRule->setSrcIP(rule.getSrcIpStart(), rule.getSrcIpStop());
+        newRule->setDstIP(rule.getDstIpStart(), rule.getDstIpStop());
+        newRule->setSrcPort(rule.getSrcPortStart(), rule.getSrcPortStop(), rule.getSrcPortNeg());
+        newRule->setDstPort(rule.getDstPortStart(), rule.getDstPortStop(), rule.getDstPortNeg());
+        newRule->setAction(rule.getAction());
+
+        reordered->pushBack(newRule);
+    }
+
+    return reordered;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Function returns the time of the analysis of passed ACL using passed class of bit vectors.
+ *
+ * @throw Exception if the analysis fails.
+ * @param acl reference to the analysed ACL.
+ * @param bitVectorType class of bit vectors (constant BITVECTOR_XXX).
+ * @param classifyMode mode of the classification of conflicts (constant CLASSIFY_XXX).
+ * @param indexType structure used for dimensions (constant INDEX_XXX).
+ * @param insertionMode mode of inserting rules into prefix trees (constant INSERTION_XXX).
+ * @param repetitions number of repetitions of the analysis.
+ * @param conflicts reference to the variable where the number of found conflicts is stored.
+ * @param selectivity reference to the structure where the selectivity of dimensions is stored.
+ * @param nodes reference to the variable where the number of nodes of all dimensions is stored.
+ * @return the best time of the analysis in seconds.
+ */
+static double timeAnalysis(const AccessControlList& acl, int bitVectorType, int classifyMode, int indexType, int insertionMode, int repetitions, unsigned long& conflicts,
+                           DIMENSION_SELECTIVITY& selectivity, unsigned long& nodes) throw(Exception)
+{
+    double best = -1;
+
+    for ( int i = 0; i < repetitions; ++i )
+    {
+        BenchOutputWriter outputWriter;
+        AclAnalyzer analyzer(acl, &outputWriter, insertionMode, bitVectorType, classifyMode, indexType);
+
+        struct timeval start;
+        struct timeval stop;
+
+        gettimeofday(&start, NULL);
+        analyzer.analyse();
+        gettimeofday(&stop, NULL);
+
+        double time = (double(stop.tv_sec - start.tv_sec)) + (double(stop.tv_usec - start.tv_usec) / 1000000);
+        if ( (best < 0) || (time < best) )
+            best = time;
+
+        conflicts = outputWriter.getNumOfConflicts();
+        selectivity = analyzer.getSelectivity();
+        nodes = analyzer.getNumOfNodes();
+    }
+
+    return best;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Main function of the benchmark.
+ */
+int main(int argc, char** argv)
+{
+    int repetitions = 1;
+    int classifyMode = CLASSIFY_SHORT_CIRCUIT;
+    int indexType = INDEX_BINARY_TRIE;
+    int insertionMode = INSERTION_SEQUENTIAL;
+    bool printSelectivity = false;
+    bool reorder = false;
+    int c;
+
+    while ( (c = getopt(argc, argv, "r:fsmld:h")) != -1 )
+    {
+        switch ( c )
+        {
+            /* number of repetitions */
+            case 'r':
+                repetitions = atoi(optarg);
+                if ( repetitions < 1 )
+                {
+                    cerr << argv[0] << " ERROR: Invalid number of repetitions \"" << optarg << "\"!" << endl;
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+
+            /* classification without the short-circuit */
+            case 'f':
+                classifyMode = CLASSIFY_FULL;
+                break;
+
+            /* selectivity of dimensions */
+            case 's':
+                printSelectivity = true;
+                break;
+
+            /* reverse-specificity order of rules */
+            case 'm':
+                reorder = true;
+                break;
+
+            /* bulk load of prefix trees */
+            case 'l':
+                insertionMode = INSERTION_BULK;
+                break;
+
+            /* structure used for dimensions */
+            case 'd':
+                if ( strcmp(optarg, "binary") == 0 )
+                    indexType = INDEX_BINARY_TRIE;
+                else if ( strcmp(optarg, "patricia") == 0 )
+                    indexType = INDEX_PATRICIA_TRIE;
+                else if ( strcmp(optarg, "multibit") == 0 )
+                    indexType = INDEX_MULTIBIT_TRIE;
+                else if ( strcmp(optarg, "multibit16") == 0 )
+                    indexType = INDEX_MULTIBIT_WIDE_TRIE;
+                else if ( strcmp(optarg, "tables") == 0 )
+                    indexType = INDEX_DIRECT_TABLES;
+                else
+                {
+                    cerr << argv[0] << " ERROR: Unknown structure for dimensions \"" << optarg << "\"!" << endl;
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+
+            /* print usage */
+            case 'h':
+                usage(argv[0]);
+                return 0;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if ( optind >= argc )
+    {
+        cerr << argv[0] << " ERROR: No input file specified!" << endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    cout << "file\trules\tdensity\tplainMB\tauto\twah[s]\tplain[s]\troaring[s]\tconflicts\tnodes" << endl;
+    cout.setf(ios_base::fixed, ios_base::floatfield);
+
+    for ( int i = optind; i < argc; ++i )
+    {
+        ifstream inputFile(argv[i], ios_base::in);
+
+        if ( !inputFile.is_open() )
+        {
+            cerr << argv[0] << " ERROR: Can't open input file \"" << argv[i] << "\"!" << endl;
+            return 1;
+        }
+
+        ClassBenchInputParser parser;
+        auto_ptr< boost::ptr_vector< AccessControlList > > acls;
+
+        try {
+            acls = parser.parse(inputFile);
+
+            for ( size_t j = 0; j < acls->size(); ++j )
+            {
+                auto_ptr< AccessControlList > reordered;
+                if ( reorder )
+                    reordered = reverseSpecificity((*acls)[j]);
+
+                const AccessControlList& acl = reorder ? *reordered : (*acls)[j];
+                unsigned long wahConflicts = 0;
+                unsigned long plainConflicts = 0;
+                unsigned long roaringConflicts = 0;
+                DIMENSION_SELECTIVITY selectivity;
+                unsigned long nodes = 0;
+
+                double density = AclAnalyzer::measureDensity(acl);
+                double memory = double(AclAnalyzer::estimatePlainMemory(acl)) / (1 << 20);
+                int selected = AclAnalyzer::selectBitVectorType(acl);
+                double wahTime = timeAnalysis(acl, BITVECTOR_WAH, classifyMode, indexType, insertionMode, repetitions, wahConflicts, selectivity, nodes);
+                double plainTime = timeAnalysis(acl, BITVECTOR_PLAIN, classifyMode, indexType, insertionMode, repetitions, plainConflicts, selectivity, nodes);
+                double roaringTime = timeAnalysis(acl, BITVECTOR_ROARING, classifyMode, indexType, insertionMode, repetitions, roaringConflicts, selectivity, nodes);
+
+                cout << argv[i] << "\t" << acl.size() << "\t" << setprecision(4) << density << "\t"
+                     << setprecision(1) << memory << "\t" << ((selected == BITVECTOR_PLAIN) ? "plain" : ((selected == BITVECTOR_ROARING) ? "roaring" : "wah")) << "\t"
+                     << setprecision(3) << wahTime << "\t" << plainTime << "\t" << roaringTime << "\t" << wahConflicts << "\t" << nodes << endl;
+
+                if ( printSelectivity && (classifyMode == CLASSIFY_SHORT_CIRCUIT) )
+                {
+                    cout << "\tselectivity";
+                    for ( int k = DIMENSION_MIN; k <= DIMENSION_MAX; ++k )
+                    {
+                        int dimension = selectivity.order[k];
+                        cout << "\t" << dimensionToString(dimension) << "=" << selectivity.disjoint[dimension] << "/" << selectivity.tested[dimension];
+                    }
+                    cout << endl;
+                }
+
+                if ( (wahConflicts != plainConflicts) || (wahConflicts != roaringConflicts) )
+                {
+                    cerr << argv[0] << " ERROR: Different number of conflicts found in \"" << argv[i] << "\"!" << endl;
+                    return 1;
+                }
+            }
+        }
+        catch ( Exception& e )
+        {
+            cerr << argv[0] << " ERROR: Benchmark of file \"" << argv[i] << "\" failed!" << endl;
+            cerr << argv[0] << e.toString();
+            return 1;
+        }
+    }
+
+    return 0;
+}
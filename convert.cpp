@@ -0,0 +1,137 @@
+/*
+ * AclCheck - simple tool for static analysis of ACLs in network device configuration.
+ * Copyright (C) 2012  Tomas Hozza
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/* Converter rendering the binary report of the analysis (see BinaryOutputWriter)
+ * to the XML document with chosen detail level.
+ */
+
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+
+#include "BinaryOutputWriter.hpp"
+#include "XmlStreamOutputWriter.hpp"
+
+using namespace std;
+
+const char* DEFAULT_OUTPUT_FILE = "result.xml";
+
+/**
+ * Print program usage.
+ *
+ * @param prog pointer to string containing program name.
+ */
+static void usage(char* prog)
+{
+    cout << "PROGRAM USAGE:" << endl;
+    cout << prog << " -i <input_file> [-o <output_file>] [-1|-2|-3|-4]" << endl;
+    cout << " -i <input_file>\tBinary report written by \"aclCheck -t binary\"." << endl;
+    cout << "\t\t\tThis parameter is REQUIRED!" << endl;
+    cout << " -o <output_file>\tSet output file name with results." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, \"result.xml\" filename is used." << endl;
+    cout << " -1 ... -4\t\tDetail level of the XML output (see aclCheck -h)." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, DETAIL 2 is used." << endl << endl;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Main function of the converter.
+ */
+int main(int argc, char** argv)
+{
+    char* inputFileName = NULL;
+    const char* outputFileName = DEFAULT_OUTPUT_FILE;
+    int outputDetail = OUTPUT_DETAIL_2;
+    int c;
+
+    while ( (c = getopt(argc, argv, "i:o:1234h")) != -1 )
+    {
+        switch ( c )
+        {
+            case 'i':
+                inputFileName = optarg;
+                break;
+
+            case 'o':
+                outputFileName = optarg;
+                break;
+
+            case '1':
+                outputDetail = OUTPUT_DETAIL_1;
+                break;
+            case '2':
+                outputDetail = OUTPUT_DETAIL_2;
+                break;
+            case '3':
+                outputDetail = OUTPUT_DETAIL_3;
+                break;
+            case '4':
+                outputDetail = OUTPUT_DETAIL_4;
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 0;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if ( inputFileName == NULL )
+    {
+        cerr << argv[0] << " ERROR: No input file name specified!" << endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    ifstream inputFile(inputFileName, ios_base::in | ios_base::binary);
+    if ( !inputFile.is_open() )
+    {
+        cerr << argv[0] << " ERROR: Can't open input file \"" << inputFileName << "\"!" << endl;
+        return 1;
+    }
+
+    ofstream outputFile(outputFileName, ios_base::out | ios_base::trunc);
+    if ( !outputFile.is_open() )
+    {
+        cerr << argv[0] << " ERROR: Can't create output file!" << endl;
+        return 1;
+    }
+
+    XmlStreamOutputWriter outputWriter(outputFile, outputDetail);
+
+    try {
+        BinaryOutputWriter::convert(inputFile, outputWriter);
+    }
+    catch ( Exception& e )
+    {
+        cerr << argv[0] << " ERROR: Conversion of the binary report failed!" << endl;
+        cerr << argv[0] << e.toString();
+
+        outputWriter.flush();
+        return 1;
+    }
+
+    outputWriter.flush();
+
+    return 0;
+}
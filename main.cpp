@@ -20,12 +20,16 @@
 
 #include <unistd.h>
 #include <sys/time.h>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
 #include <memory>
 #include <iostream>
 #include <fstream>
 
 /****** INPUT MODULES ******/
 #include "InputParser.hpp"
+#include "InputBuffer.hpp"
 #include "XmlInputParser.hpp"
 #include "CiscoInputParser.hpp"
 #include "HpInputParser.hpp"
@@ -36,9 +40,12 @@
 #include "AccessControlList.hpp"
 #include "PrefixForest.hpp"
 #include "Conflict.hpp"
+#include "AclAnalyzer.hpp"
+#include "AnalysisScheduler.hpp"
 /****** OUTPUT MODULES ******/
 #include "OutputWriter.hpp"
-#include "XmlOutputWriter.hpp"
+#include "XmlStreamOutputWriter.hpp"
+#include "BinaryOutputWriter.hpp"
 
 using namespace std;
 
@@ -48,7 +55,11 @@ const int INPUT_FORMAT_JUNIPER = 3;
 const int INPUT_FORMAT_XML = 4;
 const int INPUT_FORMAT_CLASSBENCH = 5;
 
+const int OUTPUT_TYPE_XML = 1;
+const int OUTPUT_TYPE_BINARY = 2;
+
 const char* DEFAULT_OUTPUT_FILE = "result.xml";
+const char* DEFAULT_BINARY_OUTPUT_FILE = "result.bin";
 
 /**
  * Print program usage.
@@ -66,10 +77,28 @@ static void usage(char* prog)
     cout << " -i <input_file>\tSet input file with device/acl configuration." << endl;
     cout << "\t\t\tThis parameter is REQUIRED!" << endl << endl;
     cout << " -o <output_file>\tSet output file name with results." << endl;
-    cout << "\t\t\tThis parameter is optional. If not set, \"result.xml\" filename is used." << endl << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, \"result.xml\" (\"result.bin\" for binary output) filename is used." << endl << endl;
+    cout << " -t <output_type>\tSet type of the output file. Possible types are: \"xml\", \"binary\"." << endl;
+    cout << "\t\t\tBinary report contains all details and it is converted to XML by aclConvert." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, \"xml\" is used." << endl << endl;
     cout << " -f <input_format>\tSet format of input configuration file. This parameter is optional." << endl;
     cout << "\t\t\tPossible input formats are: \"cisco\", \"hp\", \"juniper\", \"xml\", \"bench\"." << endl;
     cout << "\t\t\tIf not set, \"cisco\" configuration format is used." << endl << endl;
+    cout << " -j <num_of_threads>\tSet number of threads analysing ACLs concurrently." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, ACLs are analysed by one thread." << endl << endl;
+    cout << " -p\t\t\tUpdate prefix trees of each ACL by separate threads (one per dimension)." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, prefix trees are updated sequentially." << endl << endl;
+    cout << " -l\t\t\tBuild prefix trees of each ACL from all its rules at once before the analysis (bulk load)." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, prefix trees are updated sequentially." << endl << endl;
+    cout << " -b <bit_vectors>\tSet class of bit vectors used by prefix trees." << endl;
+    cout << "\t\t\tPossible classes are: \"auto\", \"wah\" (compressed), \"plain\" (non-compressed)," << endl;
+    cout << "\t\t\t\"roaring\" (compressed by containers)." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, \"auto\" is used (selected for every ACL)." << endl << endl;
+    cout << " -d <dimension_index>\tSet structure used for dimensions of rules." << endl;
+    cout << "\t\t\tPossible structures are: \"binary\" (binary prefix trees), \"patricia\" (path-compressed prefix trees)," << endl;
+    cout << "\t\t\t\"multibit\" (multibit trees with strides 8-8-8-8 for IP addresses), \"multibit16\" (strides 16-8-8)," << endl;
+    cout << "\t\t\t\"tables\" (direct-indexed tables for protocols and ports, \"multibit\" for IP addresses)." << endl;
+    cout << "\t\t\tThis parameter is optional. If not set, \"binary\" is used." << endl << endl;
     cout << "OUTPUT FILE DETAIL OPTIONS:" << endl;
     cout << " -1\tDETAIL 1 - Output contains: conflict type; conflict rules names/positions." << endl;
     cout << " -2\tDETAIL 2 - Output contains: same as DETAIL 1 + protocol; source IP; action." << endl;
@@ -126,12 +155,17 @@ int main(int argc, char* argv[])
 {
     auto_ptr< InputParser > m_inputParser;
     auto_ptr< OutputWriter > m_outputWriter;
-    ifstream f_inputFile;
+    auto_ptr< InputBuffer > m_inputBuffer;
     ofstream f_outputFile;
 
     bool m_verboseMode = false;
     int m_outputDetail = OUTPUT_DETAIL_2;
     int m_inputFormat = INPUT_FORMAT_CISCO;
+    unsigned m_numOfThreads = 1;
+    int m_insertionMode = INSERTION_SEQUENTIAL;
+    int m_bitVectorType = BITVECTOR_AUTO;
+    int m_indexType = INDEX_BINARY_TRIE;
+    int m_outputType = OUTPUT_TYPE_XML;
     char* m_inputFileName = NULL;
     char* m_outputFileName = NULL;
 
@@ -149,7 +183,7 @@ int main(int argc, char* argv[])
 
     int c;
     /***** GETOPT *****/
-    while ( (c = getopt(argc, argv, "i:o:f:1234hv")) != -1 )
+    while ( (c = getopt(argc, argv, "i:o:t:f:j:plb:d:1234hv")) != -1 )
     {
         switch ( c )
         {
@@ -163,6 +197,20 @@ int main(int argc, char* argv[])
                 m_outputFileName = optarg;
                 break;
 
+            /* output type */
+            case 't':
+                if ( strcmp(optarg, "xml") == 0 )
+                    m_outputType = OUTPUT_TYPE_XML;
+                else if ( strcmp(optarg, "binary") == 0 )
+                    m_outputType = OUTPUT_TYPE_BINARY;
+                else
+                {
+                    cerr << argv[0] << " ERROR: Unknown output type \"" << optarg << "\"!" << endl;
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+
             /* input format */
             case 'f':
                 if ( strcmp(optarg, "juniper") == 0 )
@@ -174,6 +222,72 @@ int main(int argc, char* argv[])
                 else if ( strcmp(optarg, "bench") == 0 )
                     m_inputFormat = INPUT_FORMAT_CLASSBENCH;
                 break;
+
+            /* number of analysing threads */
+            case 'j':
+            {
+                char* end = NULL;
+                errno = 0;
+                long numOfThreads = strtol(optarg, &end, 10);
+
+                /* whole argument has to be a positive number */
+                if ( end == optarg || *end != '\0' || errno == ERANGE || numOfThreads < 1 || (unsigned long) numOfThreads > UINT_MAX )
+                {
+                    cerr << argv[0] << " ERROR: Invalid number of threads \"" << optarg << "\"!" << endl;
+                    usage(argv[0]);
+                    return 1;
+                }
+                m_numOfThreads = (unsigned) numOfThreads;
+                break;
+            }
+
+            /* pipelined insertion into prefix trees */
+            case 'p':
+                m_insertionMode = INSERTION_PIPELINED;
+                break;
+
+            /* bulk load of prefix trees */
+            case 'l':
+                m_insertionMode = INSERTION_BULK;
+                break;
+
+            /* class of bit vectors */
+            case 'b':
+                if ( strcmp(optarg, "auto") == 0 )
+                    m_bitVectorType = BITVECTOR_AUTO;
+                else if ( strcmp(optarg, "wah") == 0 )
+                    m_bitVectorType = BITVECTOR_WAH;
+                else if ( strcmp(optarg, "plain") == 0 )
+                    m_bitVectorType = BITVECTOR_PLAIN;
+                else if ( strcmp(optarg, "roaring") == 0 )
+                    m_bitVectorType = BITVECTOR_ROARING;
+                else
+                {
+                    cerr << argv[0] << " ERROR: Unknown class of bit vectors \"" << optarg << "\"!" << endl;
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+
+            /* structure used for dimensions */
+            case 'd':
+                if ( strcmp(optarg, "binary") == 0 )
+                    m_indexType = INDEX_BINARY_TRIE;
+                else if ( strcmp(optarg, "patricia") == 0 )
+                    m_indexType = INDEX_PATRICIA_TRIE;
+                else if ( strcmp(optarg, "multibit") == 0 )
+                    m_indexType = INDEX_MULTIBIT_TRIE;
+                else if ( strcmp(optarg, "multibit16") == 0 )
+                    m_indexType = INDEX_MULTIBIT_WIDE_TRIE;
+                else if ( strcmp(optarg, "tables") == 0 )
+                    m_indexType = INDEX_DIRECT_TABLES;
+                else
+                {
+                    cerr << argv[0] << " ERROR: Unknown structure for dimensions \"" << optarg << "\"!" << endl;
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
                 
             /* output detail */
             case '1':
@@ -208,8 +322,10 @@ int main(int argc, char* argv[])
     cout << "Input File = \"" << m_inputFileName << "\"" << endl;
     cout << "Input File Format = \"" << confTypeToString(m_inputFormat) << "\"" << endl;
     
+    const char* m_defaultOutputFile = (m_outputType == OUTPUT_TYPE_BINARY) ? DEFAULT_BINARY_OUTPUT_FILE : DEFAULT_OUTPUT_FILE;
+
     if ( m_outputFileName == NULL )
-        cout << "Output File = \"" << DEFAULT_OUTPUT_FILE << "\"" << endl;
+        cout << "Output File = \"" << m_defaultOutputFile << "\"" << endl;
     else
         cout << "Output File = \"" << m_outputFileName << "\"" << endl;
 
@@ -225,11 +341,14 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    f_inputFile.open(m_inputFileName, ios_base::in);
-
-    if ( !f_inputFile.is_open() )
+    /* input file is mapped into the memory, so in-situ parsers do not copy it */
+    try {
+        m_inputBuffer = InputBuffer::fromFile(m_inputFileName);
+    }
+    catch ( Exception& e )
     {
         cerr << argv[0] << " ERROR: Can't open input file \"" << m_inputFileName << "\"!" << endl;
+        cerr << argv[0] << e.toString();
         return 1;
     }
 
@@ -258,24 +377,23 @@ int main(int argc, char* argv[])
     }
 
     try {
-        m_parsedAcls = m_inputParser->parse(f_inputFile);
+        m_parsedAcls = m_inputParser->parse(*m_inputBuffer);
     }
     catch ( Exception e )
     {
         cerr << argv[0] << " ERROR: Parsing of input file failed!" << endl;
         cerr << argv[0] << e.toString();
 
-        f_inputFile.close();
         return 1;
     }
-    f_inputFile.close();
+    m_inputBuffer.reset();      /* parsed ACLs do not refer to the input */
 
     cout << "Number of parsed ACLs = " << m_parsedAcls->size() << endl;
     //-----------------------------------------------------------------------------------
 
     /****** OUTPUT ******/
     if ( m_outputFileName == NULL )
-        f_outputFile.open(DEFAULT_OUTPUT_FILE, std::_S_trunc);
+        f_outputFile.open(m_defaultOutputFile, std::_S_trunc);
     else
         f_outputFile.open(m_outputFileName, std::_S_trunc);
 
@@ -285,7 +403,10 @@ int main(int argc, char* argv[])
         return 1;
     }
     
-    m_outputWriter = auto_ptr< OutputWriter >(new XmlOutputWriter(f_outputFile, m_outputDetail));
+    if ( m_outputType == OUTPUT_TYPE_BINARY )
+        m_outputWriter = auto_ptr< OutputWriter >(new BinaryOutputWriter(f_outputFile));
+    else
+        m_outputWriter = auto_ptr< OutputWriter >(new XmlStreamOutputWriter(f_outputFile, m_outputDetail));
 
     #ifdef TEST
     struct timeval start;
@@ -293,63 +414,66 @@ int main(int argc, char* argv[])
     #endif
     
     /****** PROCESSING ******/
-    size_t size = m_parsedAcls->size();
-    for ( size_t i = 0; i < size; ++i )
+    if ( m_numOfThreads > 1 )
     {
-        AccessControlList* actualACL = &(*m_parsedAcls)[i];
+        AnalysisScheduler scheduler(*m_parsedAcls, m_numOfThreads, m_insertionMode, m_bitVectorType, m_indexType);
 
-        if ( m_verboseMode )
+        try {
+            scheduler.run(*m_outputWriter, m_verboseMode);
+        }
+        catch ( Exception& e )
         {
-            cout << endl << *actualACL << endl;
+            cerr << argv[0] << " ERROR: Analysis of ACLs failed!" << endl;
+            cerr << argv[0] << e.toString();
+
+            m_outputWriter->flush();
+            f_outputFile.close();
+            return 1;
         }
-        
-        int numOfrules = actualACL->size();
-        auto_ptr< PrefixForest > aclPrefixForest(new PrefixForest(numOfrules));
-
-        m_outputWriter->writeNewACL(actualACL->name());
-
-        #ifdef TEST
-        cout << "" << numOfrules << endl;
-        unsigned long numOfAnalyzations = 0;
-        unsigned long numOfConflicts = 0;
-        #endif
-        
-        for ( int j = 0; j < numOfrules; ++j )
+    }
+    else
+    {
+        size_t size = m_parsedAcls->size();
+        for ( size_t i = 0; i < size; ++i )
         {
-            AclRule* actualRule = &(*actualACL)[j];
-            auto_ptr< WAHBitVector > actualConfVector(aclPrefixForest->addAclRule(*actualRule));
-            
-            WAHBitVector::OnesIterator it = actualConfVector->getOnesIterator(actualRule->getPosition());
+            AccessControlList* actualACL = &(*m_parsedAcls)[i];
 
-            int32_t pos = -1;
-            while ( (pos = it.next()) != -1 )
+            if ( m_verboseMode )
             {
-                #ifdef TEST
-                ++numOfAnalyzations;
-                #endif
+                cout << endl << *actualACL << endl;
+            }
 
-                auto_ptr< Conflict > conf = Conflict::classifyConflict((*actualACL)[pos], *actualRule);
+            m_outputWriter->writeNewACL(actualACL->name());
 
-                if (conf.get()->isConflict())
-                {
-                    #ifdef TEST
-                    ++numOfConflicts;
-                    #endif
-                    
-                     m_outputWriter->writeNewConflict(*conf);
-                }
+            AclAnalyzer analyzer(*actualACL, m_outputWriter.get(), m_insertionMode, m_bitVectorType, CLASSIFY_SHORT_CIRCUIT, m_indexType);
+
+            #ifdef TEST
+            cout << "" << actualACL->size() << endl;
+            #endif
+
+            try {
+                analyzer.analyse();
             }
-        }
+            catch ( Exception& e )
+            {
+                cerr << argv[0] << " ERROR: Analysis of ACL \"" << actualACL->name() << "\" failed!" << endl;
+                cerr << argv[0] << e.toString();
+
+                m_outputWriter->flush();
+                f_outputFile.close();
+                return 1;
+            }
+
+            #ifdef TEST
+            struct timeval stop;
+            gettimeofday(&stop, NULL);
 
-        #ifdef TEST
-        struct timeval stop;
-        gettimeofday(&stop, NULL);
-        
-        cout << "" << numOfAnalyzations << endl;
-        cout << "" << numOfConflicts << endl;
-        cout.setf(ios_base::fixed, ios_base::floatfield);
-        cout << "" << (double(stop.tv_sec - start.tv_sec)) + (double(stop.tv_usec - start.tv_usec) / 1000000) << endl;
-        #endif
+            cout << "" << analyzer.getNumOfAnalyzations() << endl;
+            cout << "" << analyzer.getNumOfConflicts() << endl;
+            cout.setf(ios_base::fixed, ios_base::floatfield);
+            cout << "" << (double(stop.tv_sec - start.tv_sec)) + (double(stop.tv_usec - start.tv_usec) / 1000000) << endl;
+            #endif
+        }
     }
 
     m_outputWriter->flush();    /* flush results to output file */
@@ -38,7 +38,7 @@
 #include "Conflict.hpp"
 /****** OUTPUT MODULES ******/
 #include "OutputWriter.hpp"
-#include "XmlOutputWriter.hpp"
+#include "XmlStreamOutputWriter.hpp"
 
 using namespace std;
 
@@ -286,7 +286,7 @@ int main(int argc, char* argv[])
         return 1;
     }
     
-    m_outputWriter = auto_ptr< OutputWriter >(new XmlOutputWriter(f_outputFile, m_outputDetail));
+    m_outputWriter = auto_ptr< OutputWriter >(new XmlStreamOutputWriter(f_outputFile, m_outputDetail));
 
     #ifdef TEST
     struct timeval start;
@@ -315,23 +315,21 @@ int main(int argc, char* argv[])
         
         for ( int j = 0; j < numOfrules; ++j )
         {
-            AclRule* actualRule = &(*actualACL)[j];
-
             for ( int i = j + 1; i < numOfrules; ++i )
             {
                 #ifdef TEST
                 ++numOfAnalyzations;
                 #endif
                 
-                auto_ptr< Conflict > conf = Conflict::classifyConflict((*actualACL)[i], *actualRule);
+                CONFLICT_RESULT result = Conflict::classifyResult(*actualACL, i, j);
 
-                if (conf.get()->isConflict())
+                if ( result.conflictType != CONFLICT_NONE )
                 {
                     #ifdef TEST
                     ++numOfConflicts;
                     #endif
                 
-                    m_outputWriter->writeNewConflict(*conf);
+                    m_outputWriter->writeNewConflict(Conflict((*actualACL)[i], (*actualACL)[j], result));
                 }
             }
         }